@@ -0,0 +1,39 @@
+#include "dmdatetime.h"
+#include <chrono>
+#include <cstdio>
+
+// 各时钟源单次读取的开销（ns/call），以及与 CLOCK_REALTIME 的偏差
+
+static const int kIterations = 5000000;
+
+int main() {
+    std::printf("%-18s %10s %14s\n", "clock source", "ns/call", "skew vs rt(ns)");
+    volatile int64_t sink = 0;
+    for (int i = 0; i < CDMClock::CLOCK_SOURCE_COUNT; ++i) {
+        const CDMClock::ClockSource source = static_cast<CDMClock::ClockSource>(i);
+        CDMClock::NowNanoseconds(source); // 预热（TSC 首次使用时校准）
+        auto start = std::chrono::steady_clock::now();
+        int64_t sum = 0;
+        for (int n = 0; n < kIterations; ++n) {
+            sum += CDMClock::NowNanoseconds(source);
+        }
+        auto end = std::chrono::steady_clock::now();
+        sink = sink + sum;
+        const double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count())
+            / kIterations;
+        const int64_t skew = CDMClock::NowNanoseconds(source) - CDMClock::NowNanoseconds(CDMClock::CLOCK_SOURCE_REALTIME);
+        std::printf("%-18s %10.2f %14lld\n", CDMClock::GetSourceName(source), ns, static_cast<long long>(skew));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    long long sum = 0;
+    for (int n = 0; n < kIterations; ++n) {
+        sum += CDMDateTime::Now(CDMClock::CLOCK_SOURCE_REALTIME_COARSE).GetTimestamp();
+    }
+    auto end = std::chrono::steady_clock::now();
+    sink = sink + sum;
+    std::printf("%-18s %10.2f\n", "Now(coarse)", static_cast<double>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()) / kIterations);
+    std::printf("tsc reliable: %s\n", CDMClock::IsTscReliable() ? "yes" : "no");
+    return 0;
+}
@@ -0,0 +1,927 @@
+#include "dmdatetime.h"
+#include "dmbusinesscalendar.h"
+#include "dmtimerwheel.h"
+#include "dmcron.h"
+#include "dmrrule.h"
+#include "dminterval.h"
+#include "dmhistogram.h"
+#include "dmtimestampcolumn.h"
+#include "dmtimeseriesfile.h"
+#include "dmlogscanner.h"
+#include "dmdatetimeformat.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+// dmdatetime 微基准套件：每个用例先单线程、再 N 线程（N > 1 时）各跑一遍，结果以 JSON 输出，
+// 便于升级库版本时对比回归。人类可读的表格同时打印到 stderr。
+//
+//   dmdatetimebench [--threads N] [--iterations N] [--filter substr] [--output file.json] [--scaling]
+//
+// N 线程模式下每个线程各执行 iterations 次，ns_per_op 为各线程的平均单次耗时，
+// ops_per_sec 为所有线程合计的吞吐。
+//
+// --scaling 改为多线程扩展性测试：getter、GetStartOfDay 与按分量构造分别在 1,2,4..N 个线程上运行，
+// 对比三种换算方式的吞吐——original（原实现：每次调用 localtime_r/mktime）、libc（默认路径，
+// 缓存未命中时进入 libc）与 lockfree（EnableLockFreeConversion，完全不进入 libc）。
+// scaling_efficiency = 吞吐(n) / (n * 吞吐(1))，接近 1 表示线性扩展。
+
+namespace {
+
+struct BenchOptions {
+    int threads = 0;
+    long long iterations = 1000000;
+    std::string filter;
+    std::string output;
+    bool scaling = false;
+};
+
+// 用例：执行 iterations 次操作并返回校验和，防止被编译器优化掉
+struct BenchCase {
+    std::string name;
+    std::function<long long(long long iterations, int thread_index)> run;
+    std::function<void()> prepare; // 计时前调用一次，构造按需生成的大块输入；可为空
+};
+
+struct BenchResult {
+    std::string name;
+    std::string mode;
+    int threads;
+    long long iterations;
+    double ns_per_op;
+    double ops_per_sec;
+    double scaling_efficiency;
+};
+
+const int kStringCount = 1024;
+const time_t kBase = 1735111845; // 2024-12-25 07:30:45 UTC
+const time_t kStride = 3607;     // 每次前进约一小时，覆盖不同的日、月
+
+// 自定义格式：运行时路径（snprintf/sscanf）与编译期特化的 CDMFixedFormat 对比
+constexpr char kSlashFormat[] = "%Y/%m/%d %H:%M:%S";
+const char* const kSlashPrintf = "%04d/%02d/%02d %02d:%02d:%02d";
+const char* const kSlashScanf = "%d/%d/%d %d:%d:%d";
+
+std::vector<std::string> g_strings;
+std::vector<std::string> g_slash_strings;
+std::vector<time_t> g_timestamps;
+volatile long long g_sink = 0;
+
+std::tm LibcLocal(time_t t) {
+    std::tm local_tm{};
+#ifdef _WIN32
+    localtime_s(&local_tm, &t);
+#else
+    localtime_r(&t, &local_tm);
+#endif
+    return local_tm;
+}
+
+// 基准期间使用的临时文件：文件名带进程号，并发运行互不覆盖；析构时（进程退出）删除
+struct TempFile {
+    std::string path;
+
+    explicit TempFile(const char* name) {
+#ifdef _WIN32
+        const long long pid = _getpid();
+#else
+        const long long pid = getpid();
+#endif
+        path = (std::filesystem::temp_directory_path() / (std::string(name) + "." + std::to_string(pid) + ".dmts")).string();
+    }
+
+    ~TempFile() {
+        std::remove(path.c_str());
+    }
+};
+
+inline time_t StampAt(long long i, int thread_index) {
+    return kBase + static_cast<time_t>((i + thread_index * 7919LL) % 100000) * kStride;
+}
+
+// 100 万个间隔 15 秒的时间戳组成的列；jitter > 0 时每个时间戳再随机推后 [0, jitter) 秒
+CDMTimestampColumn MakeColumn(int jitter) {
+    CDMTimestampColumn column;
+    uint64_t seed = 42;
+    for (long long i = 0; i < 1000000; ++i) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        column.Append(kBase + static_cast<time_t>(i * 15 + (jitter > 0 ? static_cast<long long>((seed >> 33) % jitter) : 0)));
+    }
+    return column;
+}
+
+void Prepare() {
+    for (int i = 0; i < kStringCount; ++i) {
+        g_strings.push_back(CDMDateTime::FromTimestamp(StampAt(i, 0)).ToString());
+        g_slash_strings.push_back(CDMDateTime::FromTimestamp(StampAt(i, 0)).ToString(kSlashPrintf));
+        g_timestamps.push_back(StampAt(i, 0));
+    }
+}
+
+// 对每个新对象调用一次 getter（字段缓存未命中）
+template<typename Getter>
+BenchCase GetterCase(const char* name, Getter getter) {
+    return BenchCase{ name, [getter](long long n, int thread_index) {
+        long long sum = 0;
+        for (long long i = 0; i < n; ++i) {
+            sum += getter(CDMDateTime::FromTimestamp(StampAt(i, thread_index)));
+        }
+        return sum;
+    } };
+}
+
+template<typename Func>
+BenchCase NowCase(const char* name, Func func) {
+    return BenchCase{ name, [func](long long n, int) {
+        long long sum = 0;
+        for (long long i = 0; i < n; ++i) {
+            sum += static_cast<long long>(func());
+        }
+        return sum;
+    } };
+}
+
+std::vector<BenchCase> BuildCases() {
+    std::vector<BenchCase> cases;
+
+    cases.push_back(BenchCase{ "libc.localtime_r", [](long long n, int thread_index) {
+        long long sum = 0;
+        for (long long i = 0; i < n; ++i) {
+            sum += LibcLocal(StampAt(i, thread_index)).tm_hour;
+        }
+        return sum;
+    } });
+
+    cases.push_back(BenchCase{ "Parse", [](long long n, int thread_index) {
+        long long sum = 0;
+        for (long long i = 0; i < n; ++i) {
+            sum += static_cast<long long>(CDMDateTime::Parse(g_strings[(i + thread_index) % kStringCount]).GetTimestamp());
+        }
+        return sum;
+    } });
+
+    cases.push_back(BenchCase{ "TryParse", [](long long n, int thread_index) {
+        long long sum = 0;
+        CDMDateTime dt;
+        for (long long i = 0; i < n; ++i) {
+            const std::string& s = g_strings[(i + thread_index) % kStringCount];
+            sum += CDMDateTime::TryParse(std::string_view(s), dt) ? static_cast<long long>(dt.GetTimestamp()) : 0;
+        }
+        return sum;
+    } });
+
+    cases.push_back(BenchCase{ "ToString", [](long long n, int thread_index) {
+        long long sum = 0;
+        for (long long i = 0; i < n; ++i) {
+            sum += static_cast<long long>(CDMDateTime::FromTimestamp(StampAt(i, thread_index)).ToString().size());
+        }
+        return sum;
+    } });
+
+    cases.push_back(BenchCase{ "ToString.buffer", [](long long n, int thread_index) {
+        long long sum = 0;
+        char buffer[64];
+        for (long long i = 0; i < n; ++i) {
+            sum += static_cast<long long>(CDMDateTime::FromTimestamp(StampAt(i, thread_index)).ToString(buffer, sizeof(buffer)));
+        }
+        return sum + buffer[18];
+    } });
+
+    cases.push_back(BenchCase{ "ToISOString", [](long long n, int thread_index) {
+        long long sum = 0;
+        for (long long i = 0; i < n; ++i) {
+            sum += static_cast<long long>(CDMDateTime::FromTimestamp(StampAt(i, thread_index)).ToISOString().size());
+        }
+        return sum;
+    } });
+
+    cases.push_back(BenchCase{ "ToUTCString", [](long long n, int thread_index) {
+        long long sum = 0;
+        for (long long i = 0; i < n; ++i) {
+            sum += static_cast<long long>(CDMDateTime::FromTimestamp(StampAt(i, thread_index)).ToUTCString().size());
+        }
+        return sum;
+    } });
+
+    cases.push_back(GetterCase("GetYear", [](const CDMDateTime& dt) { return dt.GetYear(); }));
+    cases.push_back(GetterCase("GetMonth", [](const CDMDateTime& dt) { return dt.GetMonth(); }));
+    cases.push_back(GetterCase("GetDay", [](const CDMDateTime& dt) { return dt.GetDay(); }));
+    cases.push_back(GetterCase("GetHour", [](const CDMDateTime& dt) { return dt.GetHour(); }));
+    cases.push_back(GetterCase("GetMinute", [](const CDMDateTime& dt) { return dt.GetMinute(); }));
+    cases.push_back(GetterCase("GetSecond", [](const CDMDateTime& dt) { return dt.GetSecond(); }));
+    cases.push_back(GetterCase("GetDayOfWeek", [](const CDMDateTime& dt) { return dt.GetDayOfWeek(); }));
+    cases.push_back(GetterCase("GetDayOfYear", [](const CDMDateTime& dt) { return dt.GetDayOfYear(); }));
+
+    // 同一对象连续读取六个分量，按单个 getter 计
+    cases.push_back(BenchCase{ "Getters.cached", [](long long n, int thread_index) {
+        long long sum = 0;
+        for (long long i = 0; i < n; i += 6) {
+            CDMDateTime dt = CDMDateTime::FromTimestamp(StampAt(i, thread_index));
+            sum += dt.GetYear() + dt.GetMonth() + dt.GetDay() + dt.GetHour() + dt.GetMinute() + dt.GetSecond();
+        }
+        return sum;
+    } });
+
+    cases.push_back(BenchCase{ "AddMonths", [](long long n, int thread_index) {
+        long long sum = 0;
+        for (long long i = 0; i < n; ++i) {
+            sum += static_cast<long long>(CDMDateTime::FromTimestamp(StampAt(i, thread_index))
+                .AddMonths(static_cast<int>(i % 25) - 12).GetTimestamp());
+        }
+        return sum;
+    } });
+
+    cases.push_back(GetterCase("GetStartOfDay", [](const CDMDateTime& dt) { return static_cast<long long>(dt.GetStartOfDay().GetTimestamp()); }));
+    cases.push_back(GetterCase("GetEndOfMonth", [](const CDMDateTime& dt) { return static_cast<long long>(dt.GetEndOfMonth().GetTimestamp()); }));
+    cases.push_back(GetterCase("NextWeekdayAt", [](const CDMDateTime& dt) { return static_cast<long long>(dt.NextWeekdayAt(1, 9, 30, 0).GetTimestamp()); }));
+
+    cases.push_back(NowCase("Now", []() { return CDMDateTime::Now().GetTimestamp(); }));
+    cases.push_back(NowCase("Now.realtime", []() { return CDMDateTime::Now(CDMClock::CLOCK_SOURCE_REALTIME).GetTimestamp(); }));
+    cases.push_back(NowCase("Now.realtime_coarse", []() { return CDMDateTime::Now(CDMClock::CLOCK_SOURCE_REALTIME_COARSE).GetTimestamp(); }));
+    cases.push_back(NowCase("Now.tsc", []() { return CDMDateTime::Now(CDMClock::CLOCK_SOURCE_TSC).GetTimestamp(); }));
+
+    // 列式批量拆分，按行计
+    cases.push_back(BenchCase{ "ExtractFields.row", [](long long n, int) {
+        const size_t rows = static_cast<size_t>(kStringCount);
+        std::vector<int16_t> years(rows);
+        std::vector<uint8_t> months(rows), days(rows), hours(rows);
+        DMDateTimeColumns out;
+        out.year = years.data();
+        out.month = months.data();
+        out.day = days.data();
+        out.hour = hours.data();
+        long long sum = 0;
+        for (long long done = 0; done < n; done += static_cast<long long>(rows)) {
+            CDMDateTime::ExtractFields(g_timestamps.data(), rows, out);
+            sum += years[done % rows] + hours[(done / 3) % rows];
+        }
+        return sum;
+    } });
+
+    // 统计一年内的工作日：逐日 AddDays(1) + IsWeekday 与工作日历的前缀和 popcount
+    cases.push_back(BenchCase{ "Workdays.year.loop", [](long long n, int thread_index) {
+        long long sum = 0;
+        for (long long i = 0; i < n; i += 365) {
+            const CDMDateTime start = CDMDateTime::FromTimestamp(StampAt(i, thread_index)).GetStartOfDay();
+            const CDMDateTime end = start.AddYears(1);
+            for (CDMDateTime date = start; date < end; date = date.AddDays(1)) {
+                sum += date.IsWeekday() ? 1 : 0;
+            }
+        }
+        return sum;
+    } });
+    cases.push_back(BenchCase{ "BusinessCalendar.CountYear", [](long long n, int thread_index) {
+        static const CDMBusinessCalendar calendar(2000, 2100);
+        long long sum = 0;
+        const long long base = CDMCivil::DaysFromCivil(2024, 1, 1);
+        for (long long i = 0; i < n; ++i) {
+            const long long first = base + (i * 7 + thread_index) % 20000;
+            sum += calendar.CountBusinessDays(first, first + 365);
+        }
+        return sum;
+    } });
+    cases.push_back(BenchCase{ "BusinessCalendar.AddBusinessDays", [](long long n, int thread_index) {
+        static const CDMBusinessCalendar calendar(2000, 2100);
+        long long sum = 0;
+        const long long base = CDMCivil::DaysFromCivil(2024, 1, 1);
+        for (long long i = 0; i < n; ++i) {
+            sum += calendar.AddBusinessDays(base + (i * 7 + thread_index) % 20000, i % 250 - 120);
+        }
+        return sum;
+    } });
+
+    // 定时器：保持约 64K 个在途定时器，每次操作添加一个并推进一秒使到期的批量触发；
+    // 对照组为 std::priority_queue 的 push / pop
+    cases.push_back(BenchCase{ "TimerWheel.AddExpire", [](long long n, int thread_index) {
+        CDMTimerWheel wheel(CDMDateTime::FromTimestamp(kBase));
+        long long sum = 0;
+        const CDMTimerWheel::Callback callback = [&sum](CDMTimerWheel::TimerId, const CDMDateTime& when) {
+            sum += static_cast<long long>(when.GetTimestamp());
+        };
+        const time_t base = kBase;
+        for (long long i = 0; i < n; ++i) {
+            wheel.AddTimer(CDMTimeSpan(1 + (i * 7919 + thread_index) % 65536), callback);
+            if ((i & 63) == 63) {
+                wheel.Advance(CDMDateTime::FromTimestamp(base + static_cast<time_t>(i >> 6)));
+            }
+        }
+        return sum;
+    } });
+    cases.push_back(BenchCase{ "TimerWheel.AddCancel", [](long long n, int thread_index) {
+        CDMTimerWheel wheel(CDMDateTime::FromTimestamp(kBase));
+        const CDMTimerWheel::Callback callback = [](CDMTimerWheel::TimerId, const CDMDateTime&) {};
+        std::vector<CDMTimerWheel::TimerId> ids(65536, CDMTimerWheel::INVALID_TIMER);
+        long long sum = 0;
+        for (long long i = 0; i < n; ++i) {
+            CDMTimerWheel::TimerId& id = ids[static_cast<size_t>(i & 65535)];
+            sum += wheel.Cancel(id) ? 1 : 0;
+            id = wheel.AddTimer(CDMTimeSpan(1 + (i * 7919 + thread_index) % 1000000), callback);
+        }
+        return sum;
+    } });
+    cases.push_back(BenchCase{ "PriorityQueue.PushPop", [](long long n, int thread_index) {
+        typedef std::pair<long long, std::function<void()> > Entry;
+        auto later = [](const Entry& a, const Entry& b) { return a.first > b.first; };
+        std::priority_queue<Entry, std::vector<Entry>, decltype(later)> queue(later);
+        long long sum = 0;
+        const long long base = static_cast<long long>(kBase);
+        for (long long i = 0; i < n; ++i) {
+            queue.push(Entry(base + 1 + (i * 7919 + thread_index) % 65536, [&sum]() { ++sum; }));
+            if ((i & 63) == 63) {
+                const long long now = base + (i >> 6);
+                while (!queue.empty() && queue.top().first <= now) {
+                    sum += queue.top().first;
+                    queue.pop();
+                }
+            }
+        }
+        return sum;
+    } });
+
+    // cron 下一次触发：密集、工作日与稀疏（闰年 2 月 29 日，最长跨 8 年）三种表达式
+    const char* cron_cases[][2] = {
+        { "Cron.NextFireTime.dense", "*/5 * * * *" },
+        { "Cron.NextFireTime.weekdays", "0 30 9 * * MON-FRI" },
+        { "Cron.NextFireTime.sparse", "0 0 29 2 *" },
+    };
+    for (const auto& item : cron_cases) {
+        const CDMCronExpression cron = CDMCronExpression::Parse(item[1]);
+        cases.push_back(BenchCase{ item[0], [cron](long long n, int thread_index) {
+            long long sum = 0;
+            for (long long i = 0; i < n; ++i) {
+                sum += static_cast<long long>(cron.NextFireTime(CDMDateTime::FromTimestamp(StampAt(i, thread_index))).GetTimestamp());
+            }
+            return sum;
+        } });
+    }
+
+    // RRULE 定位：起点为 2000 年，查询时刻在二十多年之后，按周期直接跳转
+    const char* rrule_cases[][2] = {
+        { "RRule.NextOccurrence.weekly", "FREQ=WEEKLY;BYDAY=MO,WE,FR" },
+        { "RRule.NextOccurrence.monthly", "FREQ=MONTHLY;BYDAY=MO,TU,WE,TH,FR;BYSETPOS=-1" },
+        { "RRule.NextOccurrence.yearly", "FREQ=YEARLY;BYMONTH=11;BYDAY=4TH" },
+    };
+    for (const auto& item : rrule_cases) {
+        const CDMRecurrenceRule rule = CDMRecurrenceRule::Parse(item[1], CDMDateTime(2000, 1, 3, 9, 0, 0));
+        cases.push_back(BenchCase{ item[0], [rule](long long n, int thread_index) {
+            long long sum = 0;
+            CDMDateTime next;
+            for (long long i = 0; i < n; ++i) {
+                if (rule.GetNextOccurrence(CDMDateTime::FromTimestamp(StampAt(i, thread_index)), next)) {
+                    sum += static_cast<long long>(next.GetTimestamp());
+                }
+            }
+            return sum;
+        } });
+    }
+
+    // 20 万个活动窗口（1 小时到 2 天），覆盖 StampAt 的约 11 年范围
+    auto promotion_index = []() -> const CDMIntervalIndex& {
+        static const CDMIntervalIndex index = []() {
+            CDMIntervalIndex built;
+            const long long span = 100000LL * kStride;
+            built.Reserve(200000);
+            for (uint32_t i = 0; i < 200000; ++i) {
+                const long long begin = static_cast<long long>((i * 2654435761ULL) % static_cast<unsigned long long>(span));
+                const long long length = 3600 + static_cast<long long>((i * 40503ULL) % (2 * 86400));
+                built.Add(kBase + static_cast<time_t>(begin), kBase + static_cast<time_t>(begin + length), i);
+            }
+            built.Build();
+            return built;
+        }();
+        return index;
+    };
+    cases.push_back(BenchCase{ "IntervalIndex.Stab", [promotion_index](long long n, int thread_index) {
+        const CDMIntervalIndex& index = promotion_index();
+        long long sum = 0;
+        for (long long i = 0; i < n; ++i) {
+            sum += static_cast<long long>(index.CountContaining(CDMDateTime::FromTimestamp(StampAt(i, thread_index))));
+        }
+        return sum;
+    } });
+    cases.push_back(BenchCase{ "IntervalIndex.Overlap1h", [promotion_index](long long n, int thread_index) {
+        const CDMIntervalIndex& index = promotion_index();
+        long long sum = 0;
+        for (long long i = 0; i < n; ++i) {
+            const time_t begin = StampAt(i, thread_index);
+            index.VisitOverlaps(begin, begin + 3600, [&sum](uint32_t value, time_t, time_t) {
+                sum += value;
+            });
+        }
+        return sum;
+    } });
+
+    // 分桶聚合：每次操作为一个元素，按 4096 个一批送入；naive 为逐个 GetStartOfMonth 后查表
+    static const std::vector<time_t> bucket_stamps = []() {
+        std::vector<time_t> stamps;
+        for (long long i = 0; i < 100000; ++i) {
+            stamps.push_back(StampAt(i, 0));
+        }
+        return stamps;
+    }();
+    static const std::vector<double> bucket_values(bucket_stamps.size(), 1.5);
+    auto run_histogram = [](CDMTimeHistogram histogram, long long n) {
+        long long done = 0;
+        long long sum = 0;
+        while (done < n) {
+            const size_t offset = static_cast<size_t>(done % static_cast<long long>(bucket_stamps.size()));
+            const size_t count = std::min<size_t>(std::min<long long>(4096, n - done), bucket_stamps.size() - offset);
+            sum += static_cast<long long>(histogram.Accumulate(bucket_stamps.data() + offset, bucket_values.data() + offset, count));
+            done += static_cast<long long>(count);
+        }
+        return sum + static_cast<long long>(histogram.GetCount(0));
+    };
+    const CDMDateTime bucket_from = CDMDateTime::FromTimestamp(kBase);
+    const CDMDateTime bucket_to = CDMDateTime::FromTimestamp(kBase + 100000LL * kStride);
+    cases.push_back(BenchCase{ "Histogram.Fixed.hour", [=](long long n, int) {
+        return run_histogram(CDMTimeHistogram::Fixed(bucket_from, CDMTimeSpan(3600), 100000 * kStride / 3600 + 1), n);
+    } });
+    cases.push_back(BenchCase{ "Histogram.Calendar.day", [=](long long n, int) {
+        return run_histogram(CDMTimeHistogram::Calendar(bucket_from, bucket_to, CDMTimeHistogram::UNIT_DAY), n);
+    } });
+    cases.push_back(BenchCase{ "Histogram.Calendar.month", [=](long long n, int) {
+        return run_histogram(CDMTimeHistogram::Calendar(bucket_from, bucket_to, CDMTimeHistogram::UNIT_MONTH), n);
+    } });
+    cases.push_back(BenchCase{ "Histogram.month.naive", [=](long long n, int) {
+        const int first_month = bucket_from.GetYear() * 12 + bucket_from.GetMonth() - 1;
+        std::vector<long long> counts(12 * 12, 0);
+        for (long long i = 0; i < n; ++i) {
+            const CDMDateTime start = CDMDateTime::FromTimestamp(bucket_stamps[static_cast<size_t>(i % 100000)]).GetStartOfMonth();
+            ++counts[static_cast<size_t>(start.GetYear() * 12 + start.GetMonth() - 1 - first_month)];
+        }
+        return counts[0] + counts[1];
+    } });
+
+    // delta-of-delta 列解码：每次操作为一个时间戳，按块循环解码 100 万个时间戳的列（选中该用例时才构造）
+    const std::pair<const char*, const CDMTimestampColumn& (*)()> column_cases[] = {
+        { "TimestampColumn.Decode.regular", []() -> const CDMTimestampColumn& {
+            static const CDMTimestampColumn column = MakeColumn(0);
+            return column;
+        } },
+        { "TimestampColumn.Decode.jittered", []() -> const CDMTimestampColumn& {
+            static const CDMTimestampColumn column = MakeColumn(3);
+            return column;
+        } },
+    };
+    for (const auto& item : column_cases) {
+        const auto get_column = item.second;
+        cases.push_back(BenchCase{ item.first, [get_column](long long n, int) {
+            const CDMTimestampColumn* column = &get_column();
+            std::vector<time_t> out(column->GetBlockSize());
+            long long sum = 0;
+            size_t block = 0;
+            for (long long done = 0; done < n;) {
+                const size_t count = column->DecodeBlock(block, out.data());
+                sum += static_cast<long long>(out[count - 1]);
+                done += static_cast<long long>(count);
+                block = block + 1 == column->GetBlockCount() ? 0 : block + 1;
+            }
+            return sum;
+        }, get_column });
+    }
+
+    // 一年、约每 2 秒一个时间戳（约 1600 万个）的文件，每次查询随机一小时
+    auto series_reader = []() -> const CDMTimeSeriesReader& {
+        // file 先于 reader 构造，因而在 reader 解除映射之后才析构删除
+        static const TempFile file("dmdatetimebench_series");
+        static const CDMTimeSeriesReader reader = []() {
+            {
+                CDMTimeSeriesWriter writer(file.path);
+                uint64_t seed = 7;
+                for (long long i = 0; i < 366LL * 86400 / 2; ++i) {
+                    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+                    writer.Append(kBase + static_cast<time_t>(i * 2 + static_cast<long long>((seed >> 33) & 1)));
+                }
+            }
+            return CDMTimeSeriesReader(file.path);
+        }();
+        return reader;
+    };
+    cases.push_back(BenchCase{ "TimeSeriesFile.QueryHour", [series_reader](long long n, int thread_index) {
+        const CDMTimeSeriesReader& reader = series_reader();
+        std::vector<time_t> out;
+        long long sum = 0;
+        for (long long i = 0; i < n; ++i) {
+            const time_t start = kBase + static_cast<time_t>(((i * 7919 + thread_index) % 8760) * 3600 + 1234);
+            out.clear();
+            sum += static_cast<long long>(reader.Query(CDMDateTime::FromTimestamp(start), CDMDateTime::FromTimestamp(start + 3600), out));
+        }
+        return sum;
+    }, series_reader });
+    cases.push_back(BenchCase{ "TimeSeriesFile.CountDay", [series_reader](long long n, int thread_index) {
+        const CDMTimeSeriesReader& reader = series_reader();
+        long long sum = 0;
+        for (long long i = 0; i < n; ++i) {
+            const time_t start = kBase + static_cast<time_t>(((i * 7919 + thread_index) % 8760) * 3600 + 1234);
+            sum += static_cast<long long>(reader.Count(CDMDateTime::FromTimestamp(start), CDMDateTime::FromTimestamp(start + 86400)));
+        }
+        return sum;
+    }, series_reader });
+
+    // 约 30 天、50 万行的内存日志，每 20 行夹一行无时间戳的续行（选中这些用例时才构造）
+    auto log_text = []() -> const std::string& {
+        static const std::string text = []() {
+            std::string built;
+            uint64_t seed = 11;
+            time_t t = kBase;
+            for (int i = 0; i < 500000; ++i) {
+                seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+                t += static_cast<time_t>((seed >> 33) % 10);
+                built += CDMDateTime::FromTimestamp(t).ToString() + ".123 INFO worker request id=" + std::to_string(i) + " done\n";
+                if (i % 20 == 0) {
+                    built += "    at com.example.Handler.run(Handler.java:42)\n";
+                }
+            }
+            return built;
+        }();
+        return text;
+    };
+    cases.push_back(BenchCase{ "LogScanner.ParseLine", [log_text](long long n, int thread_index) {
+        const std::string& text = log_text();
+        long long sum = 0;
+        size_t position = static_cast<size_t>(thread_index) * 4099 % text.size();
+        for (long long i = 0; i < n; ++i) {
+            position = text.find('\n', position);
+            position = position == std::string::npos || position + 1 == text.size() ? 0 : position + 1;
+            time_t ts = 0;
+            sum += CDMLogScanner::ParseLineTimestamp(text.data() + position, text.data() + text.size(), ts) ? static_cast<long long>(ts) : 1;
+        }
+        return sum;
+    }, log_text });
+    cases.push_back(BenchCase{ "LogScanner.FindSorted", [log_text](long long n, int thread_index) {
+        const CDMLogScanner log_scanner(log_text().data(), log_text().size());
+        long long sum = 0;
+        for (long long i = 0; i < n; ++i) {
+            const time_t start = kBase + static_cast<time_t>(((i * 7919 + thread_index) % 700) * 3600 + 1234);
+            size_t begin_offset = 0;
+            size_t end_offset = 0;
+            log_scanner.FindSorted(CDMDateTime::FromTimestamp(start), CDMDateTime::FromTimestamp(start + 3600), begin_offset, end_offset);
+            sum += static_cast<long long>(end_offset - begin_offset);
+        }
+        return sum;
+    }, log_text });
+    // 各行（含换行符）的结束偏移
+    auto log_line_ends = [log_text]() -> const std::vector<size_t>& {
+        static const std::vector<size_t> ends = [&]() {
+            const std::string& text = log_text();
+            std::vector<size_t> built;
+            for (size_t position = text.find('\n'); position != std::string::npos; position = text.find('\n', position + 1)) {
+                built.push_back(position + 1);
+            }
+            return built;
+        }();
+        return ends;
+    };
+    // 单线程全量扫描，ns/op 为每行耗时：按实际扫描的行数计，最后一遍只扫描日志开头剩余的行数
+    cases.push_back(BenchCase{ "LogScanner.ScanLine", [log_text, log_line_ends](long long n, int thread_index) {
+        const std::string& text = log_text();
+        const std::vector<size_t>& line_ends = log_line_ends();
+        long long sum = 0;
+        for (long long done = 0, pass = 0; done < n; ++pass) {
+            const size_t lines = static_cast<size_t>(std::min(n - done, static_cast<long long>(line_ends.size())));
+            const CDMLogScanner log_scanner(text.data(), line_ends[lines - 1]);
+            const time_t start = kBase + static_cast<time_t>(((pass + thread_index) % 700) * 3600);
+            sum += static_cast<long long>(log_scanner.ScanParallel(CDMDateTime::FromTimestamp(start), CDMDateTime::FromTimestamp(start + 86400), 1,
+                [&sum](const char*, size_t length) { sum += static_cast<long long>(length); }));
+            done += static_cast<long long>(lines);
+        }
+        return sum;
+    }, log_line_ends });
+
+    cases.push_back(BenchCase{ "ToString.format", [](long long n, int thread_index) {
+        long long sum = 0;
+        char buffer[64];
+        for (long long i = 0; i < n; ++i) {
+            sum += static_cast<long long>(CDMDateTime::FromTimestamp(StampAt(i, thread_index)).ToString(buffer, sizeof(buffer), kSlashPrintf));
+        }
+        return sum + buffer[18];
+    } });
+    cases.push_back(BenchCase{ "FixedFormat.Format", [](long long n, int thread_index) {
+        long long sum = 0;
+        char buffer[64];
+        for (long long i = 0; i < n; ++i) {
+            sum += static_cast<long long>(CDMFixedFormat<kSlashFormat>::Format(CDMDateTime::FromTimestamp(StampAt(i, thread_index)), buffer));
+        }
+        return sum + buffer[18];
+    } });
+    cases.push_back(BenchCase{ "Parse.format", [](long long n, int thread_index) {
+        long long sum = 0;
+        for (long long i = 0; i < n; ++i) {
+            sum += static_cast<long long>(CDMDateTime::Parse(g_slash_strings[(i + thread_index) % kStringCount], kSlashScanf).GetTimestamp());
+        }
+        return sum;
+    } });
+    cases.push_back(BenchCase{ "FixedFormat.Parse", [](long long n, int thread_index) {
+        long long sum = 0;
+        CDMDateTime dt = CDMDateTime::FromTimestamp(0);
+        for (long long i = 0; i < n; ++i) {
+            const std::string& s = g_slash_strings[(i + thread_index) % kStringCount];
+            sum += CDMFixedFormat<kSlashFormat>::TryParse(s.data(), s.size(), dt) ? static_cast<long long>(dt.GetTimestamp()) : 0;
+        }
+        return sum;
+    } });
+    static const CDMDateTimeFormat slash_format(kSlashFormat);
+    cases.push_back(BenchCase{ "DateTimeFormat.Format", [](long long n, int thread_index) {
+        long long sum = 0;
+        char buffer[64];
+        for (long long i = 0; i < n; ++i) {
+            sum += static_cast<long long>(slash_format.Format(CDMDateTime::FromTimestamp(StampAt(i, thread_index)), buffer));
+        }
+        return sum + buffer[18];
+    } });
+    cases.push_back(BenchCase{ "DateTimeFormat.Parse", [](long long n, int thread_index) {
+        long long sum = 0;
+        CDMDateTime dt = CDMDateTime::FromTimestamp(0);
+        for (long long i = 0; i < n; ++i) {
+            const std::string& s = g_slash_strings[(i + thread_index) % kStringCount];
+            sum += slash_format.TryParse(s.data(), s.size(), dt) ? static_cast<long long>(dt.GetTimestamp()) : 0;
+        }
+        return sum;
+    } });
+
+    return cases;
+}
+
+BenchResult RunCase(const BenchCase& bench, int threads, long long iterations) {
+    std::atomic<int> ready{ 0 };
+    std::atomic<bool> go{ false };
+    std::vector<double> thread_ns(threads, 0.0);
+    std::vector<long long> sums(threads, 0);
+    auto body = [&](int index) {
+        ready.fetch_add(1);
+        while (!go.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+        const auto start = std::chrono::steady_clock::now();
+        sums[index] = bench.run(iterations, index);
+        const auto end = std::chrono::steady_clock::now();
+        thread_ns[index] = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    };
+
+    std::vector<std::thread> workers;
+    for (int i = 1; i < threads; ++i) {
+        workers.emplace_back(body, i);
+    }
+    while (ready.load() < threads - 1) {
+        std::this_thread::yield();
+    }
+    const auto wall_start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    body(0);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    const auto wall_end = std::chrono::steady_clock::now();
+
+    double total_ns = 0.0;
+    for (int i = 0; i < threads; ++i) {
+        total_ns += thread_ns[i];
+        g_sink = g_sink + sums[i];
+    }
+    const double wall_ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(wall_end - wall_start).count());
+    BenchResult result;
+    result.name = bench.name;
+    result.threads = threads;
+    result.iterations = iterations;
+    result.ns_per_op = total_ns / threads / static_cast<double>(iterations);
+    result.ops_per_sec = wall_ns > 0.0 ? static_cast<double>(iterations) * threads * 1e9 / wall_ns : 0.0;
+    result.scaling_efficiency = 0.0;
+    return result;
+}
+
+// 原实现的换算方式：每次调用都进入 localtime_r / mktime
+time_t LibcMktime(std::tm t) {
+    t.tm_isdst = -1;
+    return std::mktime(&t);
+}
+
+// 扩展性测试的用例，按 mode 分组：同名用例在不同换算方式下对比
+struct ScalingCase {
+    std::string name;
+    std::string mode;
+    std::function<long long(long long iterations, int thread_index)> run;
+};
+
+std::vector<ScalingCase> BuildScalingCases() {
+    std::vector<ScalingCase> cases;
+    cases.push_back(ScalingCase{ "GetHour", "original", [](long long n, int thread_index) {
+        long long sum = 0;
+        for (long long i = 0; i < n; ++i) {
+            sum += LibcLocal(StampAt(i, thread_index)).tm_hour;
+        }
+        return sum;
+    } });
+    cases.push_back(ScalingCase{ "GetStartOfDay", "original", [](long long n, int thread_index) {
+        long long sum = 0;
+        for (long long i = 0; i < n; ++i) {
+            std::tm t = LibcLocal(StampAt(i, thread_index));
+            t.tm_hour = 0;
+            t.tm_min = 0;
+            t.tm_sec = 0;
+            sum += static_cast<long long>(LibcMktime(t));
+        }
+        return sum;
+    } });
+    cases.push_back(ScalingCase{ "Construct", "original", [](long long n, int thread_index) {
+        long long sum = 0;
+        for (long long i = 0; i < n; ++i) {
+            const long long k = i + thread_index;
+            std::tm t{};
+            t.tm_year = 100 + static_cast<int>(k % 30);
+            t.tm_mon = static_cast<int>(k % 12);
+            t.tm_mday = 1 + static_cast<int>(k % 28);
+            t.tm_hour = static_cast<int>(k % 24);
+            sum += static_cast<long long>(LibcMktime(t));
+        }
+        return sum;
+    } });
+
+    const char* modes[2] = { "libc", "lockfree" };
+    for (const char* mode : modes) {
+        cases.push_back(ScalingCase{ "GetHour", mode, [](long long n, int thread_index) {
+            long long sum = 0;
+            for (long long i = 0; i < n; ++i) {
+                sum += CDMDateTime::FromTimestamp(StampAt(i, thread_index)).GetHour();
+            }
+            return sum;
+        } });
+        cases.push_back(ScalingCase{ "GetStartOfDay", mode, [](long long n, int thread_index) {
+            long long sum = 0;
+            for (long long i = 0; i < n; ++i) {
+                sum += static_cast<long long>(CDMDateTime::FromTimestamp(StampAt(i, thread_index)).GetStartOfDay().GetTimestamp());
+            }
+            return sum;
+        } });
+        cases.push_back(ScalingCase{ "Construct", mode, [](long long n, int thread_index) {
+            long long sum = 0;
+            for (long long i = 0; i < n; ++i) {
+                const long long k = i + thread_index;
+                sum += static_cast<long long>(CDMDateTime(2000 + static_cast<int>(k % 30), 1 + static_cast<int>(k % 12),
+                    1 + static_cast<int>(k % 28), static_cast<int>(k % 24), 0, 0).GetTimestamp());
+            }
+            return sum;
+        } });
+    }
+    return cases;
+}
+
+std::vector<BenchResult> RunScaling(const BenchOptions& options) {
+    std::vector<int> thread_counts;
+    for (int n = 1; n < options.threads; n *= 2) {
+        thread_counts.push_back(n);
+    }
+    thread_counts.push_back(options.threads);
+
+    std::vector<BenchResult> results;
+    std::fprintf(stderr, "%-16s %-9s %8s %14s %10s\n", "case", "mode", "threads", "ops/sec", "scaling");
+    for (const ScalingCase& scaling : BuildScalingCases()) {
+        if (!options.filter.empty() && scaling.name.find(options.filter) == std::string::npos) {
+            continue;
+        }
+        if (scaling.mode == "lockfree") {
+            if (!CDMDateTime::EnableLockFreeConversion()) {
+                std::fprintf(stderr, "%-16s %-9s skipped: local time zone file not available\n", scaling.name.c_str(), "lockfree");
+                continue;
+            }
+        }
+        else {
+            CDMDateTime::DisableLockFreeConversion();
+        }
+        double single = 0.0;
+        for (int threads : thread_counts) {
+            BenchResult r = RunCase(BenchCase{ scaling.name, scaling.run }, threads, options.iterations);
+            r.mode = scaling.mode;
+            if (threads == 1) {
+                single = r.ops_per_sec;
+            }
+            r.scaling_efficiency = single > 0.0 ? r.ops_per_sec / (single * threads) : 0.0;
+            std::fprintf(stderr, "%-16s %-9s %8d %14.0f %10.3f\n", r.name.c_str(), r.mode.c_str(), r.threads,
+                r.ops_per_sec, r.scaling_efficiency);
+            results.push_back(r);
+        }
+    }
+    CDMDateTime::DisableLockFreeConversion();
+    return results;
+}
+
+void WriteJson(FILE* out, const BenchOptions& options, const std::vector<BenchResult>& results) {
+    const char* tz = std::getenv("TZ");
+    std::fprintf(out, "{\n");
+    std::fprintf(out, "  \"benchmark\": \"dmdatetimebench\",\n");
+    std::fprintf(out, "  \"kind\": \"%s\",\n", options.scaling ? "scaling" : "suite");
+    std::fprintf(out, "  \"timezone\": \"%s\",\n", tz != nullptr ? tz : "");
+    std::fprintf(out, "  \"hardware_threads\": %u,\n", std::thread::hardware_concurrency());
+    std::fprintf(out, "  \"iterations\": %lld,\n", options.iterations);
+    std::fprintf(out, "  \"results\": [\n");
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& r = results[i];
+        std::fprintf(out, "    {\"name\": \"%s\", ", r.name.c_str());
+        if (!r.mode.empty()) {
+            std::fprintf(out, "\"mode\": \"%s\", ", r.mode.c_str());
+        }
+        std::fprintf(out, "\"threads\": %d, \"iterations\": %lld, \"ns_per_op\": %.3f, \"ops_per_sec\": %.0f",
+            r.threads, r.iterations, r.ns_per_op, r.ops_per_sec);
+        if (options.scaling) {
+            std::fprintf(out, ", \"scaling_efficiency\": %.3f", r.scaling_efficiency);
+        }
+        std::fprintf(out, "}%s\n", i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(out, "  ]\n");
+    std::fprintf(out, "}\n");
+}
+
+bool ParseOptions(int argc, char** argv, BenchOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        const bool has_value = i + 1 < argc;
+        if (std::strcmp(argv[i], "--threads") == 0 && has_value) {
+            options.threads = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--iterations") == 0 && has_value) {
+            options.iterations = std::atoll(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--filter") == 0 && has_value) {
+            options.filter = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--output") == 0 && has_value) {
+            options.output = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--scaling") == 0) {
+            options.scaling = true;
+        }
+        else {
+            std::fprintf(stderr, "usage: %s [--threads N] [--iterations N] [--filter substr] [--output file.json] [--scaling]\n", argv[0]);
+            return false;
+        }
+    }
+    if (options.threads <= 0) {
+        const unsigned hw = std::thread::hardware_concurrency();
+        options.threads = hw > 1 ? static_cast<int>(hw) : 2;
+    }
+    if (options.iterations <= 0) {
+        options.iterations = 1;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchOptions options;
+    if (!ParseOptions(argc, argv, options)) {
+        return 1;
+    }
+    Prepare();
+
+    std::vector<BenchResult> results;
+    if (options.scaling) {
+        results = RunScaling(options);
+    }
+    else {
+        std::fprintf(stderr, "%-22s %8s %12s %14s\n", "case", "threads", "ns/op", "ops/sec");
+    }
+    for (const BenchCase& bench : options.scaling ? std::vector<BenchCase>() : BuildCases()) {
+        if (!options.filter.empty() && bench.name.find(options.filter) == std::string::npos) {
+            continue;
+        }
+        if (bench.prepare) {
+            bench.prepare();
+        }
+        const int modes[2] = { 1, options.threads };
+        const int mode_count = options.threads > 1 ? 2 : 1; // --threads 1 时只跑一遍，避免重复的结果行
+        for (int m = 0; m < mode_count; ++m) {
+            const int threads = modes[m];
+            const BenchResult r = RunCase(bench, threads, options.iterations);
+            std::fprintf(stderr, "%-22s %8d %12.2f %14.0f\n", r.name.c_str(), r.threads, r.ns_per_op, r.ops_per_sec);
+            results.push_back(r);
+        }
+    }
+
+    FILE* out = stdout;
+    if (!options.output.empty()) {
+        out = std::fopen(options.output.c_str(), "w");
+        if (out == nullptr) {
+            std::fprintf(stderr, "cannot open %s\n", options.output.c_str());
+            return 1;
+        }
+    }
+    WriteJson(out, options, results);
+    if (out != stdout) {
+        std::fclose(out);
+    }
+    std::fprintf(stderr, "(checksum %lld)\n", static_cast<long long>(g_sink));
+    return 0;
+}
@@ -0,0 +1,276 @@
+﻿// Copyright (c) 2018 brinkqiang (brink.qiang@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __DMBUSINESSCALENDAR_H__
+#define __DMBUSINESSCALENDAR_H__
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "dmdatetime.h"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+// 工作日历：[first_year, last_year] 内每天一个 bit，1 表示工作日。
+// 初始按周末规则填充（默认周六、周日休息），再用 SetHoliday / SetWorkday 标记法定假日与调休上班日。
+// 另存每个 64 位字之前的工作日前缀和，因此：
+//   IsBusinessDay      一次取位
+//   CountBusinessDays  两次“前缀和 + 掩码 popcount”相减，与区间长度无关
+//   AddBusinessDays    从起点所在字出发在前缀和上定位目标字（远距离时二分），再在字内选出第 k 个置位
+// 日期一律按本地日历日计算；修改接口不是线程安全的，应在并发查询前配置完毕。
+
+class CDMBusinessCalendar {
+public:
+    // 周末掩码：bit w 为 1 表示星期 w（0=周日 … 6=周六）休息
+    static const unsigned WEEKEND_SATURDAY_SUNDAY = (1u << 0) | (1u << 6);
+    static const unsigned WEEKEND_FRIDAY_SATURDAY = (1u << 5) | (1u << 6);
+
+    CDMBusinessCalendar(int first_year, int last_year, unsigned weekend_mask = WEEKEND_SATURDAY_SUNDAY)
+        : first_year_(first_year), last_year_(last_year), weekend_mask_(weekend_mask & 0x7Fu) {
+        if (first_year < 1 || last_year > 9999 || first_year > last_year) {
+            throw std::runtime_error("Invalid business calendar year range.");
+        }
+        first_day_ = CDMCivil::DaysFromCivil(first_year, 1, 1);
+        day_count_ = CDMCivil::DaysFromCivil(last_year + 1, 1, 1) - first_day_;
+        // 多留一个全零字，day_count_ 处的前缀和不用特判
+        words_.assign(static_cast<size_t>(day_count_ / 64 + 1), 0);
+        for (long long i = 0; i < day_count_; ++i) {
+            if (!is_weekend(first_day_ + i)) {
+                words_[static_cast<size_t>(i >> 6)] |= 1ULL << (i & 63);
+            }
+        }
+        prefix_.assign(words_.size() + 1, 0);
+        rebuild_prefix(0);
+    }
+
+    inline int GetFirstYear() const {
+        return first_year_;
+    }
+
+    inline int GetLastYear() const {
+        return last_year_;
+    }
+
+    inline bool IsInRange(int year, int month, int day) const {
+        return contains(CDMCivil::DaysFromCivil(year, month, day));
+    }
+
+    // 法定假日：该日不上班
+    inline void SetHoliday(int year, int month, int day) {
+        SetBusinessDay(CDMCivil::DaysFromCivil(year, month, day), false);
+    }
+
+    // 从某日起连续 count 天放假，例如国庆 SetHolidays(2024, 10, 1, 7)
+    inline void SetHolidays(int year, int month, int day, int count) {
+        const long long days = CDMCivil::DaysFromCivil(year, month, day);
+        if (count <= 0) {
+            return;
+        }
+        check_range(days);
+        check_range(days + count - 1);
+        for (int i = 0; i < count; ++i) {
+            assign_bit(days + i - first_day_, false);
+        }
+        rebuild_prefix(static_cast<size_t>((days - first_day_) >> 6));
+    }
+
+    // 调休上班日：周末也要上班
+    inline void SetWorkday(int year, int month, int day) {
+        SetBusinessDay(CDMCivil::DaysFromCivil(year, month, day), true);
+    }
+
+    // 恢复为周末规则的默认值
+    inline void ResetDay(int year, int month, int day) {
+        const long long days = CDMCivil::DaysFromCivil(year, month, day);
+        SetBusinessDay(days, !is_weekend(days));
+    }
+
+    // days 为距 1970-01-01 的天数
+    inline void SetBusinessDay(long long days, bool business) {
+        check_range(days);
+        assign_bit(days - first_day_, business);
+        rebuild_prefix(static_cast<size_t>((days - first_day_) >> 6));
+    }
+
+    // 超出年份范围时按周末规则判断
+    inline bool IsBusinessDay(long long days) const {
+        if (!contains(days)) {
+            return !is_weekend(days);
+        }
+        const long long i = days - first_day_;
+        return (words_[static_cast<size_t>(i >> 6)] >> (i & 63)) & 1u;
+    }
+
+    inline bool IsBusinessDay(int year, int month, int day) const {
+        return IsBusinessDay(CDMCivil::DaysFromCivil(year, month, day));
+    }
+
+    inline bool IsBusinessDay(const CDMDateTime& date) const {
+        return IsBusinessDay(local_days(date));
+    }
+
+    // [first_day, last_day) 内的工作日数，last_day 可以等于范围末尾的下一天；first_day > last_day 时结果为负
+    inline long long CountBusinessDays(long long first_day, long long last_day) const {
+        check_boundary(first_day);
+        check_boundary(last_day);
+        return rank(last_day - first_day_) - rank(first_day - first_day_);
+    }
+
+    // 按本地日期计数，含 start 当天、不含 end 当天
+    inline long long CountBusinessDays(const CDMDateTime& start, const CDMDateTime& end) const {
+        return CountBusinessDays(local_days(start), local_days(end));
+    }
+
+    // 往后（n > 0）或往前（n < 0）数第 |n| 个工作日；n == 0 返回 days 本身。结果超出范围时抛出异常
+    inline long long AddBusinessDays(long long days, long long n) const {
+        check_range(days);
+        if (n == 0) {
+            return days;
+        }
+        const long long i = days - first_day_;
+        // 目标工作日在全表中的序号（从 0 开始）
+        const long long target = n > 0 ? rank(i + 1) + n - 1 : rank(i) + n;
+        if (target < 0 || target >= static_cast<long long>(prefix_.back())) {
+            throw std::runtime_error("Business day out of calendar range.");
+        }
+        return first_day_ + select(target, static_cast<size_t>(i >> 6));
+    }
+
+    // 保留原时分秒，只移动本地日期
+    inline CDMDateTime AddBusinessDays(const CDMDateTime& date, long long n) const {
+        const DMCivilDate civil = CDMCivil::CivilFromDays(AddBusinessDays(local_days(date), n));
+        return CDMDateTime(civil.year, civil.month, civil.day, date.GetHour(), date.GetMinute(), date.GetSecond());
+    }
+
+private:
+    static inline long long local_days(const CDMDateTime& date) {
+        return CDMCivil::DaysFromCivil(date.GetYear(), date.GetMonth(), date.GetDay());
+    }
+
+    static inline int popcount(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_popcountll(value);
+#else
+        value = value - ((value >> 1) & 0x5555555555555555ULL);
+        value = (value & 0x3333333333333333ULL) + ((value >> 2) & 0x3333333333333333ULL);
+        value = (value + (value >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+        return static_cast<int>((value * 0x0101010101010101ULL) >> 56);
+#endif
+    }
+
+    static inline int count_trailing_zeros(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzll(value);
+#elif defined(_M_X64) || defined(_M_ARM64)
+        unsigned long index = 0;
+        _BitScanForward64(&index, value);
+        return static_cast<int>(index);
+#else
+        int index = 0;
+        while ((value & 1u) == 0) {
+            value >>= 1;
+            ++index;
+        }
+        return index;
+#endif
+    }
+
+    inline bool is_weekend(long long days) const {
+        return (weekend_mask_ >> CDMCivil::WeekdayFromDays(days)) & 1u;
+    }
+
+    inline bool contains(long long days) const {
+        return days >= first_day_ && days < first_day_ + day_count_;
+    }
+
+    inline void check_range(long long days) const {
+        if (!contains(days)) {
+            throw std::runtime_error("Date out of business calendar range.");
+        }
+    }
+
+    inline void check_boundary(long long days) const {
+        if (days < first_day_ || days > first_day_ + day_count_) {
+            throw std::runtime_error("Date out of business calendar range.");
+        }
+    }
+
+    inline void assign_bit(long long i, bool business) {
+        uint64_t& word = words_[static_cast<size_t>(i >> 6)];
+        const uint64_t bit = 1ULL << (i & 63);
+        word = business ? (word | bit) : (word & ~bit);
+    }
+
+    inline void rebuild_prefix(size_t from_word) {
+        for (size_t w = from_word; w < words_.size(); ++w) {
+            prefix_[w + 1] = prefix_[w] + static_cast<uint32_t>(popcount(words_[w]));
+        }
+    }
+
+    // 表内下标 [0, i) 中的工作日数
+    inline long long rank(long long i) const {
+        const size_t w = static_cast<size_t>(i >> 6);
+        const uint64_t mask = (1ULL << (i & 63)) - 1;
+        return static_cast<long long>(prefix_[w]) + popcount(words_[w] & mask);
+    }
+
+    // 序号为 target 的工作日在表内的下标；目标通常离 hint 所在字不远，先在附近查找，较远时再二分
+    inline long long select(long long target, size_t hint) const {
+        const uint32_t wanted = static_cast<uint32_t>(target);
+        size_t w = hint;
+        for (int step = 0; step < 8 && !(prefix_[w] <= wanted && wanted < prefix_[w + 1]); ++step) {
+            w = prefix_[w] > wanted ? w - 1 : w + 1;
+        }
+        if (!(prefix_[w] <= wanted && wanted < prefix_[w + 1])) {
+            w = static_cast<size_t>(std::upper_bound(prefix_.begin(), prefix_.end(), wanted) - prefix_.begin()) - 1;
+        }
+        uint64_t word = words_[w];
+        int k = static_cast<int>(wanted - prefix_[w]);
+        // 先按字节跳过，再在字节内逐个清掉最低位
+        int base = 0;
+        for (;;) {
+            const int in_byte = popcount(word & 0xFFu);
+            if (k < in_byte) {
+                break;
+            }
+            k -= in_byte;
+            word >>= 8;
+            base += 8;
+        }
+        word &= 0xFFu;
+        while (k-- > 0) {
+            word &= word - 1;
+        }
+        return static_cast<long long>(w) * 64 + base + count_trailing_zeros(word);
+    }
+
+    int first_year_;
+    int last_year_;
+    unsigned weekend_mask_;
+    long long first_day_ = 0;
+    long long day_count_ = 0;
+    std::vector<uint64_t> words_;
+    std::vector<uint32_t> prefix_; // prefix_[w] = words_[0, w) 中的工作日数
+};
+
+#endif // __DMBUSINESSCALENDAR_H__
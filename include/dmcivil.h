@@ -0,0 +1,103 @@
+// Copyright (c) 2018 brinkqiang (brink.qiang@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __DMCIVIL_H__
+#define __DMCIVIL_H__
+
+// 纯算术的公历换算（proleptic Gregorian），不依赖 libc 的 mktime/localtime。
+// 天数以 1970-01-01 为第 0 天，秒数均为“本地秒”或“UTC秒”，由调用者决定含义。
+// 算法参考 Howard Hinnant 的 days_from_civil / civil_from_days。
+
+struct DMCivilDate {
+    int year;
+    int month; // 1-12
+    int day;   // 1-31
+};
+
+class CDMCivil {
+public:
+    static constexpr long long SECONDS_PER_DAY = 86400LL;
+
+    static constexpr long long FloorDiv(long long a, long long b) {
+        return (a >= 0) ? (a / b) : -((-a + b - 1) / b);
+    }
+    static constexpr long long FloorMod(long long a, long long b) {
+        return a - FloorDiv(a, b) * b;
+    }
+
+    static constexpr bool IsLeapYear(long long y) {
+        return (y % 4 == 0 && y % 100 != 0) || (y % 400 == 0);
+    }
+
+    static constexpr int DaysInMonth(long long y, int m) {
+        return (m == 2) ? (IsLeapYear(y) ? 29 : 28)
+            : ((m == 4 || m == 6 || m == 9 || m == 11) ? 30 : 31);
+    }
+
+    // y-m-d -> 距 1970-01-01 的天数。m 必须在 1-12，d 可以越界（线性外推）。
+    static constexpr long long DaysFromCivil(long long y, int m, int d) {
+        y -= m <= 2;
+        const long long era = (y >= 0 ? y : y - 399) / 400;
+        const long long yoe = y - era * 400;                                   // [0, 399]
+        const long long doy = (153LL * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1; // [0, 365]
+        const long long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;           // [0, 146096]
+        return era * 146097 + doe - 719468;
+    }
+
+    // 距 1970-01-01 的天数 -> y-m-d
+    static constexpr DMCivilDate CivilFromDays(long long z) {
+        z += 719468;
+        const long long era = (z >= 0 ? z : z - 146096) / 146097;
+        const long long doe = z - era * 146097;                                    // [0, 146096]
+        const long long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365; // [0, 399]
+        const long long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);              // [0, 365]
+        const long long mp = (5 * doy + 2) / 153;                                   // [0, 11]
+        const int d = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+        const int m = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+        return DMCivilDate{ static_cast<int>(yoe + era * 400 + (m <= 2)), m, d };
+    }
+
+    // 月份可越界的 y-m-d（与 mktime 的归一化语义一致），例如 2024-13-01 == 2025-01-01
+    static constexpr long long DaysFromCivilNormalized(long long y, long long m, long long d) {
+        return DaysFromCivil(y + FloorDiv(m - 1, 12), static_cast<int>(FloorMod(m - 1, 12) + 1), 1) + d - 1;
+    }
+
+    // 0=Sunday, 6=Saturday
+    static constexpr int WeekdayFromDays(long long z) {
+        return static_cast<int>(FloorMod(z + 4, 7));
+    }
+
+    // 1-366
+    static constexpr int DayOfYear(long long z, int year) {
+        return static_cast<int>(z - DaysFromCivil(year, 1, 1)) + 1;
+    }
+
+    static constexpr long long SecondsFromCivil(long long y, long long mon, long long d,
+        long long h, long long mi, long long s) {
+        return DaysFromCivilNormalized(y, mon, d) * SECONDS_PER_DAY + h * 3600 + mi * 60 + s;
+    }
+};
+
+static_assert(CDMCivil::DaysFromCivil(1970, 1, 1) == 0, "civil epoch");
+static_assert(CDMCivil::DaysFromCivil(2000, 3, 1) == 11017, "civil 2000-03-01");
+static_assert(CDMCivil::CivilFromDays(19717).year == 2023, "civil 2023-12-25");
+static_assert(CDMCivil::WeekdayFromDays(0) == 4, "1970-01-01 is Thursday");
+
+#endif // __DMCIVIL_H__
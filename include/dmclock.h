@@ -0,0 +1,276 @@
+// Copyright (c) 2018 brinkqiang (brink.qiang@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __DMCLOCK_H__
+#define __DMCLOCK_H__
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define DMCLOCK_HAS_TSC 1
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#include <cpuid.h>
+#endif
+#endif
+
+// 可选的“当前时间”来源，调用方按精度/开销在每个调用点自行选择：
+//   CLOCK_SOURCE_SYSTEM           std::time，整秒（默认，与原实现一致）
+//   CLOCK_SOURCE_REALTIME         clock_gettime(CLOCK_REALTIME)，Linux 上走 vDSO，纳秒
+//   CLOCK_SOURCE_REALTIME_COARSE  clock_gettime(CLOCK_REALTIME_COARSE)，精度为一个时钟节拍（通常 1-4ms），最便宜
+//   CLOCK_SOURCE_TSC              rdtsc 按 CLOCK_REALTIME 校准换算，周期性重新对齐；
+//                                 CPU 不支持恒定频率 TSC 或非 x86 平台时退回 CLOCK_SOURCE_REALTIME
+// 没有对应系统调用的平台（Windows、非 Linux）上，REALTIME 与 COARSE 都使用 std::chrono::system_clock。
+
+class CDMClock {
+public:
+    enum ClockSource {
+        CLOCK_SOURCE_SYSTEM = 0,
+        CLOCK_SOURCE_REALTIME = 1,
+        CLOCK_SOURCE_REALTIME_COARSE = 2,
+        CLOCK_SOURCE_TSC = 3,
+        CLOCK_SOURCE_COUNT = 4,
+    };
+
+    // TSC 与 CLOCK_REALTIME 重新对齐的间隔
+    static const int64_t TSC_RESYNC_NANOSECONDS = 1000000000LL;
+
+    // 距 1970-01-01 00:00:00 UTC 的纳秒数
+    static int64_t NowNanoseconds(ClockSource source) {
+        switch (source) {
+        case CLOCK_SOURCE_SYSTEM:
+            return static_cast<int64_t>(std::time(nullptr)) * 1000000000LL;
+        case CLOCK_SOURCE_REALTIME_COARSE:
+            return realtime_coarse_ns();
+        case CLOCK_SOURCE_TSC:
+            return tsc_ns();
+        default:
+            return realtime_ns();
+        }
+    }
+
+    static time_t NowSeconds(ClockSource source) {
+        if (source == CLOCK_SOURCE_SYSTEM) {
+            return std::time(nullptr);
+        }
+        const int64_t ns = NowNanoseconds(source);
+        return static_cast<time_t>(ns >= 0 ? ns / 1000000000LL : -((-ns + 999999999LL) / 1000000000LL));
+    }
+
+    // CDMDateTime::Now() 与默认构造函数使用的时钟
+    static void SetDefaultSource(ClockSource source) {
+        default_source_slot().store(source, std::memory_order_relaxed);
+    }
+
+    static ClockSource GetDefaultSource() {
+        return default_source_slot().load(std::memory_order_relaxed);
+    }
+
+    static const char* GetSourceName(ClockSource source) {
+        switch (source) {
+        case CLOCK_SOURCE_SYSTEM:
+            return "system";
+        case CLOCK_SOURCE_REALTIME:
+            return "realtime";
+        case CLOCK_SOURCE_REALTIME_COARSE:
+            return "realtime_coarse";
+        case CLOCK_SOURCE_TSC:
+            return "tsc";
+        default:
+            return "unknown";
+        }
+    }
+
+    // CLOCK_SOURCE_TSC 是否真正使用 TSC（恒定频率 TSC 可用），否则它等同于 CLOCK_SOURCE_REALTIME
+    static bool IsTscReliable() {
+        static const bool reliable = detect_invariant_tsc();
+        return reliable;
+    }
+
+private:
+    static std::atomic<ClockSource>& default_source_slot() {
+        static std::atomic<ClockSource> source{ CLOCK_SOURCE_SYSTEM };
+        return source;
+    }
+
+    static int64_t realtime_ns() {
+#if defined(__linux__)
+        timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+#else
+        return static_cast<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    static int64_t realtime_coarse_ns() {
+#if defined(__linux__) && defined(CLOCK_REALTIME_COARSE)
+        timespec ts;
+        clock_gettime(CLOCK_REALTIME_COARSE, &ts);
+        return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+#else
+        return realtime_ns();
+#endif
+    }
+
+#ifdef DMCLOCK_HAS_TSC
+    static uint64_t read_tsc() {
+        return static_cast<uint64_t>(__rdtsc());
+    }
+
+    static bool detect_invariant_tsc() {
+        unsigned regs[4] = { 0, 0, 0, 0 };
+#if defined(_MSC_VER) && !defined(__clang__)
+        int info[4] = { 0 };
+        __cpuid(info, 0x80000000);
+        if (static_cast<unsigned>(info[0]) < 0x80000007u) {
+            return false;
+        }
+        __cpuid(info, 0x80000007);
+        regs[3] = static_cast<unsigned>(info[3]);
+#else
+        if (__get_cpuid_max(0x80000000u, nullptr) < 0x80000007u) {
+            return false;
+        }
+        __get_cpuid(0x80000007u, &regs[0], &regs[1], &regs[2], &regs[3]);
+#endif
+        return (regs[3] & (1u << 8)) != 0; // Invariant TSC
+    }
+
+    // TSC -> 纳秒的换算参数，用 seqlock 发布：ns = base_ns + ((tsc - base_tsc) * mult) >> 32
+    struct TscState {
+        std::atomic<uint32_t> sequence{ 0 };
+        std::atomic<uint64_t> base_tsc{ 0 };
+        std::atomic<int64_t> base_ns{ 0 };
+        std::atomic<uint64_t> mult{ 0 };
+        std::atomic<uint64_t> resync_ticks{ 0 };
+        std::atomic<bool> resyncing{ false };
+        uint64_t anchor_tsc = 0; // 首次校准的锚点，只由持有 resyncing 的线程访问
+        int64_t anchor_ns = 0;
+    };
+
+    // 紧挨着读取一对 (tsc, realtime)，取两次 tsc 的中点
+    static void sample_pair(uint64_t& tsc, int64_t& ns) {
+        const uint64_t before = read_tsc();
+        ns = realtime_ns();
+        const uint64_t after = read_tsc();
+        tsc = before + (after - before) / 2;
+    }
+
+    static void publish(TscState& state, uint64_t tsc, int64_t ns, uint64_t mult) {
+        const uint32_t sequence = state.sequence.load(std::memory_order_relaxed);
+        state.sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        state.base_tsc.store(tsc, std::memory_order_relaxed);
+        state.base_ns.store(ns, std::memory_order_relaxed);
+        state.mult.store(mult, std::memory_order_relaxed);
+        state.resync_ticks.store(mult == 0 ? 0 : (static_cast<uint64_t>(TSC_RESYNC_NANOSECONDS) << 32) / mult,
+            std::memory_order_relaxed);
+        state.sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    static uint64_t compute_mult(uint64_t tsc_delta, int64_t ns_delta) {
+        if (tsc_delta == 0 || ns_delta <= 0) {
+            return 0;
+        }
+        return (static_cast<uint64_t>(ns_delta) << 32) / tsc_delta;
+    }
+
+    // 首次使用时自旋约 2ms 测出频率
+    static TscState& tsc_state() {
+        static TscState* state = []() {
+            TscState* s = new TscState();
+            uint64_t tsc0 = 0, tsc1 = 0;
+            int64_t ns0 = 0, ns1 = 0;
+            sample_pair(tsc0, ns0);
+            do {
+                sample_pair(tsc1, ns1);
+            } while (ns1 - ns0 < 2000000 && ns1 >= ns0);
+            s->anchor_tsc = tsc0;
+            s->anchor_ns = ns0;
+            publish(*s, tsc1, ns1, compute_mult(tsc1 - tsc0, ns1 - ns0));
+            return s;
+        }();
+        return *state;
+    }
+
+    // 重新对齐：以首次校准为锚点在更长的区间上修正频率，并把基准移到当前时刻。
+    // 同一时刻只有一个线程执行，其余线程继续使用旧参数。
+    static void resync(TscState& state) {
+        bool expected = false;
+        if (!state.resyncing.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            return;
+        }
+        uint64_t tsc = 0;
+        int64_t ns = 0;
+        sample_pair(tsc, ns);
+        uint64_t mult = compute_mult(tsc - state.anchor_tsc, ns - state.anchor_ns);
+        if (mult == 0) {
+            // 墙上时间被往回调过，重新建立锚点
+            state.anchor_tsc = tsc;
+            state.anchor_ns = ns;
+            mult = state.mult.load(std::memory_order_relaxed);
+        }
+        publish(state, tsc, ns, mult);
+        state.resyncing.store(false, std::memory_order_release);
+    }
+
+    static int64_t tsc_ns() {
+        if (!IsTscReliable()) {
+            return realtime_ns();
+        }
+        TscState& state = tsc_state();
+        for (;;) {
+            const uint32_t sequence = state.sequence.load(std::memory_order_acquire);
+            const uint64_t base_tsc = state.base_tsc.load(std::memory_order_relaxed);
+            const int64_t base_ns = state.base_ns.load(std::memory_order_relaxed);
+            const uint64_t mult = state.mult.load(std::memory_order_relaxed);
+            const uint64_t resync_ticks = state.resync_ticks.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if ((sequence & 1u) != 0 || state.sequence.load(std::memory_order_relaxed) != sequence) {
+                continue;
+            }
+            const uint64_t delta = read_tsc() - base_tsc;
+            if (mult == 0 || delta > resync_ticks) {
+                // 超过对齐间隔（或者 TSC 在别的核上落后于基准）时重新对齐，本次直接返回 realtime
+                resync(state);
+                return realtime_ns();
+            }
+            return base_ns + static_cast<int64_t>((delta * mult) >> 32);
+        }
+    }
+#else
+    static bool detect_invariant_tsc() {
+        return false;
+    }
+
+    static int64_t tsc_ns() {
+        return realtime_ns();
+    }
+#endif
+};
+
+#endif // __DMCLOCK_H__
@@ -0,0 +1,452 @@
+﻿// Copyright (c) 2018 brinkqiang (brink.qiang@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __DMCRON_H__
+#define __DMCRON_H__
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include "dmdatetime.h"
+
+// cron 表达式，按本地时间匹配：
+//   5 段：分 时 日 月 周        例如 "*/15 9-18 * * MON-FRI"
+//   6 段：秒 分 时 日 月 周     例如 "0 30 9 * * 1-5"
+// 每段支持 *、?（仅日、周）、列表 a,b、范围 a-b、步长 */n、a-b/n、a/n，月份与星期可写英文缩写（JAN、MON），
+// 星期 0 与 7 都表示周日；另支持 @yearly @annually @monthly @weekly @daily @midnight @hourly。
+// 日与周两段都不是 * 时按 Vixie cron 的约定取并集（任意一段匹配即可）。
+// 解析后每段是一个位掩码，NextFireTime 逐级（月 -> 日 -> 时 -> 分 -> 秒）直接跳到下一个置位，
+// 当月符合条件的日期也由日掩码与按星期平移的周掩码一次算出，不逐分钟试探。
+
+class CDMCronExpression {
+public:
+    // 在该年数内找不到下一次触发（如 "0 0 30 2 *"）时视为永不触发
+    static const int MAX_SEARCH_YEARS = 10;
+
+    // 默认：每分钟第 0 秒
+    CDMCronExpression()
+        : seconds_(1), minutes_(FULL_MINUTES), hours_(FULL_HOURS), days_(FULL_DAYS), months_(FULL_MONTHS),
+        weekdays_(FULL_WEEKDAYS), day_restricted_(false), weekday_restricted_(false) {}
+
+    // 解析失败返回 false，result 不变
+    static bool TryParse(std::string_view expression, CDMCronExpression& result) {
+        std::string_view fields[6];
+        int count = 0;
+        expression = trim(expression);
+        if (!expression.empty() && expression[0] == '@') {
+            return parse_macro(expression, result);
+        }
+        size_t pos = 0;
+        while (pos < expression.size()) {
+            while (pos < expression.size() && is_space(expression[pos])) {
+                ++pos;
+            }
+            if (pos == expression.size()) {
+                break;
+            }
+            const size_t begin = pos;
+            while (pos < expression.size() && !is_space(expression[pos])) {
+                ++pos;
+            }
+            if (count == 6) {
+                return false;
+            }
+            fields[count++] = expression.substr(begin, pos - begin);
+        }
+        if (count != 5 && count != 6) {
+            return false;
+        }
+        const int offset = count == 6 ? 1 : 0;
+        CDMCronExpression parsed;
+        uint64_t mask = 0;
+        if (offset == 1) {
+            if (!parse_field(fields[0], 0, 59, nullptr, false, mask)) {
+                return false;
+            }
+            parsed.seconds_ = mask;
+        }
+        if (!parse_field(fields[offset], 0, 59, nullptr, false, mask)) {
+            return false;
+        }
+        parsed.minutes_ = mask;
+        if (!parse_field(fields[offset + 1], 0, 23, nullptr, false, mask)) {
+            return false;
+        }
+        parsed.hours_ = static_cast<uint32_t>(mask);
+        if (!parse_field(fields[offset + 2], 1, 31, nullptr, true, mask)) {
+            return false;
+        }
+        parsed.days_ = static_cast<uint32_t>(mask);
+        if (!parse_field(fields[offset + 3], 1, 12, month_names(), false, mask)) {
+            return false;
+        }
+        parsed.months_ = static_cast<uint16_t>(mask);
+        if (!parse_field(fields[offset + 4], 0, 7, weekday_names(), true, mask)) {
+            return false;
+        }
+        // 7 与 0 同为周日
+        parsed.weekdays_ = static_cast<uint8_t>((mask | (mask >> 7)) & FULL_WEEKDAYS);
+        parsed.day_restricted_ = !is_wildcard(fields[offset + 2]);
+        parsed.weekday_restricted_ = !is_wildcard(fields[offset + 4]);
+        result = parsed;
+        return true;
+    }
+
+    // 解析失败抛出 std::runtime_error
+    static CDMCronExpression Parse(std::string_view expression) {
+        CDMCronExpression result;
+        if (!TryParse(expression, result)) {
+            throw std::runtime_error("Invalid cron expression: '" + std::string(expression) + "'");
+        }
+        return result;
+    }
+
+    // 该时刻（按本地时间，精确到秒）是否匹配
+    bool Matches(const CDMDateTime& when) const {
+        return test_bit(months_, when.GetMonth()) && day_matches(when.GetDay(), when.GetDayOfWeek())
+            && test_bit(hours_, when.GetHour()) && test_bit(minutes_, when.GetMinute())
+            && test_bit(seconds_, when.GetSecond());
+    }
+
+    // 严格晚于 after 的下一次触发；MAX_SEARCH_YEARS 年内没有时返回 false
+    bool GetNextFireTime(const CDMDateTime& after, CDMDateTime& next) const {
+        const CDMDateTime start = CDMDateTime::FromTimestamp(after.GetTimestamp() + 1);
+        int fields[6] = { start.GetYear(), start.GetMonth(), start.GetDay(), start.GetHour(), start.GetMinute(), start.GetSecond() };
+        // 夏令时缺口里的本地时刻可能被换算到 after 之前，此时从该本地时刻的下一秒继续找
+        for (int attempt = 0; attempt < 4; ++attempt) {
+            if (!next_local(fields)) {
+                return false;
+            }
+            const CDMDateTime candidate(fields[0], fields[1], fields[2], fields[3], fields[4], fields[5]);
+            if (candidate > after) {
+                next = candidate;
+                return true;
+            }
+            ++fields[5];
+        }
+        return false;
+    }
+
+    // 同上，找不到时抛出 std::runtime_error
+    CDMDateTime NextFireTime(const CDMDateTime& after) const {
+        CDMDateTime next;
+        if (!GetNextFireTime(after, next)) {
+            throw std::runtime_error("Cron expression never fires.");
+        }
+        return next;
+    }
+
+    inline uint64_t GetSecondMask() const {
+        return seconds_;
+    }
+
+    inline uint64_t GetMinuteMask() const {
+        return minutes_;
+    }
+
+    inline uint32_t GetHourMask() const {
+        return hours_;
+    }
+
+    // bit 1-31
+    inline uint32_t GetDayMask() const {
+        return days_;
+    }
+
+    // bit 1-12
+    inline uint16_t GetMonthMask() const {
+        return months_;
+    }
+
+    // bit 0（周日）- 6（周六）
+    inline uint8_t GetWeekdayMask() const {
+        return weekdays_;
+    }
+
+private:
+    static const uint64_t FULL_MINUTES = (1ULL << 60) - 1;
+    static const uint32_t FULL_HOURS = (1u << 24) - 1;
+    static const uint32_t FULL_DAYS = 0xFFFFFFFEu;
+    static const uint16_t FULL_MONTHS = 0x1FFE;
+    static const uint8_t FULL_WEEKDAYS = 0x7F;
+
+    static inline bool is_space(char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    static inline std::string_view trim(std::string_view text) {
+        while (!text.empty() && is_space(text.front())) {
+            text.remove_prefix(1);
+        }
+        while (!text.empty() && is_space(text.back())) {
+            text.remove_suffix(1);
+        }
+        return text;
+    }
+
+    static inline bool is_wildcard(std::string_view field) {
+        return field[0] == '*' || field[0] == '?';
+    }
+
+    static inline bool test_bit(uint64_t mask, int bit) {
+        return (mask >> bit) & 1u;
+    }
+
+    static inline int count_trailing_zeros(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzll(value);
+#else
+        int index = 0;
+        while ((value & 1u) == 0) {
+            value >>= 1;
+            ++index;
+        }
+        return index;
+#endif
+    }
+
+    // mask 中不小于 from 的最低置位，没有时返回 -1
+    static inline int next_bit(uint64_t mask, int from) {
+        if (from > 63) {
+            return -1;
+        }
+        const uint64_t rest = mask & (~0ULL << from);
+        return rest == 0 ? -1 : count_trailing_zeros(rest);
+    }
+
+    static const char* const* month_names() {
+        static const char* const names[13] = { "", "JAN", "FEB", "MAR", "APR", "MAY", "JUN", "JUL", "AUG", "SEP", "OCT", "NOV", "DEC" };
+        return names;
+    }
+
+    static const char* const* weekday_names() {
+        static const char* const names[8] = { "SUN", "MON", "TUE", "WED", "THU", "FRI", "SAT", "" };
+        return names;
+    }
+
+    static bool parse_number(std::string_view text, int low, int high, const char* const* names, int& value) {
+        if (text.empty()) {
+            return false;
+        }
+        if (names != nullptr && text.size() == 3 && !(text[0] >= '0' && text[0] <= '9')) {
+            for (int i = low; i <= high; ++i) {
+                const char* name = names[i];
+                if (name[0] != '\0' && (text[0] & ~0x20) == name[0] && (text[1] & ~0x20) == name[1] && (text[2] & ~0x20) == name[2]) {
+                    value = i;
+                    return true;
+                }
+            }
+            return false;
+        }
+        int result = 0;
+        for (char c : text) {
+            if (c < '0' || c > '9' || result > 1000) {
+                return false;
+            }
+            result = result * 10 + (c - '0');
+        }
+        if (result < low || result > high) {
+            return false;
+        }
+        value = result;
+        return true;
+    }
+
+    // 解析一段为位掩码，bit i 表示取值 i
+    static bool parse_field(std::string_view field, int low, int high, const char* const* names, bool allow_question, uint64_t& mask) {
+        mask = 0;
+        while (!field.empty()) {
+            const size_t comma = field.find(',');
+            std::string_view item = field.substr(0, comma);
+            field = comma == std::string_view::npos ? std::string_view() : field.substr(comma + 1);
+            if (comma != std::string_view::npos && field.empty()) {
+                return false;
+            }
+            int step = 1;
+            const size_t slash = item.find('/');
+            bool has_step = false;
+            if (slash != std::string_view::npos) {
+                if (!parse_number(item.substr(slash + 1), 1, high - low + 1, nullptr, step)) {
+                    return false;
+                }
+                item = item.substr(0, slash);
+                has_step = true;
+            }
+            int first = low;
+            int last = high;
+            if (item == "*" || (allow_question && item == "?")) {
+                // 全范围
+            }
+            else {
+                const size_t dash = item.find('-');
+                if (!parse_number(item.substr(0, dash), low, high, names, first)) {
+                    return false;
+                }
+                if (dash != std::string_view::npos) {
+                    if (!parse_number(item.substr(dash + 1), low, high, names, last) || last < first) {
+                        return false;
+                    }
+                }
+                else if (!has_step) {
+                    last = first;
+                }
+            }
+            for (int value = first; value <= last; value += step) {
+                mask |= 1ULL << value;
+            }
+        }
+        return mask != 0;
+    }
+
+    static bool parse_macro(std::string_view macro, CDMCronExpression& result) {
+        static const struct {
+            const char* name;
+            const char* expression;
+        } macros[] = {
+            { "@yearly", "0 0 1 1 *" },
+            { "@annually", "0 0 1 1 *" },
+            { "@monthly", "0 0 1 * *" },
+            { "@weekly", "0 0 * * 0" },
+            { "@daily", "0 0 * * *" },
+            { "@midnight", "0 0 * * *" },
+            { "@hourly", "0 * * * *" },
+        };
+        for (const auto& item : macros) {
+            if (macro == item.name) {
+                return TryParse(item.expression, result);
+            }
+        }
+        return false;
+    }
+
+    inline bool day_matches(int day, int weekday) const {
+        const bool by_day = test_bit(days_, day);
+        const bool by_weekday = test_bit(weekdays_, weekday);
+        if (day_restricted_ && weekday_restricted_) {
+            return by_day || by_weekday;
+        }
+        return by_day && by_weekday;
+    }
+
+    // 某月中符合日、周两段的日期掩码（bit 1-31）
+    inline uint32_t month_day_mask(int year, int month) const {
+        const int days_in_month = CDMCivil::DaysInMonth(year, month);
+        const uint32_t valid = static_cast<uint32_t>(((1ULL << (days_in_month + 1)) - 1) & ~1ULL);
+        // 把周掩码铺到 1-31 日：第 d 日的星期为 (first + d - 1) % 7
+        const int first = CDMCivil::WeekdayFromDays(CDMCivil::DaysFromCivil(year, month, 1));
+        uint32_t week = 0;
+        const uint32_t rotated = ((static_cast<uint32_t>(weekdays_) | (static_cast<uint32_t>(weekdays_) << 7)) >> first) & 0x7F;
+        for (int shift = 1; shift <= 31; shift += 7) {
+            week |= rotated << shift;
+        }
+        uint32_t days;
+        if (day_restricted_ && weekday_restricted_) {
+            days = days_ | week;
+        }
+        else {
+            days = days_ & week;
+        }
+        return days & valid;
+    }
+
+    // 不早于 fields 的第一个匹配的本地时刻，结果写回 fields {年, 月, 日, 时, 分, 秒}；
+    // 输入的秒、分、时、日可以比合法值大 1，视为进位
+    bool next_local(int fields[6]) const {
+        int year = fields[0];
+        int month = fields[1];
+        int day = fields[2];
+        int hour = fields[3];
+        int minute = fields[4];
+        int second = fields[5];
+        const int last_year = year + MAX_SEARCH_YEARS;
+        for (;;) {
+            const int next_month = next_bit(months_, month);
+            if (next_month < 0) {
+                if (++year > last_year) {
+                    return false;
+                }
+                month = next_bit(months_, 1);
+                day = 1;
+                hour = minute = second = 0;
+            }
+            else if (next_month != month) {
+                month = next_month;
+                day = 1;
+                hour = minute = second = 0;
+            }
+            const int next_day = next_bit(month_day_mask(year, month), day);
+            if (next_day < 0) {
+                ++month;
+                day = 1;
+                hour = minute = second = 0;
+                continue;
+            }
+            if (next_day != day) {
+                day = next_day;
+                hour = minute = second = 0;
+            }
+            const int next_hour = next_bit(hours_, hour);
+            if (next_hour < 0) {
+                ++day;
+                hour = minute = second = 0;
+                continue;
+            }
+            if (next_hour != hour) {
+                hour = next_hour;
+                minute = second = 0;
+            }
+            const int next_minute = next_bit(minutes_, minute);
+            if (next_minute < 0) {
+                ++hour;
+                minute = second = 0;
+                continue;
+            }
+            if (next_minute != minute) {
+                minute = next_minute;
+                second = 0;
+            }
+            const int next_second = next_bit(seconds_, second);
+            if (next_second < 0) {
+                ++minute;
+                second = 0;
+                continue;
+            }
+            fields[0] = year;
+            fields[1] = month;
+            fields[2] = day;
+            fields[3] = hour;
+            fields[4] = minute;
+            fields[5] = next_second;
+            return true;
+        }
+    }
+
+    uint64_t seconds_;
+    uint64_t minutes_;
+    uint32_t hours_;
+    uint32_t days_;
+    uint16_t months_;
+    uint8_t weekdays_;
+    bool day_restricted_;
+    bool weekday_restricted_;
+};
+
+#endif // __DMCRON_H__
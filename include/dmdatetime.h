@@ -23,9 +23,18 @@
 
 #include <string>
 #include <stdexcept>
-#include <ctime> // Required for time_t, tm, mktime, localtime_r/s, gmtime_r/s, strftime, time
+#include <ctime> // Required for time_t, tm, localtime_r/s, gmtime_r/s, strftime, time
 #include <cstdio>  // For snprintf
 #include <cstring> // For C-style string operations (though not directly used extensively)
+#include <cstdint>
+#include <atomic>
+#include <string_view>
+#include "dmcivil.h"
+#include "dmclock.h"
+#include "dmlunar.h"
+#include "dmsolarterm.h"
+#include "dmtimezone.h"
+#include "dmdatetimesimd.h"
 // Removed <chrono>, <iomanip> (unless needed for other parts, not for core logic here)
 // <algorithm>, <vector> were included but not used directly by the classes.
 #ifdef _WIN32
@@ -70,49 +79,675 @@ public:
     bool operator!=(const CDMTimeSpan& other) const { return duration_seconds_ != other.duration_seconds_; }
 };
 
+// ExtractFields 的列式输出，为空的列不写入
+struct DMDateTimeColumns {
+    int16_t* year = nullptr;
+    uint8_t* month = nullptr;       // 1-12
+    uint8_t* day = nullptr;         // 1-31
+    uint8_t* hour = nullptr;
+    uint8_t* minute = nullptr;
+    uint8_t* second = nullptr;
+    uint8_t* day_of_week = nullptr; // 0=Sunday
+    uint16_t* day_of_year = nullptr; // 1-366
+};
+
+template<long long TicksPerSecond> class CDMBasicDateTime;
+class CDMFormatPattern;
+
 class CDMDateTime {
 private:
+    // 亚秒精度的时间点复用本类的解析器与格式化（见 dmprecisetime.h）
+    template<long long TicksPerSecond> friend class CDMBasicDateTime;
+    // 按模式串编译的格式化/解析直接读写本地时间分量（见 dmdatetimeformat.h）
+    friend class CDMFormatPattern;
+
     time_t time_t_value_;
 
-    inline std::tm to_tm_local() const {
+    // 本地时间分量的惰性缓存，打包在一个 64 位字里（bit0 为有效位）：
+    // year+32768:16 | month:4 | day:5 | hour:5 | minute:6 | second:6 | wday:3 | yday:9 | zone_gen:9
+    // 首次调用 getter 时填充，SetDateTime/SetDate/SetTime 或切换本地时区后失效。用 relaxed 原子读写，
+    // 多线程共享同一个 const 对象调用 getter 也是安全的（最坏情况重复计算一次）。
+    mutable std::atomic<uint64_t> fields_cache_{ 0 };
+
+    enum : int {
+        FIELD_VALID_SHIFT = 0,
+        FIELD_YEAR_SHIFT = 1,
+        FIELD_MONTH_SHIFT = 17,
+        FIELD_DAY_SHIFT = 21,
+        FIELD_HOUR_SHIFT = 26,
+        FIELD_MINUTE_SHIFT = 31,
+        FIELD_SECOND_SHIFT = 37,
+        FIELD_WDAY_SHIFT = 43,
+        FIELD_YDAY_SHIFT = 46,
+        FIELD_ZONE_GEN_SHIFT = 55,
+    };
+
+    static inline std::atomic<const CDMTimeZone*>& local_zone_slot() {
+        static std::atomic<const CDMTimeZone*> zone{ nullptr };
+        return zone;
+    }
+
+    // 每次 SetLocalTimeZone 递增，用来作废线程本地的偏移缓存和对象内的字段缓存
+    static inline std::atomic<uint32_t>& local_zone_generation() {
+        static std::atomic<uint32_t> generation{ 0 };
+        return generation;
+    }
+
+    // 通过 libc 求某个 UTC 时刻的本地偏移（秒），只在缓存未命中时调用
+    static inline int libc_utc_offset(time_t utc) {
         std::tm local_tm{};
 #ifdef _WIN32
-        localtime_s(&local_tm, &time_t_value_);
+        localtime_s(&local_tm, &utc);
 #else
-        localtime_r(&time_t_value_, &local_tm);
+        localtime_r(&utc, &local_tm);
 #endif
-        return local_tm;
+        return static_cast<int>(timegm_custom(&local_tm) - utc);
     }
 
-    inline std::tm to_tm_utc() const {
-        std::tm utc_tm{};
-#ifdef _WIN32
-        gmtime_s(&utc_tm, &time_t_value_);
-#else
-        gmtime_r(&time_t_value_, &utc_tm);
+    static inline int zone_utc_offset(const CDMTimeZone* zone, time_t utc) {
+        return zone != nullptr ? zone->GetUTCOffset(utc) : libc_utc_offset(utc);
+    }
+
+    enum { OFFSET_CACHE_SIZE = 256 };
+
+    // 本地时区相对 UTC 的偏移（秒）。按 UTC 日缓存在线程本地的直接映射表里（256 项，
+    // 按日编号取模），在相距数月的日期之间来回换算（AddMonths、GetStartOfDay、解析不同日期）也不会互相驱逐。
+    // 若一天首尾两个时刻的偏移相同，则认为整天偏移不变，后续同一天的查询不再进入 libc/时区表；
+    // 含夏令时切换的那一天记为非均匀，逐次查询。
+    static inline int local_utc_offset(time_t utc) {
+        struct OffsetCacheEntry {
+            long long day = 0;
+            uint32_t generation = 0;
+            int offset = 0;
+            bool valid = false;
+            bool uniform = false;
+        };
+        static thread_local OffsetCacheEntry cache[OFFSET_CACHE_SIZE];
+
+        const uint32_t generation = local_zone_generation().load(std::memory_order_acquire);
+        const long long day = CDMCivil::FloorDiv(static_cast<long long>(utc), CDMCivil::SECONDS_PER_DAY);
+        OffsetCacheEntry& entry = cache[static_cast<size_t>(day) & (OFFSET_CACHE_SIZE - 1)];
+        const CDMTimeZone* zone = local_zone_slot().load(std::memory_order_acquire);
+        if (entry.valid && entry.day == day && entry.generation == generation) {
+            return entry.uniform ? entry.offset : zone_utc_offset(zone, utc);
+        }
+        const time_t day_begin = static_cast<time_t>(day * CDMCivil::SECONDS_PER_DAY);
+        const int begin_offset = zone_utc_offset(zone, day_begin);
+        const int end_offset = zone_utc_offset(zone, static_cast<time_t>(day_begin + CDMCivil::SECONDS_PER_DAY - 1));
+        entry.day = day;
+        entry.generation = generation;
+        entry.offset = begin_offset;
+        entry.uniform = (begin_offset == end_offset);
+        entry.valid = true;
+        return entry.uniform ? begin_offset : zone_utc_offset(zone, utc);
+    }
+
+    // 本地时间（秒，已归一化）-> UTC 时间戳，语义等同 tm_isdst = -1 的 mktime：
+    // 落在夏令时跳变空洞里的时间向后顺延。
+    static inline time_t local_seconds_to_utc(long long local_seconds) {
+        const int first_offset = local_utc_offset(static_cast<time_t>(local_seconds));
+        const long long guess = local_seconds - first_offset;
+        const int guess_offset = local_utc_offset(static_cast<time_t>(guess));
+        long long result = local_seconds - guess_offset;
+        const int result_offset = local_utc_offset(static_cast<time_t>(result));
+        if (result_offset != guess_offset) {
+            const long long alternative = local_seconds - result_offset;
+            result = (alternative > result) ? alternative : result;
+        }
+        if (static_cast<long long>(static_cast<time_t>(result)) != result) {
+            throw std::runtime_error("Invalid date/time components that cannot be represented by time_t.");
+        }
+        return static_cast<time_t>(result);
+    }
+
+    inline long long local_seconds() const {
+        return static_cast<long long>(time_t_value_) + local_utc_offset(time_t_value_);
+    }
+
+    static inline long long positive_span(const CDMTimeSpan& span) {
+        const long long width = static_cast<long long>(span.GetTotalSeconds());
+        if (width <= 0) {
+            throw std::runtime_error("Time span for alignment must be positive.");
+        }
+        return width;
+    }
+
+    inline long long local_days() const {
+        return CDMCivil::FloorDiv(local_seconds(), CDMCivil::SECONDS_PER_DAY);
+    }
+
+    inline int local_second_of_day() const {
+        return static_cast<int>(CDMCivil::FloorMod(local_seconds(), CDMCivil::SECONDS_PER_DAY));
+    }
+
+    static inline std::tm seconds_to_tm(long long seconds) {
+        const long long days = CDMCivil::FloorDiv(seconds, CDMCivil::SECONDS_PER_DAY);
+        const int sod = static_cast<int>(seconds - days * CDMCivil::SECONDS_PER_DAY);
+        const DMCivilDate date = CDMCivil::CivilFromDays(days);
+        std::tm result{};
+        result.tm_year = date.year - 1900;
+        result.tm_mon = date.month - 1;
+        result.tm_mday = date.day;
+        result.tm_hour = sod / 3600;
+        result.tm_min = sod / 60 % 60;
+        result.tm_sec = sod % 60;
+        result.tm_wday = CDMCivil::WeekdayFromDays(days);
+        result.tm_yday = CDMCivil::DayOfYear(days, date.year) - 1;
+        result.tm_isdst = -1;
+        return result;
+    }
+
+    static inline uint64_t pack_fields(long long seconds, uint32_t generation) {
+        const long long days = CDMCivil::FloorDiv(seconds, CDMCivil::SECONDS_PER_DAY);
+        const uint64_t sod = static_cast<uint64_t>(seconds - days * CDMCivil::SECONDS_PER_DAY);
+        const DMCivilDate date = CDMCivil::CivilFromDays(days);
+        if (date.year < -32768 || date.year > 32767) {
+            return 0; // 超出打包范围，不缓存
+        }
+        return (1ULL << FIELD_VALID_SHIFT)
+            | (static_cast<uint64_t>(date.year + 32768) << FIELD_YEAR_SHIFT)
+            | (static_cast<uint64_t>(date.month) << FIELD_MONTH_SHIFT)
+            | (static_cast<uint64_t>(date.day) << FIELD_DAY_SHIFT)
+            | ((sod / 3600) << FIELD_HOUR_SHIFT)
+            | ((sod / 60 % 60) << FIELD_MINUTE_SHIFT)
+            | ((sod % 60) << FIELD_SECOND_SHIFT)
+            | (static_cast<uint64_t>(CDMCivil::WeekdayFromDays(days)) << FIELD_WDAY_SHIFT)
+            | (static_cast<uint64_t>(CDMCivil::DayOfYear(days, date.year) - 1) << FIELD_YDAY_SHIFT)
+            | (static_cast<uint64_t>(generation & 0x1FF) << FIELD_ZONE_GEN_SHIFT);
+    }
+
+    inline uint64_t cached_fields() const {
+        const uint32_t generation = local_zone_generation().load(std::memory_order_relaxed);
+        uint64_t packed = fields_cache_.load(std::memory_order_relaxed);
+        if (packed == 0 || (packed >> FIELD_ZONE_GEN_SHIFT) != (generation & 0x1FF)) {
+            packed = pack_fields(local_seconds(), generation);
+            fields_cache_.store(packed, std::memory_order_relaxed);
+        }
+        return packed;
+    }
+
+    // 返回 -1 表示年份超出缓存范围，调用者需走 seconds_to_tm
+    inline int cached_field(int shift, int bits) const {
+        const uint64_t packed = cached_fields();
+        if (packed == 0) {
+            return -1;
+        }
+        return static_cast<int>((packed >> shift) & ((1ULL << bits) - 1));
+    }
+
+    inline std::tm to_tm_local() const {
+        const uint64_t packed = cached_fields();
+        if (packed == 0) {
+            return seconds_to_tm(local_seconds());
+        }
+        std::tm result{};
+        result.tm_year = static_cast<int>((packed >> FIELD_YEAR_SHIFT) & 0xFFFF) - 32768 - 1900;
+        result.tm_mon = static_cast<int>((packed >> FIELD_MONTH_SHIFT) & 0xF) - 1;
+        result.tm_mday = static_cast<int>((packed >> FIELD_DAY_SHIFT) & 0x1F);
+        result.tm_hour = static_cast<int>((packed >> FIELD_HOUR_SHIFT) & 0x1F);
+        result.tm_min = static_cast<int>((packed >> FIELD_MINUTE_SHIFT) & 0x3F);
+        result.tm_sec = static_cast<int>((packed >> FIELD_SECOND_SHIFT) & 0x3F);
+        result.tm_wday = static_cast<int>((packed >> FIELD_WDAY_SHIFT) & 0x7);
+        result.tm_yday = static_cast<int>((packed >> FIELD_YDAY_SHIFT) & 0x1FF);
+        result.tm_isdst = -1;
+        return result;
+    }
+
+    static inline const char* two_digits_table() {
+        static const char table[201] =
+            "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+            "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+            "8081828384858687888990919293949596979899";
+        return table;
+    }
+
+    static inline char* write_2digits(char* p, int value) {
+        std::memcpy(p, two_digits_table() + value * 2, 2);
+        return p + 2;
+    }
+
+    // "YYYY-MM-DD"，可选追加 sep + "HH:MM:SS"。调用者保证年份在 0-9999 且缓冲区至少 19 字节
+    static inline char* write_standard(char* p, const std::tm& t, char sep, bool with_time) {
+        const int year = t.tm_year + 1900;
+        p = write_2digits(p, year / 100);
+        p = write_2digits(p, year % 100);
+        *p++ = '-';
+        p = write_2digits(p, t.tm_mon + 1);
+        *p++ = '-';
+        p = write_2digits(p, t.tm_mday);
+        if (with_time) {
+            *p++ = sep;
+            p = write_2digits(p, t.tm_hour);
+            *p++ = ':';
+            p = write_2digits(p, t.tm_min);
+            *p++ = ':';
+            p = write_2digits(p, t.tm_sec);
+        }
+        return p;
+    }
+
+    static inline bool is_four_digit_year(const std::tm& t) {
+        return t.tm_year >= -1900 && t.tm_year <= 9999 - 1900;
+    }
+
+    // 写入 buffer 并补 '\0'；容量不足（需要 length + 1）时写空串并返回 0
+    static inline size_t finish_buffer(char* buffer, size_t capacity, const char* scratch, size_t length) {
+        if (length + 1 > capacity) {
+            if (capacity > 0) {
+                buffer[0] = '\0';
+            }
+            return 0;
+        }
+        std::memcpy(buffer, scratch, length);
+        buffer[length] = '\0';
+        return length;
+    }
+
+    enum {
+        FORMAT_CACHE_STANDARD = 0,
+        FORMAT_CACHE_UTC = 1,
+        FORMAT_CACHE_ISO = 2,
+        FORMAT_CACHE_COUNT = 3,
+    };
+
+    // 线程本地的“同一分钟”格式化结果缓存。格式化文本只取决于本地秒数与偏移，
+    // 因此以（本地分钟, 偏移）为键：同一秒内直接 memcpy，同一分钟内只改写秒的两位数字。
+    struct FormattedMinuteCache {
+        long long local_minute = 0;
+        int offset = 0;
+        size_t length = 0;
+        bool valid = false;
+        char text[32] = { 0 };
+    };
+
+    static inline FormattedMinuteCache& formatted_minute_cache(int kind) {
+        static thread_local FormattedMinuteCache caches[FORMAT_CACHE_COUNT];
+        return caches[kind];
+    }
+
+    // 秒数字位于第 17、18 字节（"YYYY-MM-DD HH:MM:SS" 及其 ISO 变体），仅在 fill 产生 expected_length 时缓存
+    template<typename Fill>
+    inline size_t format_with_minute_cache(int kind, int offset, size_t expected_length, char* scratch, Fill fill) const {
+        const long long local = static_cast<long long>(time_t_value_) + offset;
+        const long long minute = CDMCivil::FloorDiv(local, 60);
+        const int second = static_cast<int>(local - minute * 60);
+        FormattedMinuteCache& cache = formatted_minute_cache(kind);
+        if (cache.valid && cache.local_minute == minute && cache.offset == offset) {
+            write_2digits(cache.text + 17, second);
+            std::memcpy(scratch, cache.text, cache.length);
+            return cache.length;
+        }
+        const size_t length = fill(scratch);
+        if (length == expected_length) {
+            std::memcpy(cache.text, scratch, length);
+            cache.length = length;
+            cache.local_minute = minute;
+            cache.offset = offset;
+            cache.valid = true;
+        }
+        return length;
+    }
+
+    // 与 snprintf 相同的字段顺序，按内置格式走查表写入，其他格式回退到 snprintf（写入调用者缓冲区，不分配内存）
+    inline size_t format_local(char* scratch, size_t scratch_size, const char* format) const {
+        if (format == TO_STRING_STANDARD || std::strcmp(format, TO_STRING_STANDARD) == 0) {
+            return format_with_minute_cache(FORMAT_CACHE_STANDARD, local_utc_offset(time_t_value_), 19, scratch,
+                [this](char* out) -> size_t {
+                    const std::tm t = to_tm_local();
+                    if (!is_four_digit_year(t)) {
+                        return static_cast<size_t>(std::snprintf(out, 64, TO_STRING_STANDARD,
+                            t.tm_year + 1900, t.tm_mon + 1, t.tm_mday, t.tm_hour, t.tm_min, t.tm_sec));
+                    }
+                    return static_cast<size_t>(write_standard(out, t, ' ', true) - out);
+                });
+        }
+        const std::tm t = to_tm_local();
+        if (is_four_digit_year(t) && (format == TO_STRING_SHORT_DATE || std::strcmp(format, TO_STRING_SHORT_DATE) == 0)) {
+            return static_cast<size_t>(write_standard(scratch, t, ' ', false) - scratch);
+        }
+        const int n = std::snprintf(scratch, scratch_size, format,
+            t.tm_year + 1900, t.tm_mon + 1, t.tm_mday, t.tm_hour, t.tm_min, t.tm_sec);
+        return n < 0 ? 0 : (static_cast<size_t>(n) < scratch_size ? static_cast<size_t>(n) : scratch_size - 1);
+    }
+
+    inline size_t format_utc(char* scratch) const {
+        return format_with_minute_cache(FORMAT_CACHE_UTC, 0, 20, scratch, [this](char* out) -> size_t {
+            const std::tm t = seconds_to_tm(static_cast<long long>(time_t_value_));
+            if (!is_four_digit_year(t)) {
+                return std::strftime(out, 64, "%Y-%m-%dT%H:%M:%SZ", &t);
+            }
+            char* p = write_standard(out, t, 'T', true);
+            *p++ = 'Z';
+            return static_cast<size_t>(p - out);
+        });
+    }
+
+    inline size_t format_iso(char* scratch) const {
+        // 本地时间与UTC时间的偏移量（秒），东八区为 +28800
+        const int offset_seconds = local_utc_offset(time_t_value_);
+        return format_with_minute_cache(FORMAT_CACHE_ISO, offset_seconds, 25, scratch, [this, offset_seconds](char* out) -> size_t {
+            const std::tm t = seconds_to_tm(static_cast<long long>(time_t_value_) + offset_seconds);
+            const int abs_offset = offset_seconds < 0 ? -offset_seconds : offset_seconds;
+            char* p = out;
+            if (is_four_digit_year(t)) {
+                p = write_standard(p, t, 'T', true);
+            }
+            else {
+                p += std::snprintf(p, 64, "%04d-%02d-%02dT%02d:%02d:%02d",
+                    t.tm_year + 1900, t.tm_mon + 1, t.tm_mday, t.tm_hour, t.tm_min, t.tm_sec);
+            }
+            *p++ = offset_seconds < 0 ? '-' : '+';
+            p = write_2digits(p, abs_offset / 3600);
+            *p++ = ':';
+            p = write_2digits(p, abs_offset % 3600 / 60);
+            return static_cast<size_t>(p - out);
+        });
+    }
+
+    // 读取 [min_digits, max_digits] 位十进制数字
+    static inline bool parse_digits(const char*& p, const char* end, int min_digits, int max_digits, int& value) {
+        int n = 0;
+        int v = 0;
+        while (p < end && n < max_digits && static_cast<unsigned>(*p - '0') < 10u) {
+            v = v * 10 + (*p - '0');
+            ++p;
+            ++n;
+        }
+        value = v;
+        return n >= min_digits;
+    }
+
+    // 解析秒之后的部分直到 end：[.fffffffff][Z|±hh[:mm]|±hhmm]。
+    // nanoseconds 非空时返回小数部分（纳秒，超过 9 位的数字截断），否则忽略小数部分
+    static inline bool parse_suffix(const char*& p, const char* end, bool& has_offset, int& offset_seconds,
+        long* nanoseconds = nullptr) {
+        has_offset = false;
+        offset_seconds = 0;
+        if (p < end && *p == '.') {
+            ++p;
+            const char* frac_begin = p;
+            long fraction = 0;
+            while (p < end && static_cast<unsigned>(*p - '0') < 10u) {
+                if (p - frac_begin < 9) {
+                    fraction = fraction * 10 + (*p - '0');
+                }
+                ++p;
+            }
+            if (p == frac_begin) {
+                return false;
+            }
+            for (long digits = static_cast<long>(p - frac_begin); digits < 9; ++digits) {
+                fraction *= 10;
+            }
+            if (nanoseconds != nullptr) {
+                *nanoseconds = fraction;
+            }
+        }
+        if (p < end) {
+            if (*p == 'Z') {
+                has_offset = true;
+                ++p;
+            }
+            else if (*p == '+' || *p == '-') {
+                const int sign = (*p == '-') ? -1 : 1;
+                ++p;
+                int oh = 0, om = 0;
+                if (!parse_digits(p, end, 2, 2, oh)) {
+                    return false;
+                }
+                const bool has_colon = (p < end && *p == ':');
+                if (has_colon) {
+                    ++p;
+                }
+                if ((has_colon || p < end) && !parse_digits(p, end, 2, 2, om)) {
+                    return false;
+                }
+                if (oh > 23 || om > 59) {
+                    return false;
+                }
+                has_offset = true;
+                offset_seconds = sign * (oh * 3600 + om * 60);
+            }
+        }
+        return p == end;
+    }
+
+    // 内置格式的手写解析器，不分配内存、不依赖 locale：
+    //   YYYY-M-D
+    //   YYYY-M-D H:M:S[.fffffffff]
+    //   YYYY-MM-DDTHH:MM:SS[.fffffffff][Z|±hh[:mm]|±hhmm]
+    // 各分量严格校验范围（不做 mktime 式的归一化）。date_only 时只解析日期，忽略其后内容，
+    // 与 sscanf(FORMAT_SHORT_DATE) 的行为一致。
+    static inline bool parse_builtin(const char* p, const char* end, bool date_only, time_t& utc,
+        long* nanoseconds = nullptr) {
+        if (nanoseconds != nullptr) {
+            *nanoseconds = 0;
+        }
+        int year = 0, month = 0, day = 0;
+        int hour = 0, minute = 0, second = 0;
+        if (!parse_digits(p, end, 4, 4, year) || p >= end || *p++ != '-'
+            || !parse_digits(p, end, 1, 2, month) || p >= end || *p++ != '-'
+            || !parse_digits(p, end, 1, 2, day)) {
+            return false;
+        }
+        if (month < 1 || month > 12 || day < 1 || day > CDMCivil::DaysInMonth(year, month)) {
+            return false;
+        }
+        bool has_offset = false;
+        int offset_seconds = 0;
+        if (!date_only && p < end) {
+            if (*p != ' ' && *p != 'T') {
+                return false;
+            }
+            ++p;
+            if (!parse_digits(p, end, 1, 2, hour) || p >= end || *p++ != ':'
+                || !parse_digits(p, end, 1, 2, minute) || p >= end || *p++ != ':'
+                || !parse_digits(p, end, 1, 2, second)) {
+                return false;
+            }
+            if (hour > 23 || minute > 59 || second > 59) {
+                return false;
+            }
+            if (!parse_suffix(p, end, has_offset, offset_seconds, nanoseconds)) {
+                return false;
+            }
+        }
+        const long long local = CDMCivil::DaysFromCivil(year, month, day) * CDMCivil::SECONDS_PER_DAY
+            + hour * 3600 + minute * 60 + second;
+        utc = has_offset ? static_cast<time_t>(local - offset_seconds) : local_seconds_to_utc(local);
+        return true;
+    }
+
+
+    // 批量换算时按本地日缓存偏移：一整个本地日偏移不变时，同日的行只需一次减法
+    struct LocalDayOffsetCache {
+        long long day = 0;
+        int offset = 0;
+        bool valid = false;
+        bool uniform = false;
+    };
+
+    static inline time_t local_seconds_to_utc_cached(long long local, LocalDayOffsetCache& cache) {
+        const long long day = CDMCivil::FloorDiv(local, CDMCivil::SECONDS_PER_DAY);
+        if (!cache.valid || cache.day != day) {
+            const long long begin = day * CDMCivil::SECONDS_PER_DAY;
+            const long long last = begin + CDMCivil::SECONDS_PER_DAY - 1;
+            const long long begin_offset = begin - local_seconds_to_utc(begin);
+            const long long last_offset = last - local_seconds_to_utc(last);
+            cache.day = day;
+            cache.offset = static_cast<int>(begin_offset);
+            cache.uniform = (begin_offset == last_offset);
+            cache.valid = true;
+        }
+        return cache.uniform ? static_cast<time_t>(local - cache.offset) : local_seconds_to_utc(local);
+    }
+
+    // 定宽行的后缀（第 19 字节之后）处理与时间戳换算
+    static inline bool finish_fixed_row(const char* row, size_t width, const DMDateTimeFields& f,
+        LocalDayOffsetCache& cache, time_t& utc) {
+        const long long local = CDMCivil::DaysFromCivil(f.year, f.month, f.day) * CDMCivil::SECONDS_PER_DAY
+            + f.hour * 3600 + f.minute * 60 + f.second;
+        if (width == static_cast<size_t>(CDMDateTimeSimd::FIXED_WIDTH)) {
+            utc = local_seconds_to_utc_cached(local, cache);
+            return true;
+        }
+        const char* p = row + CDMDateTimeSimd::FIXED_WIDTH;
+        bool has_offset = false;
+        int offset_seconds = 0;
+        if (!parse_suffix(p, row + width, has_offset, offset_seconds)) {
+            return false;
+        }
+        utc = has_offset ? static_cast<time_t>(local - offset_seconds) : local_seconds_to_utc_cached(local, cache);
+        return true;
+    }
+
+    template<typename RowAt>
+    static inline size_t parse_fixed_batch(RowAt row_at, size_t count, size_t width, time_t* out, bool* valid) {
+        size_t parsed = 0;
+        LocalDayOffsetCache cache;
+        auto emit = [&](size_t i, bool ok, const DMDateTimeFields& f) {
+            time_t utc = 0;
+            ok = ok && finish_fixed_row(row_at(i), width, f, cache, utc);
+            out[i] = ok ? utc : 0;
+            if (valid != nullptr) {
+                valid[i] = ok;
+            }
+            parsed += ok ? 1 : 0;
+        };
+        size_t i = 0;
+        DMDateTimeFields f0{};
+        if (width < static_cast<size_t>(CDMDateTimeSimd::FIXED_WIDTH)) {
+            for (; i < count; ++i) {
+                emit(i, false, f0);
+            }
+            return 0;
+        }
+#ifdef DMDATETIME_SIMD_X86
+        const int level = CDMDateTimeSimd::DetectLevel();
+        if (level >= CDMDateTimeSimd::SIMD_LEVEL_AVX2) {
+            DMDateTimeFields f1{};
+            for (; i + 2 <= count; i += 2) {
+                bool ok0 = false, ok1 = false;
+                CDMDateTimeSimd::ParseFixedAVX2x2(row_at(i), row_at(i + 1), f0, f1, ok0, ok1);
+                emit(i, ok0, f0);
+                emit(i + 1, ok1, f1);
+            }
+        }
+        if (level >= CDMDateTimeSimd::SIMD_LEVEL_SSE41) {
+            for (; i < count; ++i) {
+                emit(i, CDMDateTimeSimd::ParseFixedSSE41(row_at(i), f0), f0);
+            }
+        }
 #endif
-        return utc_tm;
+        for (; i < count; ++i) {
+            emit(i, CDMDateTimeSimd::ParseFixedScalar(row_at(i), f0), f0);
+        }
+        return parsed;
+    }
+
+    // 本地偏移及其不变的 UTC 区间 [run_begin, run_end)。有时区表时按切换区间返回；
+    // 走 libc 时退化为整个 UTC 日（首尾偏移相同）或单个时刻。
+    static inline int local_offset_run(time_t utc, long long& run_begin, long long& run_end) {
+        const CDMTimeZone* zone = local_zone_slot().load(std::memory_order_acquire);
+        if (zone != nullptr) {
+            int64_t begin = 0;
+            int64_t end = 0;
+            const int offset = zone->GetUTCOffsetRun(utc, begin, end);
+            run_begin = static_cast<long long>(begin);
+            run_end = static_cast<long long>(end);
+            return offset;
+        }
+        const long long day = CDMCivil::FloorDiv(static_cast<long long>(utc), CDMCivil::SECONDS_PER_DAY);
+        const long long day_begin = day * CDMCivil::SECONDS_PER_DAY;
+        const int begin_offset = libc_utc_offset(static_cast<time_t>(day_begin));
+        const int end_offset = libc_utc_offset(static_cast<time_t>(day_begin + CDMCivil::SECONDS_PER_DAY - 1));
+        if (begin_offset == end_offset) {
+            run_begin = day_begin;
+            run_end = day_begin + CDMCivil::SECONDS_PER_DAY;
+            return begin_offset;
+        }
+        run_begin = static_cast<long long>(utc);
+        run_end = run_begin + 1;
+        return libc_utc_offset(utc);
     }
 
+    enum { EXTRACT_BLOCK = 256 };
 
-public:
+    // 一个块的中间结果，按列存放，最后再窄化写入调用者的各列
+    struct ExtractBlock {
+        uint32_t year[EXTRACT_BLOCK];
+        uint32_t month[EXTRACT_BLOCK];
+        uint32_t day[EXTRACT_BLOCK];
+        uint32_t hour[EXTRACT_BLOCK];
+        uint32_t minute[EXTRACT_BLOCK];
+        uint32_t second[EXTRACT_BLOCK];
+        uint32_t wday[EXTRACT_BLOCK];
+        uint32_t yday[EXTRACT_BLOCK];
+    };
 
-    inline void SetDateTime(int year, int month, int day, int hour, int minute, int second) {
-        std::tm t{};
-        t.tm_year = year - 1900;
-        t.tm_mon = month - 1;
-        t.tm_mday = day;
-        t.tm_hour = hour;
-        t.tm_min = minute;
-        t.tm_sec = second;
-        t.tm_isdst = -1;
+    // 块内字段换算：Neri-Schneider 形式的 civil_from_days，全部是 32 位无符号运算，
+    // 无分支、除数均为常量，编译器可以向量化。
+    // shifted_days 为距公元 0 年 3 月 1 日的天数（days + 719468），second_of_day 在 [0, 86400)。
+    static inline void extract_block_narrow(const uint32_t* shifted_days, const int32_t* second_of_day, size_t n, ExtractBlock& b) {
+        for (size_t i = 0; i < n; ++i) {
+            const uint32_t z = shifted_days[i];
+            const uint32_t n1 = 4u * z + 3u;
+            const uint32_t century = n1 / 146097u;
+            const uint32_t n2 = (n1 % 146097u) | 3u;
+            const uint32_t year_of_century = n2 / 1461u;
+            const uint32_t doy = n2 % 1461u / 4u; // 以 3 月 1 日为 0
+            const uint32_t n3 = 2141u * doy + 197913u;
+            const uint32_t jan_feb = doy >= 306u ? 1u : 0u;
+            const uint32_t leap = year_of_century != 0u ? ((year_of_century & 3u) == 0u) : ((century & 3u) == 0u);
+            const uint32_t sod = static_cast<uint32_t>(second_of_day[i]);
+            b.year[i] = 100u * century + year_of_century + jan_feb;
+            b.month[i] = (n3 >> 16) - 12u * jan_feb;
+            b.day[i] = (((n3 & 0xFFFFu) * 31345u) >> 26) + 1u; // (n3 % 65536) / 2141
+            b.yday[i] = jan_feb ? doy - 305u : doy + 60u + leap;
+            b.wday[i] = (z + 3u) % 7u;
+            // 以下乘移位在各自输入范围内与整除精确相等（已穷举验证）
+            const uint32_t hour = (sod * 37283u) >> 27;          // sod / 3600, sod < 86400
+            const uint32_t rem = sod - hour * 3600u;
+            const uint32_t minute = (rem * 2185u) >> 17;         // rem / 60, rem < 3600
+            b.hour[i] = hour;
+            b.minute[i] = minute;
+            b.second[i] = rem - minute * 60u;
+        }
+    }
 
-        time_t_value_ = std::mktime(&t);
-        if (time_t_value_ == static_cast<time_t>(-1)) {
-            throw std::runtime_error("Invalid date/time components that mktime could not normalize or represent.");
+    // 超出 32 位快速路径的块（公元 0 年以前或年份超出 int16）逐个走 64 位引擎
+    static inline void extract_block_wide(const int64_t* days, const int32_t* second_of_day, size_t n, ExtractBlock& b) {
+        for (size_t i = 0; i < n; ++i) {
+            const DMCivilDate date = CDMCivil::CivilFromDays(days[i]);
+            const int sod = second_of_day[i];
+            b.year[i] = static_cast<uint32_t>(date.year);
+            b.month[i] = static_cast<uint32_t>(date.month);
+            b.day[i] = static_cast<uint32_t>(date.day);
+            b.yday[i] = static_cast<uint32_t>(CDMCivil::DayOfYear(days[i], date.year));
+            b.wday[i] = static_cast<uint32_t>(CDMCivil::WeekdayFromDays(days[i]));
+            b.hour[i] = static_cast<uint32_t>(sod / 3600);
+            b.minute[i] = static_cast<uint32_t>(sod % 3600 / 60);
+            b.second[i] = static_cast<uint32_t>(sod % 60);
         }
     }
 
+    template<typename T>
+    static inline void store_column(T* column, const uint32_t* values, size_t n) {
+        if (column == nullptr) {
+            return;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            column[i] = static_cast<T>(values[i]);
+        }
+    }
+
+public:
+
+    inline void SetDateTime(int year, int month, int day, int hour, int minute, int second) {
+        time_t_value_ = local_seconds_to_utc(CDMCivil::SecondsFromCivil(year, month, day, hour, minute, second));
+        fields_cache_.store(0, std::memory_order_relaxed);
+    }
+
     inline void SetDate(int year, int month, int day) {
         std::tm t_current = to_tm_local();
         SetDateTime(year, month, day, t_current.tm_hour, t_current.tm_min, t_current.tm_sec);
@@ -126,11 +761,148 @@ private:
     explicit CDMDateTime(time_t t_val) : time_t_value_(t_val) {}
 
 public:
+    // 指定 CDMDateTime 使用的本地时区。传入 CDMTimeZone::Get()/Local() 得到的时区后，
+    // 所有本地时间换算都走内置 TZif 表，不再进入 libc 的 localtime_r 及其全局锁；
+    // 传 nullptr 恢复使用 libc。修改 TZ 环境变量后也应调用一次以刷新缓存。
+    static void SetLocalTimeZone(const CDMTimeZone* zone) {
+        local_zone_slot().store(zone, std::memory_order_release);
+        local_zone_generation().fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    static const CDMTimeZone* GetLocalTimeZone() {
+        return local_zone_slot().load(std::memory_order_acquire);
+    }
+
+    // 无锁换算模式：用内置时区引擎加载进程本地时区（$TZ 或 /etc/localtime）并设为本地时区，
+    // 此后 getter、构造、解析都不再调用 localtime_r/mktime，多线程下不再被 glibc 的时区锁串行化。
+    // 时区文件无法加载时保持原状并返回 false。
+    static bool EnableLockFreeConversion() {
+        try {
+            SetLocalTimeZone(CDMTimeZone::Local());
+            return true;
+        }
+        catch (const std::exception&) {
+            return false;
+        }
+    }
+
+    static void DisableLockFreeConversion() {
+        SetLocalTimeZone(nullptr);
+    }
+
+    static bool IsLockFreeConversion() {
+        return GetLocalTimeZone() != nullptr;
+    }
+
+    // 使用 CDMClock::GetDefaultSource() 指定的时钟（默认 std::time）
     static CDMDateTime Now() {
-        return CDMDateTime(std::time(nullptr));
+        return CDMDateTime(CDMClock::NowSeconds(CDMClock::GetDefaultSource()));
+    }
+
+    // 在调用点指定时钟，例如高频打点用 CDMClock::CLOCK_SOURCE_REALTIME_COARSE
+    static CDMDateTime Now(CDMClock::ClockSource source) {
+        return CDMDateTime(CDMClock::NowSeconds(source));
+    }
+
+    // 解析内置格式（FORMAT_STANDARD / FORMAT_SHORT_DATE / ISO 8601，见 parse_builtin），
+    // 不抛异常、不分配内存。带 'Z' 或 ±hh:mm 后缀时按指定偏移换算，否则按本地时间。
+    inline static bool TryParse(const char* str, size_t length, CDMDateTime& result) {
+        time_t utc = 0;
+        if (str == nullptr || !parse_builtin(str, str + length, false, utc)) {
+            return false;
+        }
+        result = CDMDateTime(utc);
+        return true;
+    }
+
+    inline static bool TryParse(std::string_view str, CDMDateTime& result) {
+        return TryParse(str.data(), str.size(), result);
+    }
+
+    inline static CDMDateTime Parse(const char* str, size_t length) {
+        CDMDateTime result(static_cast<time_t>(0));
+        if (!TryParse(str, length, result)) {
+            throw std::runtime_error("Failed to parse date/time: '" + std::string(str ? str : "", str ? length : 0) + "'");
+        }
+        return result;
+    }
+
+    // 批量解析定宽时间戳："YYYY-MM-DD HH:MM:SS"（或以 'T' 分隔），第 19 字节之后可带
+    // 与 TryParse 相同的后缀（.fff、Z、±hh:mm），所有行宽度均为 width。
+    // rows[i] 指向第 i 行，结果写入 out[i]；解析失败的行写 0，并在 valid[i]（可为 nullptr）中标记 false。
+    // 字段转换与校验在支持的 CPU 上走 SSE4.1/AVX2 内核。返回成功解析的行数。
+    inline static size_t ParseBatch(const char* const* rows, size_t count, size_t width, time_t* out, bool* valid = nullptr) {
+        return parse_fixed_batch([rows](size_t i) { return rows[i]; }, count, width, out, valid);
     }
 
-    inline static CDMDateTime Parse(const std::string& dateTimeStr, const std::string& sscanf_format = FORMAT_STANDARD) {
+    // 同 ParseBatch，输入为连续存放的定宽列，第 i 行起始于 column + i * stride（stride >= width）
+    inline static size_t ParseColumn(const char* column, size_t stride, size_t count, size_t width, time_t* out, bool* valid = nullptr) {
+        return parse_fixed_batch([column, stride](size_t i) { return column + i * stride; }, count, width, out, valid);
+    }
+
+    // 批量拆分时间戳的本地时间字段到列式数组（用于按年/月/日/小时分组统计）。
+    // 偏移按时区切换区间复用，同一区间内的时间戳只做加法；字段换算按块进行，可被向量化。
+    inline static void ExtractFields(const time_t* timestamps, size_t count, const DMDateTimeColumns& out) {
+        static const long long NARROW_MIN_DAYS = -719468;
+        static const long long NARROW_MAX_DAYS = CDMCivil::DaysFromCivil(32767, 12, 31);
+        int64_t days[EXTRACT_BLOCK];
+        uint32_t shifted_days[EXTRACT_BLOCK];
+        int32_t second_of_day[EXTRACT_BLOCK];
+        ExtractBlock block;
+        long long run_begin = 0;
+        long long run_end = 0;
+        int offset = 0;
+        for (size_t base = 0; base < count; base += EXTRACT_BLOCK) {
+            const size_t n = (count - base < static_cast<size_t>(EXTRACT_BLOCK)) ? count - base : static_cast<size_t>(EXTRACT_BLOCK);
+            bool narrow = true;
+            for (size_t i = 0; i < n; ++i) {
+                const long long t = static_cast<long long>(timestamps[base + i]);
+                if (t < run_begin || t >= run_end) {
+                    offset = local_offset_run(static_cast<time_t>(t), run_begin, run_end);
+                }
+                const long long local = t + offset;
+                const long long day = CDMCivil::FloorDiv(local, CDMCivil::SECONDS_PER_DAY);
+                narrow = narrow && day >= NARROW_MIN_DAYS && day <= NARROW_MAX_DAYS;
+                days[i] = static_cast<int64_t>(day);
+                shifted_days[i] = static_cast<uint32_t>(day - NARROW_MIN_DAYS);
+                second_of_day[i] = static_cast<int32_t>(local - day * CDMCivil::SECONDS_PER_DAY);
+            }
+            if (narrow) {
+                extract_block_narrow(shifted_days, second_of_day, n, block);
+            }
+            else {
+                extract_block_wide(days, second_of_day, n, block);
+            }
+            store_column(out.year == nullptr ? nullptr : out.year + base, block.year, n);
+            store_column(out.month == nullptr ? nullptr : out.month + base, block.month, n);
+            store_column(out.day == nullptr ? nullptr : out.day + base, block.day, n);
+            store_column(out.hour == nullptr ? nullptr : out.hour + base, block.hour, n);
+            store_column(out.minute == nullptr ? nullptr : out.minute + base, block.minute, n);
+            store_column(out.second == nullptr ? nullptr : out.second + base, block.second, n);
+            store_column(out.day_of_week == nullptr ? nullptr : out.day_of_week + base, block.wday, n);
+            store_column(out.day_of_year == nullptr ? nullptr : out.day_of_year + base, block.yday, n);
+        }
+    }
+
+    // 单参数版本避免默认格式参数每次构造 std::string
+    inline static CDMDateTime Parse(const std::string& dateTimeStr) {
+        time_t utc = 0;
+        if (parse_builtin(dateTimeStr.data(), dateTimeStr.data() + dateTimeStr.size(), false, utc)) {
+            return CDMDateTime(utc);
+        }
+        return Parse(dateTimeStr, std::string(FORMAT_STANDARD));
+    }
+
+    inline static CDMDateTime Parse(const std::string& dateTimeStr, const std::string& sscanf_format) {
+        // 内置格式先走手写解析器，不合法（如两位年份、越界分量）时再交给 sscanf + 归一化兜底
+        const bool is_standard = (sscanf_format == FORMAT_STANDARD);
+        if (is_standard || sscanf_format == FORMAT_SHORT_DATE) {
+            time_t utc = 0;
+            if (parse_builtin(dateTimeStr.data(), dateTimeStr.data() + dateTimeStr.size(), !is_standard, utc)) {
+                return CDMDateTime(utc);
+            }
+        }
+
         int year = 0, month = 0, day = 0;
         int hour = 0, minute = 0, second = 0;
 
@@ -148,7 +920,7 @@ public:
 
         if (day == 0 && fields_scanned >= 3) day = 1;
 
-        CDMDateTime resultDt; // Default constructor will init to now, but SetDateTime will override
+        CDMDateTime resultDt(static_cast<time_t>(0));
         resultDt.SetDateTime(year, month, day, hour, minute, second);
         return resultDt;
     }
@@ -184,99 +956,130 @@ public:
     static const char* TO_STRING_SHORT_DATE_CN;
     static const int DMDATETIME_YEAR_MAX;
     static const int DMDATETIME_YEAR_MIN;
-    CDMDateTime() : time_t_value_(std::time(nullptr)) {}
+    CDMDateTime() : time_t_value_(CDMClock::NowSeconds(CDMClock::GetDefaultSource())) {}
+
+    CDMDateTime(const CDMDateTime& other)
+        : time_t_value_(other.time_t_value_), fields_cache_(other.fields_cache_.load(std::memory_order_relaxed)) {}
+
+    CDMDateTime& operator=(const CDMDateTime& other) {
+        time_t_value_ = other.time_t_value_;
+        fields_cache_.store(other.fields_cache_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        return *this;
+    }
 
     CDMDateTime(int year, int month, int day, int hour = 0, int minute = 0, int second = 0) {
         SetDateTime(year, month, day, hour, minute, second);
     }
 
-    inline std::string ToString(const std::string& format_string = TO_STRING_STANDARD) const {
-        char buffer[128] = { 0 };
-        std::tm t_local = to_tm_local();
-        std::snprintf(buffer, sizeof(buffer), format_string.c_str(),
-            t_local.tm_year + 1900,
-            t_local.tm_mon + 1,
-            t_local.tm_mday,
-            t_local.tm_hour,
-            t_local.tm_min,
-            t_local.tm_sec
-        );
-        return std::string(buffer);
+    inline std::string ToString() const {
+        char buffer[128];
+        return std::string(buffer, format_local(buffer, sizeof(buffer), TO_STRING_STANDARD));
+    }
+
+    inline std::string ToString(const std::string& format_string) const {
+        char buffer[128];
+        return std::string(buffer, format_local(buffer, sizeof(buffer), format_string.c_str()));
     }
 
     inline std::string ToUTCString() const {
-        char buffer[128] = { 0 };
-        std::tm t_utc_val = to_tm_utc();
         // 使用 ISO 8601 标准UTC格式，以 'Z' 结尾
-        std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", &t_utc_val);
-        return std::string(buffer);
+        char buffer[64];
+        return std::string(buffer, format_utc(buffer));
     }
 
     inline std::string ToISOString() const {
-        // 1. 获取本地时间各组件
-        std::tm t_local = to_tm_local();
-
-        // 2. 计算本地时间与UTC时间的偏移量（秒）
-        // 必须复制一份，因为 timegm_custom 可能会修改 tm 结构
-        std::tm t_local_for_calc = t_local;
-
-        std::time_t local_as_utc_ts = timegm_custom(&t_local_for_calc);
-        std::time_t original_utc_ts = GetTimestamp();
-
-        // 使用 int 来存储偏移量，足够且可移植
-        int offset_seconds = static_cast<int>(std::difftime(original_utc_ts, local_as_utc_ts));
-
-        // 3. 将偏移量秒数格式化为 ±hh:mm
-        char offset_buf[12] = { 0 };
-        int offset_hours = offset_seconds / 3600;
-        int offset_minutes = (std::abs(offset_seconds) % 3600) / 60;
-        // 使用 %d 和 %02d 来匹配 int 类型
-        std::snprintf(offset_buf, sizeof(offset_buf), "%+03d:%02d", offset_hours, offset_minutes);
-
-        // 4. 组合成最终的ISO 8601字符串
-        char buffer[128] = { 0 };
-        std::snprintf(buffer, sizeof(buffer), "%04d-%02d-%02dT%02d:%02d:%02d%s",
-            t_local.tm_year + 1900,
-            t_local.tm_mon + 1,
-            t_local.tm_mday,
-            t_local.tm_hour,
-            t_local.tm_min,
-            t_local.tm_sec,
-            offset_buf
-        );
-        return std::string(buffer);
-    }
-    inline int GetYear() const { return to_tm_local().tm_year + 1900; }
-    inline int GetMonth() const { return to_tm_local().tm_mon + 1; }
-    inline int GetDay() const { return to_tm_local().tm_mday; }
-    inline int GetHour() const { return to_tm_local().tm_hour; }
-    inline int GetMinute() const { return to_tm_local().tm_min; }
-    inline int GetSecond() const { return to_tm_local().tm_sec; }
-    inline int GetDayOfWeek() const { return to_tm_local().tm_wday; } // 0=Sunday, 6=Saturday
-    inline int GetDayOfYear() const { return to_tm_local().tm_yday + 1; } // tm_yday is 0-365
+        char buffer[64];
+        return std::string(buffer, format_iso(buffer));
+    }
+
+    // 以下重载写入调用者提供的缓冲区（末尾补 '\0'），不做任何堆分配。
+    // 返回写入的字节数（不含 '\0'）；容量不足时写空串并返回 0。
+    // 标准格式最长 19 字节，ToUTCString 20 字节，ToISOString 25 字节。
+    inline size_t ToString(char* buffer, size_t capacity, const char* format = TO_STRING_STANDARD) const {
+        char scratch[128];
+        return finish_buffer(buffer, capacity, scratch, format_local(scratch, sizeof(scratch), format));
+    }
+
+    inline size_t ToUTCString(char* buffer, size_t capacity) const {
+        char scratch[64];
+        return finish_buffer(buffer, capacity, scratch, format_utc(scratch));
+    }
+
+    inline size_t ToISOString(char* buffer, size_t capacity) const {
+        char scratch[64];
+        return finish_buffer(buffer, capacity, scratch, format_iso(scratch));
+    }
+
+    // 追加到已有字符串末尾，复用其容量；返回追加的字节数
+    inline size_t AppendString(std::string& out, const char* format = TO_STRING_STANDARD) const {
+        char scratch[128];
+        const size_t n = format_local(scratch, sizeof(scratch), format);
+        out.append(scratch, n);
+        return n;
+    }
+
+    inline size_t AppendUTCString(std::string& out) const {
+        char scratch[64];
+        const size_t n = format_utc(scratch);
+        out.append(scratch, n);
+        return n;
+    }
+
+    inline size_t AppendISOString(std::string& out) const {
+        char scratch[64];
+        const size_t n = format_iso(scratch);
+        out.append(scratch, n);
+        return n;
+    }
+
+    inline int GetYear() const {
+        const int v = cached_field(FIELD_YEAR_SHIFT, 16);
+        return v >= 0 ? v - 32768 : CDMCivil::CivilFromDays(local_days()).year;
+    }
+    inline int GetMonth() const {
+        const int v = cached_field(FIELD_MONTH_SHIFT, 4);
+        return v >= 0 ? v : CDMCivil::CivilFromDays(local_days()).month;
+    }
+    inline int GetDay() const {
+        const int v = cached_field(FIELD_DAY_SHIFT, 5);
+        return v >= 0 ? v : CDMCivil::CivilFromDays(local_days()).day;
+    }
+    inline int GetHour() const {
+        const int v = cached_field(FIELD_HOUR_SHIFT, 5);
+        return v >= 0 ? v : local_second_of_day() / 3600;
+    }
+    inline int GetMinute() const {
+        const int v = cached_field(FIELD_MINUTE_SHIFT, 6);
+        return v >= 0 ? v : local_second_of_day() / 60 % 60;
+    }
+    inline int GetSecond() const {
+        const int v = cached_field(FIELD_SECOND_SHIFT, 6);
+        return v >= 0 ? v : local_second_of_day() % 60;
+    }
+    inline int GetDayOfWeek() const { // 0=Sunday, 6=Saturday
+        const int v = cached_field(FIELD_WDAY_SHIFT, 3);
+        return v >= 0 ? v : CDMCivil::WeekdayFromDays(local_days());
+    }
+    inline int GetDayOfYear() const { // 1-366
+        const int v = cached_field(FIELD_YDAY_SHIFT, 9);
+        if (v >= 0) {
+            return v + 1;
+        }
+        const long long days = local_days();
+        return CDMCivil::DayOfYear(days, CDMCivil::CivilFromDays(days).year);
+    }
 
     inline CDMDateTime AddYears(int years) const {
-        std::tm t = to_tm_local();
-        t.tm_year += years;
-        t.tm_isdst = -1;
-        time_t tt = mktime(&t);
-        if (tt == static_cast<time_t>(-1)) throw std::runtime_error("Resulting date out of range after AddYears");
-        return CDMDateTime(tt);
+        return AddMonths(years * 12);
     }
 
     inline CDMDateTime AddMonths(int months) const {
-        std::tm t = to_tm_local();
-        int new_month_tm = t.tm_mon + months;
-        t.tm_year += new_month_tm / 12;
-        t.tm_mon = new_month_tm % 12;
-        if (t.tm_mon < 0) {
-            t.tm_mon += 12;
-            t.tm_year--;
-        }
-        t.tm_isdst = -1;
-        time_t tt = mktime(&t);
-        if (tt == static_cast<time_t>(-1)) throw std::runtime_error("Resulting date out of range after AddMonths");
-        return CDMDateTime(tt);
+        const long long days = local_days();
+        const long long sod = local_seconds() - days * CDMCivil::SECONDS_PER_DAY;
+        const DMCivilDate date = CDMCivil::CivilFromDays(days);
+        // 与原 mktime 实现一致：日不做截断，1月31日加一个月归一化为3月初
+        const long long target = CDMCivil::DaysFromCivilNormalized(date.year, static_cast<long long>(date.month) + months, date.day);
+        return CDMDateTime(local_seconds_to_utc(target * CDMCivil::SECONDS_PER_DAY + sod));
     }
 
     inline CDMDateTime AddDays(long long days) const {
@@ -314,6 +1117,30 @@ public:
     bool operator==(const CDMDateTime& other) const { return time_t_value_ == other.time_t_value_; }
     bool operator!=(const CDMDateTime& other) const { return time_t_value_ != other.time_t_value_; }
 
+    // 按本地时间向下对齐到 span 的整数倍（以本地 1970-01-01 00:00 为原点，FloorTo(1 天) 即当天零点）。
+    // 夏令时切换使对齐点重复或不存在时，保证结果不晚于自身。span 必须为正，否则抛出 std::runtime_error
+    inline CDMDateTime FloorTo(const CDMTimeSpan& span) const {
+        const long long width = positive_span(span);
+        const long long local = local_seconds();
+        const long long remainder = CDMCivil::FloorMod(local, width);
+        if (remainder == 0) {
+            return *this;
+        }
+        const time_t result = local_seconds_to_utc(local - remainder);
+        return CDMDateTime(result <= time_t_value_ ? result : static_cast<time_t>(time_t_value_ - remainder));
+    }
+    // 按本地时间向上对齐到 span 的整数倍，已对齐时返回自身
+    inline CDMDateTime CeilTo(const CDMTimeSpan& span) const {
+        const long long width = positive_span(span);
+        const long long local = local_seconds();
+        const long long remainder = CDMCivil::FloorMod(local, width);
+        if (remainder == 0) {
+            return *this;
+        }
+        const time_t result = local_seconds_to_utc(local - remainder + width);
+        return CDMDateTime(result > time_t_value_ ? result : static_cast<time_t>(time_t_value_ - remainder + width));
+    }
+
     inline CDMDateTime GetStartOfDay() const {
         std::tm t = to_tm_local();
         return CDMDateTime(t.tm_year + 1900, t.tm_mon + 1, t.tm_mday, 0, 0, 0);
@@ -338,6 +1165,16 @@ public:
             return startOfNextMonth.AddSeconds(-1);
         }
     }
+    // 本周第一天的 00:00，firstDayOfWeek 为一周的第一天（0=周日，默认 1=周一）
+    inline CDMDateTime GetStartOfWeek(int firstDayOfWeek = 1) const {
+        const long long days = local_days();
+        const DMCivilDate date = CDMCivil::CivilFromDays(days - CDMCivil::FloorMod(CDMCivil::WeekdayFromDays(days) - firstDayOfWeek, 7));
+        return CDMDateTime(date.year, date.month, date.day, 0, 0, 0);
+    }
+    inline CDMDateTime GetStartOfQuarter() const {
+        std::tm t = to_tm_local();
+        return CDMDateTime(t.tm_year + 1900, t.tm_mon / 3 * 3 + 1, 1, 0, 0, 0);
+    }
     inline CDMDateTime GetStartOfYear() const {
         std::tm t = to_tm_local();
         return CDMDateTime(t.tm_year + 1900, 1, 1, 0, 0, 0);
@@ -371,8 +1208,64 @@ public:
         return checkUpper;
     }
 
+    // 本地日期对应的农历日期，超出 1900-01-31 至 2101-01-28 时返回 false
+    inline bool GetLunarDate(DMLunarDate& lunar) const {
+        return CDMLunarCalendar::FromDays(local_days(), lunar);
+    }
+
+    // 传统写法的农历日期，例如 "甲辰年冬月廿五"；超出农历表范围返回空串
     inline std::string ToLunarString() const {
-        return "农历支持未实现 (Lunar support not implemented)";
+        DMLunarDate lunar{};
+        return GetLunarDate(lunar) ? CDMLunarCalendar::ToChineseString(lunar) : std::string();
+    }
+
+    // 数字写法的农历日期，例如 "2024-11-25"，闰月为 "2025-L06-01"；超出范围返回空串
+    inline std::string ToLunarNumericString() const {
+        DMLunarDate lunar{};
+        return GetLunarDate(lunar) ? CDMLunarCalendar::ToNumericString(lunar) : std::string();
+    }
+
+    // 农历日期 + 本地时分秒 -> CDMDateTime，日期不存在时抛出 std::runtime_error
+    inline static CDMDateTime FromLunar(int year, int month, int day, bool is_leap_month = false,
+        int hour = 0, int minute = 0, int second = 0) {
+        long long days = 0;
+        if (!CDMLunarCalendar::ToDays(DMLunarDate{ year, month, day, is_leap_month }, days)) {
+            throw std::runtime_error("Invalid lunar date.");
+        }
+        return CDMDateTime(local_seconds_to_utc(days * CDMCivil::SECONDS_PER_DAY + hour * 3600LL + minute * 60LL + second));
+    }
+
+    // 本地日期当天交节的节气（CDMSolarTerm::Term），当天不交节或超出 1900-2100 年时返回 -1
+    inline int GetSolarTerm() const {
+        const long long days = local_days();
+        const DMCivilDate date = CDMCivil::CivilFromDays(days);
+        if (!CDMSolarTerm::IsYearInRange(date.year)) {
+            return -1;
+        }
+        // 每月只有两个节气，查表后比较本地日期即可
+        for (int term = (date.month - 1) * 2; term < date.month * 2; ++term) {
+            const CDMDateTime when(static_cast<time_t>(CDMSolarTerm::Timestamp(date.year, term)));
+            if (when.local_days() == days) {
+                return term;
+            }
+        }
+        return -1;
+    }
+
+    // 当天节气的名称，例如 "冬至"；当天不交节返回空串
+    inline std::string GetSolarTermName() const {
+        return CDMSolarTerm::GetName(GetSolarTerm());
+    }
+
+    // 严格晚于当前时刻的下一个节气及其交节时刻，超出节气表范围返回 false
+    inline bool GetNextSolarTerm(int& term, CDMDateTime& when) const {
+        int year = 0;
+        long long timestamp = 0;
+        if (!CDMSolarTerm::Next(time_t_value_, year, term, timestamp)) {
+            return false;
+        }
+        when = CDMDateTime(static_cast<time_t>(timestamp));
+        return true;
     }
 
     // ----- 新增接口 -----
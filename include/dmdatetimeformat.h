@@ -0,0 +1,842 @@
+﻿// Copyright (c) 2018 brinkqiang (brink.qiang@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __DMDATETIMEFORMAT_H__
+#define __DMDATETIMEFORMAT_H__
+
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "dmdatetime.h"
+#include "dmprecisetime.h"
+
+// strftime 风格的命名字段格式。CDMFixedFormat 在编译期解释模式串，CDMDateTimeFormat 在运行时
+// 把模式串预编译为操作码序列，二者的字段语义与读写代码相同：
+//   %Y 四位年  %m 月  %d 日  %H 时  %M 分  %S 秒（均为两位）  %j 年内第几天（三位）
+//   %f 微秒（六位；解析时读 1-9 位小数）  %z 偏移 +hhmm（解析时另接受 Z、+hh、+hh:mm）
+//   %a 星期缩写 Sun..Sat  %b 月份缩写 Jan..Dec  %% 字面的 '%'
+// 其余字符原样输出/逐字匹配。格式化为本地时间，所有字段定宽，因此输出长度固定；
+// 解析与格式化对称（数字字段必须写满位数），未出现的字段取 1970-01-01 00:00:00，
+// 带 %z 时按给出的偏移换算，否则按本地时间。
+
+struct DMFormatOp {
+    uint8_t code;     // CDMFormatPattern::OpCode
+    char suffix;      // 字段：紧随其后的单个字面字符（如分隔符），0 表示无；由 CDMDateTimeFormat 合并而来
+    uint16_t offset;  // OP_LITERAL：在模式串中的起始位置
+    uint16_t length;  // OP_LITERAL：字节数；字段：格式化输出的宽度（不含 suffix）
+};
+
+struct DMFormatProgram {
+    enum { MAX_OPS = 64 };
+    DMFormatOp ops[MAX_OPS];
+    size_t count;
+    size_t length;        // 格式化输出的字节数
+    unsigned fields;      // 出现过的字段，1 << OpCode
+    int error;            // CDMFormatPattern::PatternError
+    size_t error_offset;  // 出错位置（模式串下标）
+};
+
+// 格式化/解析时的本地时间分量
+struct DMFormatFields {
+    int year;
+    int month;        // 1-12
+    int day;          // 1-31
+    int hour;
+    int minute;
+    int second;
+    int day_of_week;  // 0=Sunday
+    int day_of_year;  // 1-366
+    int utc_offset;   // 秒，东八区为 +28800
+    long nanosecond;
+};
+
+class CDMFormatPattern {
+public:
+    enum OpCode {
+        OP_LITERAL = 0,
+        OP_YEAR,
+        OP_MONTH,
+        OP_DAY,
+        OP_HOUR,
+        OP_MINUTE,
+        OP_SECOND,
+        OP_FRACTION,
+        OP_UTC_OFFSET,
+        OP_WEEKDAY_NAME,
+        OP_MONTH_NAME,
+        OP_DAY_OF_YEAR,
+    };
+
+    enum PatternError {
+        PATTERN_OK = 0,
+        PATTERN_UNKNOWN_SPECIFIER,  // '%' 后不是受支持的字段
+        PATTERN_TRAILING_PERCENT,   // 以单个 '%' 结尾
+        PATTERN_TOO_LONG,           // 超过 DMFormatProgram::MAX_OPS 个操作或 65535 字节
+    };
+
+    static constexpr char STANDARD[] = "%Y-%m-%d %H:%M:%S";
+    static constexpr char SHORT_DATE[] = "%Y-%m-%d";
+
+    static constexpr unsigned FieldBit(int code) {
+        return 1u << code;
+    }
+
+    static constexpr int SpecifierCode(char c) {
+        switch (c) {
+        case 'Y': return OP_YEAR;
+        case 'm': return OP_MONTH;
+        case 'd': return OP_DAY;
+        case 'H': return OP_HOUR;
+        case 'M': return OP_MINUTE;
+        case 'S': return OP_SECOND;
+        case 'f': return OP_FRACTION;
+        case 'z': return OP_UTC_OFFSET;
+        case 'a': return OP_WEEKDAY_NAME;
+        case 'b': return OP_MONTH_NAME;
+        case 'j': return OP_DAY_OF_YEAR;
+        default: return -1;
+        }
+    }
+
+    static constexpr int FieldWidth(int code) {
+        switch (code) {
+        case OP_YEAR: return 4;
+        case OP_FRACTION: return 6;
+        case OP_UTC_OFFSET: return 5;
+        case OP_WEEKDAY_NAME:
+        case OP_MONTH_NAME:
+        case OP_DAY_OF_YEAR: return 3;
+        default: return 2;
+        }
+    }
+
+    // 从 pattern[pos] 起读取一个操作并前进 pos；相邻的普通字符合并为一个 OP_LITERAL
+    static constexpr int NextOp(const char* pattern, size_t& pos, DMFormatOp& op) {
+        if (pattern[pos] == '%') {
+            const char c = pattern[pos + 1];
+            if (c == '\0') {
+                return PATTERN_TRAILING_PERCENT;
+            }
+            if (c == '%') {
+                op = DMFormatOp{ static_cast<uint8_t>(OP_LITERAL), 0, static_cast<uint16_t>(pos + 1), 1 };
+                pos += 2;
+                return pos > 0xFFFF ? PATTERN_TOO_LONG : PATTERN_OK;
+            }
+            const int code = SpecifierCode(c);
+            if (code < 0) {
+                return PATTERN_UNKNOWN_SPECIFIER;
+            }
+            op = DMFormatOp{ static_cast<uint8_t>(code), 0, 0, static_cast<uint16_t>(FieldWidth(code)) };
+            pos += 2;
+            return PATTERN_OK;
+        }
+        const size_t begin = pos;
+        while (pattern[pos] != '\0' && pattern[pos] != '%') {
+            ++pos;
+        }
+        if (pos > 0xFFFF) {
+            return PATTERN_TOO_LONG;
+        }
+        op = DMFormatOp{ static_cast<uint8_t>(OP_LITERAL), 0, static_cast<uint16_t>(begin), static_cast<uint16_t>(pos - begin) };
+        return PATTERN_OK;
+    }
+
+    // 编译期可求值；出错时 error 非 PATTERN_OK，其余内容无意义
+    static constexpr DMFormatProgram Compile(const char* pattern) {
+        DMFormatProgram program{};
+        size_t pos = 0;
+        while (pattern[pos] != '\0') {
+            DMFormatOp op{};
+            const size_t at = pos;
+            int error = NextOp(pattern, pos, op);
+            if (error == PATTERN_OK && program.count == DMFormatProgram::MAX_OPS) {
+                error = PATTERN_TOO_LONG;
+            }
+            if (error != PATTERN_OK) {
+                program.error = error;
+                program.error_offset = at;
+                return program;
+            }
+            program.ops[program.count++] = op;
+            program.length += op.length;
+            program.fields |= op.code == OP_LITERAL ? 0u : FieldBit(op.code);
+        }
+        return program;
+    }
+
+    // 取格式化所需的本地时间分量；需要 %Y 而年份不在 0-9999 时返回 false
+    static inline bool LoadFields(const CDMDateTime& dt, unsigned fields, long nanosecond, DMFormatFields& f) {
+        const int offset = CDMDateTime::local_utc_offset(dt.time_t_value_);
+        const std::tm t = CDMDateTime::seconds_to_tm(static_cast<long long>(dt.time_t_value_) + offset);
+        if ((fields & FieldBit(OP_YEAR)) != 0 && !CDMDateTime::is_four_digit_year(t)) {
+            return false;
+        }
+        f.year = t.tm_year + 1900;
+        f.month = t.tm_mon + 1;
+        f.day = t.tm_mday;
+        f.hour = t.tm_hour;
+        f.minute = t.tm_min;
+        f.second = t.tm_sec;
+        f.day_of_week = t.tm_wday;
+        f.day_of_year = t.tm_yday + 1;
+        f.utc_offset = offset;
+        f.nanosecond = nanosecond;
+        return true;
+    }
+
+    // 解析前的初始值：月、日为 0 表示尚未出现，星期为 -1 表示不校验
+    static inline DMFormatFields ParseDefaults() {
+        return DMFormatFields{ 1970, 0, 0, 0, 0, 0, -1, 0, 0, 0 };
+    }
+
+    template<int Code>
+    static inline char* WriteField(char* p, const DMFormatFields& f) {
+        if constexpr (Code == OP_YEAR) {
+            p = CDMDateTime::write_2digits(p, f.year / 100);
+            return CDMDateTime::write_2digits(p, f.year % 100);
+        }
+        else if constexpr (Code == OP_MONTH) {
+            return CDMDateTime::write_2digits(p, f.month);
+        }
+        else if constexpr (Code == OP_DAY) {
+            return CDMDateTime::write_2digits(p, f.day);
+        }
+        else if constexpr (Code == OP_HOUR) {
+            return CDMDateTime::write_2digits(p, f.hour);
+        }
+        else if constexpr (Code == OP_MINUTE) {
+            return CDMDateTime::write_2digits(p, f.minute);
+        }
+        else if constexpr (Code == OP_SECOND) {
+            return CDMDateTime::write_2digits(p, f.second);
+        }
+        else if constexpr (Code == OP_FRACTION) {
+            const int microsecond = static_cast<int>(f.nanosecond / 1000);
+            p = CDMDateTime::write_2digits(p, microsecond / 10000);
+            p = CDMDateTime::write_2digits(p, microsecond / 100 % 100);
+            return CDMDateTime::write_2digits(p, microsecond % 100);
+        }
+        else if constexpr (Code == OP_UTC_OFFSET) {
+            const int abs_offset = f.utc_offset < 0 ? -f.utc_offset : f.utc_offset;
+            *p++ = f.utc_offset < 0 ? '-' : '+';
+            p = CDMDateTime::write_2digits(p, abs_offset / 3600);
+            return CDMDateTime::write_2digits(p, abs_offset % 3600 / 60);
+        }
+        else if constexpr (Code == OP_WEEKDAY_NAME) {
+            std::memcpy(p, weekday_names() + f.day_of_week * 3, 3);
+            return p + 3;
+        }
+        else if constexpr (Code == OP_MONTH_NAME) {
+            std::memcpy(p, month_names() + (f.month - 1) * 3, 3);
+            return p + 3;
+        }
+        else {
+            static_assert(Code == OP_DAY_OF_YEAR, "unknown format field");
+            *p++ = static_cast<char>('0' + f.day_of_year / 100);
+            return CDMDateTime::write_2digits(p, f.day_of_year % 100);
+        }
+    }
+
+    template<int Code>
+    static inline bool ReadField(const char*& p, const char* end, DMFormatFields& f) {
+        if constexpr (Code == OP_YEAR) {
+            return read_digits(p, end, 4, f.year);
+        }
+        else if constexpr (Code == OP_MONTH) {
+            int month = 0;
+            return read_digits(p, end, 2, month) && month >= 1 && month <= 12 && set_month(f, month);
+        }
+        else if constexpr (Code == OP_DAY) {
+            return read_digits(p, end, 2, f.day) && f.day >= 1 && f.day <= 31;
+        }
+        else if constexpr (Code == OP_HOUR) {
+            return read_digits(p, end, 2, f.hour) && f.hour <= 23;
+        }
+        else if constexpr (Code == OP_MINUTE) {
+            return read_digits(p, end, 2, f.minute) && f.minute <= 59;
+        }
+        else if constexpr (Code == OP_SECOND) {
+            return read_digits(p, end, 2, f.second) && f.second <= 59;
+        }
+        else if constexpr (Code == OP_FRACTION) {
+            const char* begin = p;
+            long fraction = 0;
+            while (p < end && static_cast<unsigned>(*p - '0') < 10u) {
+                if (p - begin < 9) {
+                    fraction = fraction * 10 + (*p - '0');
+                }
+                ++p;
+            }
+            for (long digits = static_cast<long>(p - begin); digits < 9; ++digits) {
+                fraction *= 10;
+            }
+            f.nanosecond = fraction;
+            return p != begin;
+        }
+        else if constexpr (Code == OP_UTC_OFFSET) {
+            if (p < end && *p == 'Z') {
+                ++p;
+                f.utc_offset = 0;
+                return true;
+            }
+            if (p == end || (*p != '+' && *p != '-')) {
+                return false;
+            }
+            const int sign = *p++ == '-' ? -1 : 1;
+            int hours = 0;
+            int minutes = 0;
+            if (!read_digits(p, end, 2, hours) || hours > 23) {
+                return false;
+            }
+            if (p < end && *p == ':') {
+                ++p;
+                if (!read_digits(p, end, 2, minutes)) {
+                    return false;
+                }
+            }
+            else if (end - p >= 2 && static_cast<unsigned>(p[0] - '0') < 10u && static_cast<unsigned>(p[1] - '0') < 10u) {
+                read_digits(p, end, 2, minutes);
+            }
+            f.utc_offset = sign * (hours * 3600 + minutes * 60);
+            return minutes <= 59;
+        }
+        else if constexpr (Code == OP_WEEKDAY_NAME) {
+            const int index = read_name(p, end, weekday_names(), 7);
+            f.day_of_week = index;
+            return index >= 0;
+        }
+        else if constexpr (Code == OP_MONTH_NAME) {
+            const int index = read_name(p, end, month_names(), 12);
+            return index >= 0 && set_month(f, index + 1);
+        }
+        else {
+            static_assert(Code == OP_DAY_OF_YEAR, "unknown format field");
+            return read_digits(p, end, 3, f.day_of_year) && f.day_of_year >= 1 && f.day_of_year <= 366;
+        }
+    }
+
+    // 运行时按操作码分派，pattern 为编译该操作时使用的模式串
+    static inline char* WriteOp(char* p, const DMFormatOp& op, const char* pattern, const DMFormatFields& f) {
+        switch (op.code) {
+        case OP_LITERAL:
+            if (op.length == 1) { // 分隔符多为单个字符，避免变长 memcpy 的函数调用
+                *p = pattern[op.offset];
+                return p + 1;
+            }
+            std::memcpy(p, pattern + op.offset, op.length);
+            return p + op.length;
+        case OP_YEAR: p = WriteField<OP_YEAR>(p, f); break;
+        case OP_MONTH: p = WriteField<OP_MONTH>(p, f); break;
+        case OP_DAY: p = WriteField<OP_DAY>(p, f); break;
+        case OP_HOUR: p = WriteField<OP_HOUR>(p, f); break;
+        case OP_MINUTE: p = WriteField<OP_MINUTE>(p, f); break;
+        case OP_SECOND: p = WriteField<OP_SECOND>(p, f); break;
+        case OP_FRACTION: p = WriteField<OP_FRACTION>(p, f); break;
+        case OP_UTC_OFFSET: p = WriteField<OP_UTC_OFFSET>(p, f); break;
+        case OP_WEEKDAY_NAME: p = WriteField<OP_WEEKDAY_NAME>(p, f); break;
+        case OP_MONTH_NAME: p = WriteField<OP_MONTH_NAME>(p, f); break;
+        default: p = WriteField<OP_DAY_OF_YEAR>(p, f); break;
+        }
+        if (op.suffix != '\0') {
+            *p++ = op.suffix;
+        }
+        return p;
+    }
+
+    static inline bool ReadOp(const char*& p, const char* end, const DMFormatOp& op, const char* pattern, DMFormatFields& f) {
+        bool ok = false;
+        switch (op.code) {
+        case OP_LITERAL:
+            if (op.length == 1) {
+                if (p == end || *p != pattern[op.offset]) {
+                    return false;
+                }
+                ++p;
+                return true;
+            }
+            if (static_cast<size_t>(end - p) < op.length || std::memcmp(p, pattern + op.offset, op.length) != 0) {
+                return false;
+            }
+            p += op.length;
+            return true;
+        case OP_YEAR: ok = ReadField<OP_YEAR>(p, end, f); break;
+        case OP_MONTH: ok = ReadField<OP_MONTH>(p, end, f); break;
+        case OP_DAY: ok = ReadField<OP_DAY>(p, end, f); break;
+        case OP_HOUR: ok = ReadField<OP_HOUR>(p, end, f); break;
+        case OP_MINUTE: ok = ReadField<OP_MINUTE>(p, end, f); break;
+        case OP_SECOND: ok = ReadField<OP_SECOND>(p, end, f); break;
+        case OP_FRACTION: ok = ReadField<OP_FRACTION>(p, end, f); break;
+        case OP_UTC_OFFSET: ok = ReadField<OP_UTC_OFFSET>(p, end, f); break;
+        case OP_WEEKDAY_NAME: ok = ReadField<OP_WEEKDAY_NAME>(p, end, f); break;
+        case OP_MONTH_NAME: ok = ReadField<OP_MONTH_NAME>(p, end, f); break;
+        default: ok = ReadField<OP_DAY_OF_YEAR>(p, end, f); break;
+        }
+        if (!ok || op.suffix == '\0') {
+            return ok;
+        }
+        if (p == end || *p != op.suffix) {
+            return false;
+        }
+        ++p;
+        return true;
+    }
+
+    // 把解析出的分量换算为 UTC 时间戳；fields 为模式中出现过的字段。
+    // 日期不存在、%j 或 %a 与年月日矛盾时返回 false
+    static inline bool StoreFields(DMFormatFields& f, unsigned fields, time_t& utc) {
+        if (f.day_of_year != 0) {
+            if (f.day_of_year > (CDMCivil::IsLeapYear(f.year) ? 366 : 365)) {
+                return false;
+            }
+            const DMCivilDate date = CDMCivil::CivilFromDays(CDMCivil::DaysFromCivil(f.year, 1, 1) + f.day_of_year - 1);
+            if ((f.month != 0 && f.month != date.month) || (f.day != 0 && f.day != date.day)) {
+                return false;
+            }
+            f.month = date.month;
+            f.day = date.day;
+        }
+        f.month = f.month == 0 ? 1 : f.month;
+        f.day = f.day == 0 ? 1 : f.day;
+        if (f.day > CDMCivil::DaysInMonth(f.year, f.month)) {
+            return false;
+        }
+        const long long days = CDMCivil::DaysFromCivil(f.year, f.month, f.day);
+        if (f.day_of_week >= 0 && CDMCivil::WeekdayFromDays(days) != f.day_of_week) {
+            return false;
+        }
+        const long long local = days * CDMCivil::SECONDS_PER_DAY + f.hour * 3600 + f.minute * 60 + f.second;
+        utc = (fields & FieldBit(OP_UTC_OFFSET)) != 0 ? static_cast<time_t>(local - f.utc_offset)
+                                                      : CDMDateTime::local_seconds_to_utc(local);
+        return true;
+    }
+
+    // 亚秒时间点：秒数超出 TicksPerSecond 下 int64 的表示范围时返回 false
+    template<long long TicksPerSecond>
+    static inline bool StoreTicks(time_t utc, long nanosecond, CDMBasicDateTime<TicksPerSecond>& result) {
+        const long long limit = INT64_MAX / TicksPerSecond - 1;
+        if (static_cast<long long>(utc) > limit || static_cast<long long>(utc) < -limit) {
+            return false;
+        }
+        result = CDMBasicDateTime<TicksPerSecond>::FromTimestamp(utc,
+            CDMPreciseTicks::Convert(nanosecond, 1000000000LL, TicksPerSecond));
+        return true;
+    }
+
+private:
+    static inline const char* weekday_names() {
+        return "SunMonTueWedThuFriSat";
+    }
+
+    static inline const char* month_names() {
+        return "JanFebMarAprMayJunJulAugSepOctNovDec";
+    }
+
+    static inline bool read_digits(const char*& p, const char* end, int count, int& value) {
+        if (end - p < count) {
+            return false;
+        }
+        int v = 0;
+        for (int i = 0; i < count; ++i) {
+            const unsigned digit = static_cast<unsigned>(p[i] - '0');
+            if (digit > 9) {
+                return false;
+            }
+            v = v * 10 + static_cast<int>(digit);
+        }
+        p += count;
+        value = v;
+        return true;
+    }
+
+    static inline int read_name(const char*& p, const char* end, const char* names, int count) {
+        if (end - p < 3) {
+            return -1;
+        }
+        for (int i = 0; i < count; ++i) {
+            if (std::memcmp(p, names + i * 3, 3) == 0) {
+                p += 3;
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    // %m 与 %b 可同时出现，但必须一致
+    static inline bool set_month(DMFormatFields& f, int month) {
+        if (f.month != 0 && f.month != month) {
+            return false;
+        }
+        f.month = month;
+        return true;
+    }
+};
+
+// 编译期特化的格式：模式串作为模板参数，在编译期拆成定长的字段读写序列，运行时不再解释模式串。
+// 非法模式在编译期报错。C++17 不支持字符串字面量作模板参数，模式串需是具名的 constexpr 字符数组：
+//
+//   static constexpr char LOG_FORMAT[] = "%Y-%m-%dT%H:%M:%S.%f%z";
+//   typedef CDMFixedFormat<LOG_FORMAT> CDMLogFormat;
+//   std::string text = CDMLogFormat::ToString(dt);         // 长度恒为 CDMLogFormat::LENGTH
+//   CDMDateTime parsed = CDMLogFormat::Parse(text);
+template<const char* Pattern>
+class CDMFixedFormat {
+    static constexpr DMFormatProgram PROGRAM = CDMFormatPattern::Compile(Pattern);
+    static_assert(PROGRAM.error != CDMFormatPattern::PATTERN_UNKNOWN_SPECIFIER,
+        "date/time format: unsupported conversion after '%' (expected one of Y m d H M S f z a b j %)");
+    static_assert(PROGRAM.error != CDMFormatPattern::PATTERN_TRAILING_PERCENT, "date/time format: pattern ends with a lone '%'");
+    static_assert(PROGRAM.error != CDMFormatPattern::PATTERN_TOO_LONG, "date/time format: pattern is too long");
+
+    template<size_t I>
+    static inline char* write_op(char* p, const DMFormatFields& f) {
+        constexpr DMFormatOp op = PROGRAM.ops[I];
+        if constexpr (op.code == CDMFormatPattern::OP_LITERAL) {
+            std::memcpy(p, Pattern + op.offset, op.length);
+            return p + op.length;
+        }
+        else {
+            return CDMFormatPattern::WriteField<op.code>(p, f);
+        }
+    }
+
+    template<size_t I>
+    static inline bool read_op(const char*& p, const char* end, DMFormatFields& f) {
+        constexpr DMFormatOp op = PROGRAM.ops[I];
+        if constexpr (op.code == CDMFormatPattern::OP_LITERAL) {
+            if (static_cast<size_t>(end - p) < op.length || std::memcmp(p, Pattern + op.offset, op.length) != 0) {
+                return false;
+            }
+            p += op.length;
+            return true;
+        }
+        else {
+            return CDMFormatPattern::ReadField<op.code>(p, end, f);
+        }
+    }
+
+    template<size_t... I>
+    static inline char* write_ops(char* p, const DMFormatFields& f, std::index_sequence<I...>) {
+        ((p = write_op<I>(p, f)), ...);
+        return p;
+    }
+
+    template<size_t... I>
+    static inline bool read_ops(const char*& p, const char* end, DMFormatFields& f, std::index_sequence<I...>) {
+        return (read_op<I>(p, end, f) && ...);
+    }
+
+    static inline size_t write(const CDMDateTime& dt, long nanosecond, char* out) {
+        DMFormatFields f;
+        if (!CDMFormatPattern::LoadFields(dt, PROGRAM.fields, nanosecond, f)) {
+            return 0;
+        }
+        return static_cast<size_t>(write_ops(out, f, std::make_index_sequence<PROGRAM.count>()) - out);
+    }
+
+    static inline bool read(const char* str, size_t length, time_t& utc, long& nanosecond) {
+        if (str == nullptr) {
+            return false;
+        }
+        DMFormatFields f = CDMFormatPattern::ParseDefaults();
+        const char* p = str;
+        if (!read_ops(p, str + length, f, std::make_index_sequence<PROGRAM.count>()) || p != str + length
+            || !CDMFormatPattern::StoreFields(f, PROGRAM.fields, utc)) {
+            return false;
+        }
+        nanosecond = f.nanosecond;
+        return true;
+    }
+
+public:
+    // 格式化结果的字节数（不含 '\0'）
+    static constexpr size_t LENGTH = PROGRAM.length;
+
+    // 写入恰好 LENGTH 字节（不补 '\0'）；需要 %Y 而年份不在 0-9999 时不写入并返回 0
+    static inline size_t Format(const CDMDateTime& dt, char* out) {
+        return write(dt, 0, out);
+    }
+
+    template<long long TicksPerSecond>
+    static inline size_t Format(const CDMBasicDateTime<TicksPerSecond>& dt, char* out) {
+        return write(dt.ToDateTime(), dt.GetNanosecond(), out);
+    }
+
+    // 与 CDMDateTime::ToString(buffer, capacity) 相同：末尾补 '\0'，容量不足时写空串并返回 0
+    template<typename DateTime>
+    static inline size_t ToString(const DateTime& dt, char* buffer, size_t capacity) {
+        if (capacity < LENGTH + 1) {
+            if (capacity > 0) {
+                buffer[0] = '\0';
+            }
+            return 0;
+        }
+        const size_t n = Format(dt, buffer);
+        buffer[n] = '\0';
+        return n;
+    }
+
+    template<typename DateTime>
+    static inline std::string ToString(const DateTime& dt) {
+        char buffer[LENGTH + 1];
+        return std::string(buffer, Format(dt, buffer));
+    }
+
+    static inline bool TryParse(const char* str, size_t length, CDMDateTime& result) {
+        time_t utc = 0;
+        long nanosecond = 0;
+        if (!read(str, length, utc, nanosecond)) {
+            return false;
+        }
+        result = CDMDateTime::FromTimestamp(utc);
+        return true;
+    }
+
+    // 小数秒按分辨率向下截断
+    template<long long TicksPerSecond>
+    static inline bool TryParse(const char* str, size_t length, CDMBasicDateTime<TicksPerSecond>& result) {
+        time_t utc = 0;
+        long nanosecond = 0;
+        return read(str, length, utc, nanosecond) && CDMFormatPattern::StoreTicks(utc, nanosecond, result);
+    }
+
+    template<typename DateTime>
+    static inline bool TryParse(std::string_view str, DateTime& result) {
+        return TryParse(str.data(), str.size(), result);
+    }
+
+    static inline CDMDateTime Parse(std::string_view str) {
+        CDMDateTime result = CDMDateTime::FromTimestamp(0);
+        if (!TryParse(str.data(), str.size(), result)) {
+            throw std::runtime_error("Failed to parse date/time '" + std::string(str) + "' with format '" + Pattern + "'");
+        }
+        return result;
+    }
+};
+
+// 运行时给出的模式（如来自配置文件）预编译一次，之后反复格式化/解析不再解释模式串，
+// 也不再使用 ToString(format_string)/Parse(str, sscanf_format) 的位置参数 %d：
+//
+//   const CDMDateTimeFormat format(config.GetString("time_format")); // 非法模式抛出 std::runtime_error
+//   std::string text = format.ToString(dt);
+//   CDMDateTime parsed = format.Parse(text);
+//
+// 编译后的对象只读，可在多个线程间共享。
+class CDMDateTimeFormat {
+public:
+    // 空模式：格式化为空串，只能解析空串（得到 1970-01-01 00:00:00 本地时间）
+    CDMDateTimeFormat() : length_(0), fields_(0) {}
+
+    // 非法模式抛出 std::runtime_error
+    explicit CDMDateTimeFormat(std::string_view pattern) : length_(0), fields_(0) {
+        *this = Compile(pattern);
+    }
+
+    // 编译失败返回 false，result 不变；error_offset 非空时写入出错位置
+    static bool TryCompile(std::string_view pattern, CDMDateTimeFormat& result, size_t* error_offset = nullptr) {
+        int error = CDMFormatPattern::PATTERN_OK;
+        size_t offset = 0;
+        if (!compile(pattern, result, error, offset)) {
+            if (error_offset != nullptr) {
+                *error_offset = offset;
+            }
+            return false;
+        }
+        return true;
+    }
+
+    static CDMDateTimeFormat Compile(std::string_view pattern) {
+        CDMDateTimeFormat result;
+        int error = CDMFormatPattern::PATTERN_OK;
+        size_t offset = 0;
+        if (!compile(pattern, result, error, offset)) {
+            const char* reason = error == CDMFormatPattern::PATTERN_TRAILING_PERCENT ? "pattern ends with a lone '%'"
+                : error == CDMFormatPattern::PATTERN_TOO_LONG ? "pattern is too long"
+                : "unsupported conversion";
+            throw std::runtime_error("Invalid date/time format '" + std::string(pattern) + "': " + reason
+                + " at offset " + std::to_string(offset));
+        }
+        return result;
+    }
+
+    inline const std::string& GetPattern() const {
+        return pattern_;
+    }
+
+    // 格式化结果的字节数（不含 '\0'），对所有时间相同
+    inline size_t GetLength() const {
+        return length_;
+    }
+
+    // 编译后的操作序列（字段后的单个字面字符已并入字段的 suffix）
+    inline const std::vector<DMFormatOp>& GetOps() const {
+        return ops_;
+    }
+
+    // 写入恰好 GetLength() 字节（不补 '\0'）；需要 %Y 而年份不在 0-9999 时不写入并返回 0
+    inline size_t Format(const CDMDateTime& dt, char* out) const {
+        return write(dt, 0, out);
+    }
+
+    template<long long TicksPerSecond>
+    inline size_t Format(const CDMBasicDateTime<TicksPerSecond>& dt, char* out) const {
+        return write(dt.ToDateTime(), dt.GetNanosecond(), out);
+    }
+
+    // 末尾补 '\0'，容量不足时写空串并返回 0
+    template<typename DateTime>
+    inline size_t ToString(const DateTime& dt, char* buffer, size_t capacity) const {
+        if (capacity < length_ + 1) {
+            if (capacity > 0) {
+                buffer[0] = '\0';
+            }
+            return 0;
+        }
+        const size_t n = Format(dt, buffer);
+        buffer[n] = '\0';
+        return n;
+    }
+
+    template<typename DateTime>
+    inline std::string ToString(const DateTime& dt) const {
+        std::string text;
+        AppendString(text, dt);
+        return text;
+    }
+
+    // 追加到已有字符串末尾，复用其容量；返回追加的字节数
+    template<typename DateTime>
+    inline size_t AppendString(std::string& out, const DateTime& dt) const {
+        const size_t old_size = out.size();
+        out.resize(old_size + length_);
+        const size_t n = Format(dt, &out[0] + old_size);
+        out.resize(old_size + n);
+        return n;
+    }
+
+    inline bool TryParse(const char* str, size_t length, CDMDateTime& result) const {
+        time_t utc = 0;
+        long nanosecond = 0;
+        if (!read(str, length, utc, nanosecond)) {
+            return false;
+        }
+        result = CDMDateTime::FromTimestamp(utc);
+        return true;
+    }
+
+    // 小数秒按分辨率向下截断
+    template<long long TicksPerSecond>
+    inline bool TryParse(const char* str, size_t length, CDMBasicDateTime<TicksPerSecond>& result) const {
+        time_t utc = 0;
+        long nanosecond = 0;
+        return read(str, length, utc, nanosecond) && CDMFormatPattern::StoreTicks(utc, nanosecond, result);
+    }
+
+    template<typename DateTime>
+    inline bool TryParse(std::string_view str, DateTime& result) const {
+        return TryParse(str.data(), str.size(), result);
+    }
+
+    inline CDMDateTime Parse(std::string_view str) const {
+        CDMDateTime result = CDMDateTime::FromTimestamp(0);
+        if (!TryParse(str.data(), str.size(), result)) {
+            throw std::runtime_error("Failed to parse date/time '" + std::string(str) + "' with format '" + pattern_ + "'");
+        }
+        return result;
+    }
+
+private:
+    static bool compile(std::string_view pattern, CDMDateTimeFormat& result, int& error, size_t& error_offset) {
+        CDMDateTimeFormat compiled;
+        compiled.pattern_.assign(pattern.data(), pattern.size());
+        const size_t nul = compiled.pattern_.find('\0');
+        if (nul != std::string::npos) {
+            error = CDMFormatPattern::PATTERN_UNKNOWN_SPECIFIER;
+            error_offset = nul;
+            return false;
+        }
+        const char* text = compiled.pattern_.c_str();
+        size_t pos = 0;
+        while (text[pos] != '\0') {
+            DMFormatOp op{};
+            const size_t at = pos;
+            error = CDMFormatPattern::NextOp(text, pos, op);
+            if (error != CDMFormatPattern::PATTERN_OK) {
+                error_offset = at;
+                return false;
+            }
+            compiled.length_ += op.length;
+            // 字段后的单个字面字符并入该字段，减少逐操作分派的次数
+            if (op.code == CDMFormatPattern::OP_LITERAL && op.length == 1 && !compiled.ops_.empty()
+                && compiled.ops_.back().code != CDMFormatPattern::OP_LITERAL && compiled.ops_.back().suffix == '\0') {
+                compiled.ops_.back().suffix = text[op.offset];
+                continue;
+            }
+            compiled.ops_.push_back(op);
+            compiled.fields_ |= op.code == CDMFormatPattern::OP_LITERAL ? 0u : CDMFormatPattern::FieldBit(op.code);
+        }
+        compiled.ops_.shrink_to_fit();
+        result = std::move(compiled);
+        return true;
+    }
+
+    inline size_t write(const CDMDateTime& dt, long nanosecond, char* out) const {
+        DMFormatFields f;
+        if (!CDMFormatPattern::LoadFields(dt, fields_, nanosecond, f)) {
+            return 0;
+        }
+        const char* text = pattern_.data();
+        char* p = out;
+        for (const DMFormatOp& op : ops_) {
+            p = CDMFormatPattern::WriteOp(p, op, text, f);
+        }
+        return static_cast<size_t>(p - out);
+    }
+
+    inline bool read(const char* str, size_t length, time_t& utc, long& nanosecond) const {
+        if (str == nullptr && length != 0) {
+            return false;
+        }
+        DMFormatFields f = CDMFormatPattern::ParseDefaults();
+        const char* text = pattern_.data();
+        const char* p = str;
+        const char* end = str + length;
+        for (const DMFormatOp& op : ops_) {
+            if (!CDMFormatPattern::ReadOp(p, end, op, text, f)) {
+                return false;
+            }
+        }
+        if (p != end || !CDMFormatPattern::StoreFields(f, fields_, utc)) {
+            return false;
+        }
+        nanosecond = f.nanosecond;
+        return true;
+    }
+
+    std::string pattern_;
+    std::vector<DMFormatOp> ops_;
+    size_t length_;
+    unsigned fields_;
+};
+
+#endif // __DMDATETIMEFORMAT_H__
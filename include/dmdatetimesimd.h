@@ -0,0 +1,200 @@
+// Copyright (c) 2018 brinkqiang (brink.qiang@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __DMDATETIMESIMD_H__
+#define __DMDATETIMESIMD_H__
+
+#include <cstdint>
+#include "dmcivil.h"
+
+// 定宽 "YYYY-MM-DD HH:MM:SS"（分隔符也可以是 'T'）前 19 个字节的字段提取内核。
+// 只做数字转换与格式/范围校验，不涉及时区；时区与后缀由 CDMDateTime::ParseBatch 处理。
+// x86 上用函数级 target 属性编译 SSE4.1 / AVX2 版本并在运行时按 CPU 能力分派，
+// 其余平台只有标量版本。每个内核最多读取行首的 19 个字节。
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define DMDATETIME_SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define DMDATETIME_TARGET_SSE41
+#define DMDATETIME_TARGET_AVX2
+#else
+#define DMDATETIME_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define DMDATETIME_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+struct DMDateTimeFields {
+    int year;
+    int month;
+    int day;
+    int hour;
+    int minute;
+    int second;
+};
+
+class CDMDateTimeSimd {
+public:
+    enum {
+        SIMD_LEVEL_SCALAR = 0,
+        SIMD_LEVEL_SSE41 = 1,
+        SIMD_LEVEL_AVX2 = 2,
+    };
+
+    static const int FIXED_WIDTH = 19;
+
+    static int DetectLevel() {
+        static const int level = detect_level();
+        return level;
+    }
+
+    static bool CheckRange(const DMDateTimeFields& f) {
+        return f.month >= 1 && f.month <= 12 && f.day >= 1 && f.day <= CDMCivil::DaysInMonth(f.year, f.month)
+            && f.hour <= 23 && f.minute <= 59 && f.second <= 59;
+    }
+
+    static bool ParseFixedScalar(const char* p, DMDateTimeFields& f) {
+        unsigned bad = 0;
+        auto digit = [&](int i) -> int {
+            const unsigned d = static_cast<unsigned>(static_cast<unsigned char>(p[i])) - '0';
+            bad |= (d > 9u) ? 1u : 0u;
+            return static_cast<int>(d);
+        };
+        f.year = digit(0) * 1000 + digit(1) * 100 + digit(2) * 10 + digit(3);
+        f.month = digit(5) * 10 + digit(6);
+        f.day = digit(8) * 10 + digit(9);
+        f.hour = digit(11) * 10 + digit(12);
+        f.minute = digit(14) * 10 + digit(15);
+        f.second = digit(17) * 10 + digit(18);
+        const bool separators = p[4] == '-' && p[7] == '-' && (p[10] == ' ' || p[10] == 'T')
+            && p[13] == ':' && p[16] == ':';
+        return bad == 0 && separators && CheckRange(f);
+    }
+
+#ifdef DMDATETIME_SIMD_X86
+    // 一行：16 字节向量覆盖 "YYYY-MM-DD HH:MM"，剩余 ":SS" 用标量处理
+    DMDATETIME_TARGET_SSE41 static bool ParseFixedSSE41(const char* p, DMDateTimeFields& f) {
+        const __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const __m128i d = _mm_sub_epi8(raw, _mm_set1_epi8('0'));
+        const unsigned digit_ok = static_cast<unsigned>(_mm_movemask_epi8(
+            _mm_cmpeq_epi8(_mm_min_epu8(d, _mm_set1_epi8(9)), d)));
+        const unsigned sep_ok = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(raw, sep_template())));
+        const __m128i packed = _mm_maddubs_epi16(_mm_shuffle_epi8(d, gather_pairs()), pair_weights());
+
+        f.year = _mm_extract_epi16(packed, 0) * 100 + _mm_extract_epi16(packed, 1);
+        f.month = _mm_extract_epi16(packed, 2);
+        f.day = _mm_extract_epi16(packed, 3);
+        f.hour = _mm_extract_epi16(packed, 4);
+        f.minute = _mm_extract_epi16(packed, 5);
+        return finish_row(p, digit_ok, sep_ok, f);
+    }
+
+    // 两行一组：两行分别放进 256 位寄存器的高低 128 位通道，pshufb/pmaddubsw 按通道独立执行
+    DMDATETIME_TARGET_AVX2 static void ParseFixedAVX2x2(const char* a, const char* b,
+        DMDateTimeFields& fa, DMDateTimeFields& fb, bool& ok_a, bool& ok_b) {
+        const __m256i raw = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a))),
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(b)), 1);
+        const __m256i d = _mm256_sub_epi8(raw, _mm256_set1_epi8('0'));
+        const unsigned digit_ok = static_cast<unsigned>(_mm256_movemask_epi8(
+            _mm256_cmpeq_epi8(_mm256_min_epu8(d, _mm256_set1_epi8(9)), d)));
+        const __m256i sep = _mm256_broadcastsi128_si256(sep_template());
+        const unsigned sep_ok = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(raw, sep)));
+        const __m256i packed = _mm256_maddubs_epi16(
+            _mm256_shuffle_epi8(d, _mm256_broadcastsi128_si256(gather_pairs())),
+            _mm256_broadcastsi128_si256(pair_weights()));
+
+        alignas(32) int16_t lanes[16];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), packed);
+        fa.year = lanes[0] * 100 + lanes[1];
+        fa.month = lanes[2];
+        fa.day = lanes[3];
+        fa.hour = lanes[4];
+        fa.minute = lanes[5];
+        fb.year = lanes[8] * 100 + lanes[9];
+        fb.month = lanes[10];
+        fb.day = lanes[11];
+        fb.hour = lanes[12];
+        fb.minute = lanes[13];
+        ok_a = finish_row(a, digit_ok & 0xFFFF, sep_ok & 0xFFFF, fa);
+        ok_b = finish_row(b, digit_ok >> 16, sep_ok >> 16, fb);
+    }
+#endif
+
+private:
+    // 数字位置 0-3,5-6,8-9,11-12,14-15；分隔符位置 4,7,13（第 10 位 ' '/'T' 由标量判断）
+    static const unsigned DIGIT_MASK = 0xDB6Fu;
+    static const unsigned SEP_MASK = 0x2090u;
+
+#ifdef DMDATETIME_SIMD_X86
+    DMDATETIME_TARGET_SSE41 static __m128i sep_template() {
+        return _mm_setr_epi8(0, 0, 0, 0, '-', 0, 0, '-', 0, 0, 0, 0, 0, ':', 0, 0);
+    }
+
+    DMDATETIME_TARGET_SSE41 static __m128i gather_pairs() {
+        return _mm_setr_epi8(0, 1, 2, 3, 5, 6, 8, 9, 11, 12, 14, 15, -1, -1, -1, -1);
+    }
+
+    DMDATETIME_TARGET_SSE41 static __m128i pair_weights() {
+        return _mm_setr_epi8(10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 0, 0, 0, 0);
+    }
+
+    static bool finish_row(const char* p, unsigned digit_ok, unsigned sep_ok, DMDateTimeFields& f) {
+        const unsigned s1 = static_cast<unsigned>(static_cast<unsigned char>(p[17])) - '0';
+        const unsigned s2 = static_cast<unsigned>(static_cast<unsigned char>(p[18])) - '0';
+        f.second = static_cast<int>(s1 * 10 + s2);
+        return (digit_ok & DIGIT_MASK) == DIGIT_MASK && (sep_ok & SEP_MASK) == SEP_MASK
+            && (p[10] == ' ' || p[10] == 'T') && p[16] == ':' && s1 <= 9u && s2 <= 9u && CheckRange(f);
+    }
+#endif
+
+    static int detect_level() {
+#ifdef DMDATETIME_SIMD_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+        int info[4] = { 0 };
+        __cpuid(info, 0);
+        const int max_leaf = info[0];
+        __cpuid(info, 1);
+        const bool sse41 = (info[2] & (1 << 19)) != 0;
+        const bool os_avx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0
+            && (_xgetbv(0) & 0x6) == 0x6;
+        bool avx2 = false;
+        if (max_leaf >= 7 && os_avx) {
+            __cpuidex(info, 7, 0);
+            avx2 = (info[1] & (1 << 5)) != 0;
+        }
+#else
+        __builtin_cpu_init();
+        const bool sse41 = __builtin_cpu_supports("sse4.1") != 0;
+        const bool avx2 = __builtin_cpu_supports("avx2") != 0;
+#endif
+        if (avx2) {
+            return SIMD_LEVEL_AVX2;
+        }
+        if (sse41) {
+            return SIMD_LEVEL_SSE41;
+        }
+#endif
+        return SIMD_LEVEL_SCALAR;
+    }
+};
+
+#endif // __DMDATETIMESIMD_H__
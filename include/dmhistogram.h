@@ -0,0 +1,236 @@
+﻿// Copyright (c) 2018 brinkqiang (brink.qiang@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __DMHISTOGRAM_H__
+#define __DMHISTOGRAM_H__
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+#include "dmdatetime.h"
+
+// 按时间分桶的批量聚合：一次遍历时间戳数组（可带数值），得到每个桶的次数、和、最小值、最大值。
+// 固定宽度的桶（每 5 分钟、每小时……）直接用整数除法求桶号；日历桶（本地时间的日 / 周 / 月 / 季 / 年）
+// 在构造时预先算出各桶起点的 UTC 时间戳表，累计时只比较时间戳，不再逐个调用 GetStartOfDay/GetStartOfMonth。
+// 日历桶查找带游标，时间戳大致有序时每个元素通常只需两次比较，乱序时退化为二分查找。
+
+class CDMTimeHistogram {
+public:
+    enum CalendarUnit {
+        UNIT_DAY = 0,
+        UNIT_WEEK,
+        UNIT_MONTH,
+        UNIT_QUARTER,
+        UNIT_YEAR,
+    };
+
+    CDMTimeHistogram() = default;
+
+    // 固定宽度：第 i 个桶为 [origin + i * width, origin + (i + 1) * width)
+    static CDMTimeHistogram Fixed(const CDMDateTime& origin, const CDMTimeSpan& width, size_t bucket_count) {
+        if (width.GetTotalSeconds() <= 0) {
+            throw std::runtime_error("Histogram bucket width must be positive.");
+        }
+        CDMTimeHistogram histogram;
+        histogram.origin_ = static_cast<long long>(origin.GetTimestamp());
+        histogram.width_ = static_cast<long long>(width.GetTotalSeconds());
+        histogram.reset_buckets(bucket_count);
+        return histogram;
+    }
+
+    // 日历桶：从 from 所在单位的起点到 to 所在单位的终点，按本地时间划分；周以 firstDayOfWeek 开始（0=周日）
+    static CDMTimeHistogram Calendar(const CDMDateTime& from, const CDMDateTime& to, CalendarUnit unit, int firstDayOfWeek = 1) {
+        if (to < from) {
+            throw std::runtime_error("Histogram range end is earlier than begin.");
+        }
+        const CDMDateTime start = unit_start(from, unit, firstDayOfWeek);
+        CDMTimeHistogram histogram;
+        histogram.width_ = 0;
+        int year = start.GetYear();
+        int month = start.GetMonth();
+        int day = start.GetDay();
+        const time_t last = to.GetTimestamp();
+        time_t boundary = start.GetTimestamp();
+        histogram.boundaries_.push_back(boundary);
+        while (boundary <= last) {
+            switch (unit) {
+            case UNIT_DAY:
+            case UNIT_WEEK: {
+                const DMCivilDate next = CDMCivil::CivilFromDays(CDMCivil::DaysFromCivil(year, month, day) + (unit == UNIT_DAY ? 1 : 7));
+                year = next.year;
+                month = next.month;
+                day = next.day;
+                break;
+            }
+            default: {
+                const int step = unit == UNIT_MONTH ? 1 : (unit == UNIT_QUARTER ? 3 : 12);
+                const int index = month - 1 + step;
+                year += index / 12;
+                month = index % 12 + 1;
+                break;
+            }
+            }
+            boundary = CDMDateTime(year, month, day, 0, 0, 0).GetTimestamp();
+            histogram.boundaries_.push_back(boundary);
+        }
+        histogram.reset_buckets(histogram.boundaries_.size() - 1);
+        return histogram;
+    }
+
+    // 累计 count 个时间戳；values 可为 nullptr（只统计次数）。落在所有桶之外的元素被忽略，返回计入的个数
+    size_t Accumulate(const time_t* timestamps, const double* values, size_t count) {
+        return width_ > 0 ? accumulate_fixed(timestamps, values, count) : accumulate_calendar(timestamps, values, count);
+    }
+
+    inline size_t Accumulate(const std::vector<time_t>& timestamps, const std::vector<double>& values) {
+        if (timestamps.size() != values.size()) {
+            throw std::runtime_error("Histogram timestamps and values differ in length.");
+        }
+        return Accumulate(timestamps.data(), values.data(), timestamps.size());
+    }
+
+    // 清空统计，保留分桶方式
+    void Reset() {
+        reset_buckets(counts_.size());
+    }
+
+    inline size_t GetBucketCount() const {
+        return counts_.size();
+    }
+
+    inline CDMDateTime GetBucketBegin(size_t index) const {
+        return CDMDateTime::FromTimestamp(width_ > 0 ? static_cast<time_t>(origin_ + static_cast<long long>(index) * width_) : boundaries_[index]);
+    }
+
+    inline CDMDateTime GetBucketEnd(size_t index) const {
+        return GetBucketBegin(index + 1);
+    }
+
+    inline uint64_t GetCount(size_t index) const {
+        return counts_[index];
+    }
+
+    inline double GetSum(size_t index) const {
+        return sums_[index];
+    }
+
+    // 空桶的最小值为 +inf、最大值为 -inf
+    inline double GetMin(size_t index) const {
+        return mins_[index];
+    }
+
+    inline double GetMax(size_t index) const {
+        return maxs_[index];
+    }
+
+    inline double GetMean(size_t index) const {
+        return counts_[index] == 0 ? 0.0 : sums_[index] / static_cast<double>(counts_[index]);
+    }
+
+private:
+    static CDMDateTime unit_start(const CDMDateTime& when, CalendarUnit unit, int firstDayOfWeek) {
+        switch (unit) {
+        case UNIT_DAY:
+            return when.GetStartOfDay();
+        case UNIT_WEEK:
+            return when.GetStartOfWeek(firstDayOfWeek);
+        case UNIT_MONTH:
+            return when.GetStartOfMonth();
+        case UNIT_QUARTER:
+            return when.GetStartOfQuarter();
+        default:
+            return when.GetStartOfYear();
+        }
+    }
+
+    void reset_buckets(size_t bucket_count) {
+        counts_.assign(bucket_count, 0);
+        sums_.assign(bucket_count, 0.0);
+        mins_.assign(bucket_count, std::numeric_limits<double>::infinity());
+        maxs_.assign(bucket_count, -std::numeric_limits<double>::infinity());
+    }
+
+    inline void add(size_t bucket, const double* values, size_t i) {
+        ++counts_[bucket];
+        if (values != nullptr) {
+            const double value = values[i];
+            sums_[bucket] += value;
+            mins_[bucket] = std::min(mins_[bucket], value);
+            maxs_[bucket] = std::max(maxs_[bucket], value);
+        }
+    }
+
+    size_t accumulate_fixed(const time_t* timestamps, const double* values, size_t count) {
+        const uint64_t buckets = counts_.size();
+        const uint64_t width = static_cast<uint64_t>(width_);
+        size_t accepted = 0;
+        for (size_t i = 0; i < count; ++i) {
+            // 早于 origin 的偏移转成无符号后是极大值，与越过末尾一起被一次比较排除
+            const uint64_t offset = static_cast<uint64_t>(static_cast<long long>(timestamps[i]) - origin_);
+            const uint64_t bucket = offset / width;
+            if (bucket < buckets) {
+                add(static_cast<size_t>(bucket), values, i);
+                ++accepted;
+            }
+        }
+        return accepted;
+    }
+
+    size_t accumulate_calendar(const time_t* timestamps, const double* values, size_t count) {
+        if (counts_.empty()) {
+            return 0;
+        }
+        const time_t* bounds = boundaries_.data();
+        const size_t buckets = counts_.size();
+        const time_t first = bounds[0];
+        const time_t last = bounds[buckets];
+        size_t cursor = 0;
+        size_t accepted = 0;
+        for (size_t i = 0; i < count; ++i) {
+            const time_t t = timestamps[i];
+            if (t < first || t >= last) {
+                continue;
+            }
+            if (t < bounds[cursor] || t >= bounds[cursor + 1]) {
+                if (cursor + 2 <= buckets && t >= bounds[cursor + 1] && t < bounds[cursor + 2]) {
+                    ++cursor; // 有序输入跨入下一个桶
+                }
+                else {
+                    cursor = static_cast<size_t>(std::upper_bound(bounds, bounds + buckets + 1, t) - bounds) - 1;
+                }
+            }
+            add(cursor, values, i);
+            ++accepted;
+        }
+        return accepted;
+    }
+
+    long long origin_ = 0;
+    long long width_ = 0;            // > 0 为固定宽度，0 为日历桶
+    std::vector<time_t> boundaries_; // 日历桶起点，末尾多一个终点
+    std::vector<uint64_t> counts_;
+    std::vector<double> sums_;
+    std::vector<double> mins_;
+    std::vector<double> maxs_;
+};
+
+#endif // __DMHISTOGRAM_H__
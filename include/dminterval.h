@@ -0,0 +1,394 @@
+﻿// Copyright (c) 2018 brinkqiang (brink.qiang@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __DMINTERVAL_H__
+#define __DMINTERVAL_H__
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "dmdatetime.h"
+
+// 时间区间索引与区间集合，区间一律为半开区间 [begin, end)，以 time_t 秒存储。
+//
+// CDMIntervalIndex：一次性构建、只读查询的静态索引。区间按起点排序存放在一个连续数组里，
+// 同时把数组看成一棵隐式二叉树（第 k 层的节点下标为 2^k-1 + j*2^(k+1)），每个节点额外记录子树内的最大终点，
+// 查询时借此剪掉不可能相交的子树，点查询与区间重叠查询都是 O(log n + k)。布局参考 cgranges。
+//
+// CDMIntervalSet：可修改的区间集合，内部保持有序且互不相交、互不相邻，支持并、交、差。
+
+class CDMIntervalIndex {
+public:
+    CDMIntervalIndex() = default;
+
+    void Reserve(size_t count) {
+        nodes_.reserve(count);
+    }
+
+    // 添加区间 [begin, end)，value 为调用者自定义的标识；添加后需重新 Build
+    void Add(time_t begin, time_t end, uint32_t value) {
+        if (end < begin) {
+            throw std::runtime_error("Interval end is earlier than begin");
+        }
+        nodes_.push_back(Node{ static_cast<long long>(begin), static_cast<long long>(end), static_cast<long long>(end), value });
+        built_ = false;
+    }
+
+    inline void Add(const CDMDateTime& begin, const CDMDateTime& end, uint32_t value) {
+        Add(begin.GetTimestamp(), end.GetTimestamp(), value);
+    }
+
+    // 排序并计算各节点的子树最大终点
+    void Build() {
+        std::sort(nodes_.begin(), nodes_.end(), [](const Node& a, const Node& b) {
+            return a.begin < b.begin || (a.begin == b.begin && a.end < b.end);
+        });
+        max_level_ = build_tree();
+        built_ = true;
+    }
+
+    inline size_t Size() const {
+        return nodes_.size();
+    }
+
+    inline bool IsBuilt() const {
+        return built_;
+    }
+
+    void Clear() {
+        nodes_.clear();
+        max_level_ = -1;
+        built_ = true;
+    }
+
+    // 对每个与 [begin, end) 重叠的区间调用 visitor(value, begin, end)，按起点升序访问
+    template<typename Visitor>
+    void VisitOverlaps(time_t begin, time_t end, Visitor&& visitor) const {
+        if (!built_) {
+            throw std::runtime_error("CDMIntervalIndex::Build must be called before querying");
+        }
+        if (nodes_.empty() || !(begin < end)) {
+            return;
+        }
+        const long long st = static_cast<long long>(begin);
+        const long long en = static_cast<long long>(end);
+        const long long n = static_cast<long long>(nodes_.size());
+        const Node* a = nodes_.data();
+        struct Frame {
+            int level;
+            long long index;
+            bool left_done;
+        } stack[64];
+        int top = 0;
+        stack[top++] = Frame{ max_level_, (1LL << max_level_) - 1, false };
+        while (top > 0) {
+            const Frame frame = stack[--top];
+            if (frame.level <= LINEAR_LEVEL) {
+                // 小子树直接顺序扫描
+                const long long first = frame.index >> frame.level << frame.level;
+                const long long last = std::min(n, first + (1LL << (frame.level + 1)) - 1);
+                for (long long i = first; i < last && a[i].begin < en; ++i) {
+                    if (st < a[i].end) {
+                        visitor(a[i].value, static_cast<time_t>(a[i].begin), static_cast<time_t>(a[i].end));
+                    }
+                }
+            }
+            else if (!frame.left_done) {
+                // 先处理左子树，再回到本节点
+                const long long left = frame.index - (1LL << (frame.level - 1));
+                stack[top++] = Frame{ frame.level, frame.index, true };
+                if (left >= n || a[left].max_end > st) {
+                    stack[top++] = Frame{ frame.level - 1, left, false };
+                }
+            }
+            else if (frame.index < n && a[frame.index].begin < en) {
+                if (st < a[frame.index].end) {
+                    visitor(a[frame.index].value, static_cast<time_t>(a[frame.index].begin), static_cast<time_t>(a[frame.index].end));
+                }
+                stack[top++] = Frame{ frame.level - 1, frame.index + (1LL << (frame.level - 1)), false };
+            }
+        }
+    }
+
+    // 追加与 [begin, end) 重叠的区间标识，返回追加的个数
+    size_t FindOverlaps(const CDMDateTime& begin, const CDMDateTime& end, std::vector<uint32_t>& values) const {
+        const size_t before = values.size();
+        VisitOverlaps(begin.GetTimestamp(), end.GetTimestamp(), [&values](uint32_t value, time_t, time_t) {
+            values.push_back(value);
+        });
+        return values.size() - before;
+    }
+
+    // 追加包含 when 的区间标识（begin <= when < end），返回追加的个数
+    size_t FindContaining(const CDMDateTime& when, std::vector<uint32_t>& values) const {
+        const time_t stamp = when.GetTimestamp();
+        const size_t before = values.size();
+        VisitOverlaps(stamp, stamp + 1, [&values](uint32_t value, time_t, time_t) {
+            values.push_back(value);
+        });
+        return values.size() - before;
+    }
+
+    size_t CountContaining(const CDMDateTime& when) const {
+        const time_t stamp = when.GetTimestamp();
+        size_t count = 0;
+        VisitOverlaps(stamp, stamp + 1, [&count](uint32_t, time_t, time_t) {
+            ++count;
+        });
+        return count;
+    }
+
+private:
+    static constexpr int LINEAR_LEVEL = 3; // 不超过 15 个节点的子树改为线性扫描
+
+    struct Node {
+        long long begin;
+        long long end;
+        long long max_end; // 以该节点为根的子树内的最大终点
+        uint32_t value;
+    };
+
+    // 自底向上计算 max_end；数组长度不是 2^k-1 时，缺失的右子树用最右侧存在节点的值代替
+    int build_tree() {
+        const long long n = static_cast<long long>(nodes_.size());
+        if (n == 0) {
+            return -1;
+        }
+        long long last_index = 0;
+        long long last_max = 0;
+        for (long long i = 0; i < n; i += 2) {
+            last_index = i;
+            last_max = nodes_[i].max_end = nodes_[i].end;
+        }
+        int level = 1;
+        for (; (1LL << level) <= n; ++level) {
+            const long long half = 1LL << (level - 1);
+            const long long first = (half << 1) - 1;
+            const long long step = half << 2;
+            for (long long i = first; i < n; i += step) {
+                const long long left_max = nodes_[i - half].max_end;
+                const long long right_max = i + half < n ? nodes_[i + half].max_end : last_max;
+                nodes_[i].max_end = std::max(nodes_[i].end, std::max(left_max, right_max));
+            }
+            last_index = ((last_index >> level) & 1) ? last_index - half : last_index + half;
+            if (last_index < n && nodes_[last_index].max_end > last_max) {
+                last_max = nodes_[last_index].max_end;
+            }
+        }
+        return level - 1;
+    }
+
+    std::vector<Node> nodes_;
+    int max_level_ = -1;
+    bool built_ = true;
+};
+
+class CDMIntervalSet {
+public:
+    struct Range {
+        time_t begin;
+        time_t end;
+    };
+
+    CDMIntervalSet() = default;
+
+    // 并入 [begin, end)，与已有区间重叠或相邻时合并；空区间被忽略
+    void Add(time_t begin, time_t end) {
+        if (!(begin < end)) {
+            return;
+        }
+        // 第一个终点不早于 begin 的区间（可能与新区间合并）
+        auto first = std::lower_bound(ranges_.begin(), ranges_.end(), begin,
+            [](const Range& range, time_t value) { return range.end < value; });
+        auto last = first;
+        while (last != ranges_.end() && !(end < last->begin)) {
+            ++last;
+        }
+        if (first != last) {
+            begin = std::min(begin, first->begin);
+            end = std::max(end, (last - 1)->end);
+            first->begin = begin;
+            first->end = end;
+            ranges_.erase(first + 1, last);
+        }
+        else {
+            ranges_.insert(first, Range{ begin, end });
+        }
+    }
+
+    inline void Add(const CDMDateTime& begin, const CDMDateTime& end) {
+        Add(begin.GetTimestamp(), end.GetTimestamp());
+    }
+
+    // 去掉 [begin, end) 覆盖的部分
+    void Remove(time_t begin, time_t end) {
+        if (!(begin < end)) {
+            return;
+        }
+        auto first = std::upper_bound(ranges_.begin(), ranges_.end(), begin,
+            [](time_t value, const Range& range) { return value < range.end; });
+        auto last = first;
+        while (last != ranges_.end() && last->begin < end) {
+            ++last;
+        }
+        if (first == last) {
+            return;
+        }
+        const Range head = *first;
+        const Range tail = *(last - 1);
+        std::vector<Range> pieces;
+        if (head.begin < begin) {
+            pieces.push_back(Range{ head.begin, begin });
+        }
+        if (end < tail.end) {
+            pieces.push_back(Range{ end, tail.end });
+        }
+        const auto position = ranges_.erase(first, last);
+        ranges_.insert(position, pieces.begin(), pieces.end());
+    }
+
+    inline void Remove(const CDMDateTime& begin, const CDMDateTime& end) {
+        Remove(begin.GetTimestamp(), end.GetTimestamp());
+    }
+
+    bool Contains(time_t when) const {
+        auto it = std::upper_bound(ranges_.begin(), ranges_.end(), when,
+            [](time_t value, const Range& range) { return value < range.end; });
+        return it != ranges_.end() && it->begin <= when;
+    }
+
+    inline bool Contains(const CDMDateTime& when) const {
+        return Contains(when.GetTimestamp());
+    }
+
+    // 是否与 [begin, end) 有重叠
+    bool Overlaps(time_t begin, time_t end) const {
+        if (!(begin < end)) {
+            return false;
+        }
+        auto it = std::upper_bound(ranges_.begin(), ranges_.end(), begin,
+            [](time_t value, const Range& range) { return value < range.end; });
+        return it != ranges_.end() && it->begin < end;
+    }
+
+    CDMIntervalSet Union(const CDMIntervalSet& other) const {
+        CDMIntervalSet result;
+        result.ranges_.reserve(ranges_.size() + other.ranges_.size());
+        auto a = ranges_.begin();
+        auto b = other.ranges_.begin();
+        while (a != ranges_.end() || b != other.ranges_.end()) {
+            const Range next = (b == other.ranges_.end() || (a != ranges_.end() && a->begin <= b->begin)) ? *a++ : *b++;
+            if (!result.ranges_.empty() && next.begin <= result.ranges_.back().end) {
+                result.ranges_.back().end = std::max(result.ranges_.back().end, next.end);
+            }
+            else {
+                result.ranges_.push_back(next);
+            }
+        }
+        return result;
+    }
+
+    CDMIntervalSet Intersect(const CDMIntervalSet& other) const {
+        CDMIntervalSet result;
+        auto a = ranges_.begin();
+        auto b = other.ranges_.begin();
+        while (a != ranges_.end() && b != other.ranges_.end()) {
+            const time_t begin = std::max(a->begin, b->begin);
+            const time_t end = std::min(a->end, b->end);
+            if (begin < end) {
+                result.ranges_.push_back(Range{ begin, end });
+            }
+            if (a->end < b->end) {
+                ++a;
+            }
+            else {
+                ++b;
+            }
+        }
+        return result;
+    }
+
+    CDMIntervalSet Subtract(const CDMIntervalSet& other) const {
+        CDMIntervalSet result;
+        auto b = other.ranges_.begin();
+        for (const Range& range : ranges_) {
+            time_t begin = range.begin;
+            while (b != other.ranges_.end() && b->end <= begin) {
+                ++b;
+            }
+            for (auto cut = b; cut != other.ranges_.end() && cut->begin < range.end; ++cut) {
+                if (begin < cut->begin) {
+                    result.ranges_.push_back(Range{ begin, cut->begin });
+                }
+                begin = std::max(begin, cut->end);
+            }
+            if (begin < range.end) {
+                result.ranges_.push_back(Range{ begin, range.end });
+            }
+        }
+        return result;
+    }
+
+    inline CDMIntervalSet operator|(const CDMIntervalSet& other) const { return Union(other); }
+    inline CDMIntervalSet operator&(const CDMIntervalSet& other) const { return Intersect(other); }
+    inline CDMIntervalSet operator-(const CDMIntervalSet& other) const { return Subtract(other); }
+
+    bool operator==(const CDMIntervalSet& other) const {
+        return ranges_.size() == other.ranges_.size() &&
+            std::equal(ranges_.begin(), ranges_.end(), other.ranges_.begin(),
+                [](const Range& a, const Range& b) { return a.begin == b.begin && a.end == b.end; });
+    }
+
+    bool operator!=(const CDMIntervalSet& other) const {
+        return !(*this == other);
+    }
+
+    // 所有区间的总时长
+    CDMTimeSpan GetTotalDuration() const {
+        long long total = 0;
+        for (const Range& range : ranges_) {
+            total += static_cast<long long>(range.end - range.begin);
+        }
+        return CDMTimeSpan(static_cast<time_t>(total));
+    }
+
+    inline const std::vector<Range>& GetRanges() const {
+        return ranges_;
+    }
+
+    inline size_t Size() const {
+        return ranges_.size();
+    }
+
+    inline bool Empty() const {
+        return ranges_.empty();
+    }
+
+    inline void Clear() {
+        ranges_.clear();
+    }
+
+private:
+    std::vector<Range> ranges_;
+};
+
+#endif // __DMINTERVAL_H__
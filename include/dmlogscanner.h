@@ -0,0 +1,307 @@
+﻿// Copyright (c) 2018 brinkqiang (brink.qiang@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __DMLOGSCANNER_H__
+#define __DMLOGSCANNER_H__
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "dmdatetime.h"
+#include "dmmappedfile.h"
+
+// 按行首时间戳筛选日志：找出时间落在 [start, end) 内的行，以文件内的字节范围交给回调，不复制内容。
+//
+// 行首时间戳为 "YYYY-MM-DD HH:MM:SS"（可带 '[' 前缀与 .fff、Z、±hh:mm 后缀，语义同 CDMDateTime::TryParse）；
+// 解析不出时间戳的行（异常堆栈等续行）归属上一条带时间戳的行。
+//   FindSorted    日志按时间有序时，对字节偏移二分，只读取 O(log n) 个位置附近的行，结果是一段连续范围
+//   ScanParallel  无序日志按行边界切块，多线程逐行解析，按文件顺序输出并合并相邻的匹配行
+//   Scan          抽样判断是否有序后选择上面两者之一
+
+class CDMLogScanner {
+public:
+    enum { DEFAULT_CHUNK_SIZE = 4 << 20 };
+
+    // 映射整个日志文件，失败抛出 std::runtime_error
+    explicit CDMLogScanner(const std::string& path)
+        : file_(std::make_shared<CDMMappedFile>(path)), data_(file_->Data()), size_(file_->Size()) {
+    }
+
+    // 扫描调用者提供的内存，需在扫描期间保持有效
+    CDMLogScanner(const char* data, size_t size) : data_(data), size_(size) {
+    }
+
+    inline const char* Data() const {
+        return data_;
+    }
+
+    inline size_t Size() const {
+        return size_;
+    }
+
+    // 解析 [line, end) 开头的时间戳
+    static bool ParseLineTimestamp(const char* line, const char* end, time_t& timestamp) {
+        const char* p = line;
+        if (p < end && *p == '[') {
+            ++p;
+        }
+        if (end - p < 19 || p[4] != '-' || p[7] != '-' || static_cast<unsigned>(p[0] - '0') > 9) {
+            return false;
+        }
+        const char* q = p + 19;
+        while (q < end && (static_cast<unsigned>(*q - '0') <= 9 || *q == '.' || *q == 'Z' || *q == '+' || *q == '-' || *q == ':')) {
+            ++q;
+        }
+        CDMDateTime parsed = CDMDateTime::FromTimestamp(0);
+        if (CDMDateTime::TryParse(p, static_cast<size_t>(q - p), parsed) || (q != p + 19 && CDMDateTime::TryParse(p, 19, parsed))) {
+            timestamp = parsed.GetTimestamp();
+            return true;
+        }
+        return false;
+    }
+
+    // 在 samples 个等距位置取首个带时间戳的行，时间不减则认为日志有序（抽样判断，不保证）
+    bool LooksSorted(size_t samples = 64) const {
+        time_t previous = 0;
+        bool has_previous = false;
+        for (size_t i = 0; i <= samples; ++i) {
+            const size_t position = static_cast<size_t>(static_cast<double>(size_) * i / samples);
+            Entry entry;
+            if (!first_entry_from(line_start_at_or_after(position), size_, entry)) {
+                continue;
+            }
+            if (has_previous && entry.timestamp < previous) {
+                return false;
+            }
+            previous = entry.timestamp;
+            has_previous = true;
+        }
+        return true;
+    }
+
+    // 有序日志中 [start, end) 对应的字节范围 [begin_offset, end_offset)（整行，含续行）
+    void FindSorted(const CDMDateTime& start, const CDMDateTime& end, size_t& begin_offset, size_t& end_offset) const {
+        begin_offset = lower_bound(start.GetTimestamp());
+        end_offset = end <= start ? begin_offset : std::max(begin_offset, lower_bound(end.GetTimestamp()));
+    }
+
+    // 多线程扫描，按文件顺序对每段连续的匹配行调用 sink(const char* data, size_t length)；
+    // threads <= 0 时使用硬件线程数。sink 在调用线程上执行。返回匹配的字节数
+    template<typename Sink>
+    uint64_t ScanParallel(const CDMDateTime& start, const CDMDateTime& end, int threads, Sink&& sink,
+        size_t chunk_size = DEFAULT_CHUNK_SIZE) const {
+        if (size_ == 0 || !(start < end)) {
+            return 0;
+        }
+        if (threads <= 0) {
+            threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        }
+        chunk_size = std::max<size_t>(chunk_size, 1);
+        const size_t chunk_count = (size_ + chunk_size - 1) / chunk_size;
+        threads = static_cast<int>(std::min<size_t>(static_cast<size_t>(threads), chunk_count));
+        const time_t lo = start.GetTimestamp();
+        const time_t hi = end.GetTimestamp();
+
+        struct Shared {
+            std::mutex mutex;
+            std::condition_variable ready;
+            std::vector<std::vector<std::pair<size_t, size_t>>> ranges;
+            std::vector<uint8_t> done;
+            std::atomic<size_t> next{ 0 };
+            std::atomic<bool> stop{ false };
+        } shared;
+        shared.ranges.resize(chunk_count);
+        shared.done.assign(chunk_count, 0);
+        auto worker = [&]() {
+            for (size_t chunk = shared.next++; chunk < chunk_count && !shared.stop.load(); chunk = shared.next++) {
+                std::vector<std::pair<size_t, size_t>> found;
+                scan_chunk(line_start_at_or_after(chunk * chunk_size),
+                    line_start_at_or_after(std::min(size_, (chunk + 1) * chunk_size)), lo, hi, found);
+                std::lock_guard<std::mutex> lock(shared.mutex);
+                shared.ranges[chunk].swap(found);
+                shared.done[chunk] = 1;
+                shared.ready.notify_all();
+            }
+        };
+        std::vector<std::thread> pool;
+        for (int i = 0; i < threads; ++i) {
+            pool.emplace_back(worker);
+        }
+        uint64_t matched = 0;
+        try {
+            // 按块顺序输出，跨块相邻的范围合并后再交给 sink
+            size_t pending_begin = 0;
+            size_t pending_end = 0;
+            for (size_t chunk = 0; chunk < chunk_count; ++chunk) {
+                std::vector<std::pair<size_t, size_t>> found;
+                {
+                    std::unique_lock<std::mutex> lock(shared.mutex);
+                    shared.ready.wait(lock, [&]() { return shared.done[chunk] != 0; });
+                    found.swap(shared.ranges[chunk]);
+                }
+                for (const std::pair<size_t, size_t>& range : found) {
+                    if (pending_end != pending_begin && range.first == pending_end) {
+                        pending_end = range.second;
+                        continue;
+                    }
+                    if (pending_end != pending_begin) {
+                        sink(data_ + pending_begin, pending_end - pending_begin);
+                        matched += pending_end - pending_begin;
+                    }
+                    pending_begin = range.first;
+                    pending_end = range.second;
+                }
+            }
+            if (pending_end != pending_begin) {
+                sink(data_ + pending_begin, pending_end - pending_begin);
+                matched += pending_end - pending_begin;
+            }
+        }
+        catch (...) {
+            shared.stop = true;
+            for (std::thread& thread : pool) {
+                thread.join();
+            }
+            throw;
+        }
+        for (std::thread& thread : pool) {
+            thread.join();
+        }
+        return matched;
+    }
+
+    // 抽样判断有序时走 FindSorted（至多一次 sink 调用），否则 ScanParallel；返回匹配的字节数
+    template<typename Sink>
+    uint64_t Scan(const CDMDateTime& start, const CDMDateTime& end, int threads, Sink&& sink) const {
+        if (!LooksSorted()) {
+            return ScanParallel(start, end, threads, sink);
+        }
+        size_t begin_offset = 0;
+        size_t end_offset = 0;
+        FindSorted(start, end, begin_offset, end_offset);
+        if (end_offset > begin_offset) {
+            sink(data_ + begin_offset, end_offset - begin_offset);
+        }
+        return end_offset - begin_offset;
+    }
+
+private:
+    struct Entry {
+        size_t begin;     // 行首
+        size_t next;      // 下一行行首
+        time_t timestamp;
+    };
+
+    inline size_t line_end(size_t position) const {
+        const void* newline = std::memchr(data_ + position, '\n', size_ - position);
+        return newline == nullptr ? size_ : static_cast<size_t>(static_cast<const char*>(newline) - data_) + 1;
+    }
+
+    // 不早于 position 的第一个行首（文件末尾时为 size_）
+    inline size_t line_start_at_or_after(size_t position) const {
+        if (position == 0 || position >= size_) {
+            return std::min(position, size_);
+        }
+        return data_[position - 1] == '\n' ? position : line_end(position);
+    }
+
+    // 从行首 position 起、limit 之前的第一条带时间戳的行
+    bool first_entry_from(size_t position, size_t limit, Entry& entry) const {
+        while (position < limit) {
+            const size_t next = line_end(position);
+            if (ParseLineTimestamp(data_ + position, data_ + next, entry.timestamp)) {
+                entry.begin = position;
+                entry.next = next;
+                return true;
+            }
+            position = next;
+        }
+        return false;
+    }
+
+    // 行首 position 之前最近一条带时间戳的行（续行据此归属）
+    bool timestamp_before(size_t position, time_t& timestamp) const {
+        while (position > 0) {
+            size_t begin = position - 1;
+            while (begin > 0 && data_[begin - 1] != '\n') {
+                --begin;
+            }
+            if (ParseLineTimestamp(data_ + begin, data_ + position, timestamp)) {
+                return true;
+            }
+            position = begin;
+        }
+        return false;
+    }
+
+    // 第一条时间戳不早于 target 的行的行首；f(p) = “p 之后首条带时间戳的行的时间”随 p 单调，对 p 二分
+    size_t lower_bound(time_t target) const {
+        size_t lo = 0;
+        size_t hi = size_;
+        while (lo < hi) {
+            const size_t mid = lo + (hi - lo) / 2;
+            Entry entry;
+            if (first_entry_from(line_start_at_or_after(mid), hi, entry) && entry.timestamp < target) {
+                lo = std::min(entry.next, hi); // mid 到该行末尾之间的位置 f 值相同，一起排除
+            }
+            else {
+                hi = mid;
+            }
+        }
+        Entry entry;
+        return first_entry_from(line_start_at_or_after(lo), size_, entry) ? entry.begin : size_;
+    }
+
+    void scan_chunk(size_t begin, size_t end, time_t lo, time_t hi, std::vector<std::pair<size_t, size_t>>& found) const {
+        time_t current = 0;
+        bool has_current = timestamp_before(begin, current);
+        for (size_t position = begin; position < end;) {
+            const size_t next = line_end(position);
+            time_t timestamp;
+            if (ParseLineTimestamp(data_ + position, data_ + next, timestamp)) {
+                current = timestamp;
+                has_current = true;
+            }
+            if (has_current && current >= lo && current < hi) {
+                if (!found.empty() && found.back().second == position) {
+                    found.back().second = next;
+                }
+                else {
+                    found.emplace_back(position, next);
+                }
+            }
+            position = next;
+        }
+    }
+
+    std::shared_ptr<CDMMappedFile> file_;
+    const char* data_;
+    size_t size_;
+};
+
+#endif // __DMLOGSCANNER_H__
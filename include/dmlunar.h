@@ -0,0 +1,269 @@
+﻿// Copyright (c) 2018 brinkqiang (brink.qiang@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __DMLUNAR_H__
+#define __DMLUNAR_H__
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include "dmcivil.h"
+
+// 农历（夏历）换算，覆盖农历 1900 年正月初一（公历 1900-01-31）至农历 2100 年除夕（公历 2101-01-28）。
+// 每年一个 17 位的压缩字：
+//   bit 0-3   闰月月份，0 表示无闰月
+//   bit 4-15  正月到腊月的大小月，bit (16 - m) 为 1 表示第 m 月 30 天，否则 29 天
+//   bit 16    闰月为大月（30 天）
+// 各年正月初一距 1970-01-01 的天数在编译期由上表累加得到，换算只需一次估算加常数次修正。
+
+struct DMLunarDate {
+    int year;           // 农历年，以正月初一为岁首
+    int month;          // 1-12
+    int day;            // 1-30
+    bool is_leap_month; // 闰月
+};
+
+// 农历数据表，仅供 CDMLunarCalendar 使用
+class CDMLunarTable {
+public:
+    static const int MIN_YEAR = 1900;
+    static const int YEAR_COUNT = 201;
+
+    static constexpr uint32_t LUNAR_INFO[YEAR_COUNT] = {
+        0x04bd8, 0x04ae0, 0x0a570, 0x054d5, 0x0d260, 0x0d950, 0x16554, 0x056a0, 0x09ad0, 0x055d2, // 1900-1909
+        0x04ae0, 0x0a5b6, 0x0a4d0, 0x0d250, 0x1d255, 0x0b540, 0x0d6a0, 0x0ada2, 0x095b0, 0x14977, // 1910-1919
+        0x04970, 0x0a4b0, 0x0b4b5, 0x06a50, 0x06d40, 0x1ab54, 0x02b60, 0x09570, 0x052f2, 0x04970, // 1920-1929
+        0x06566, 0x0d4a0, 0x0ea50, 0x16a95, 0x05ad0, 0x02b60, 0x186e3, 0x092e0, 0x1c8d7, 0x0c950, // 1930-1939
+        0x0d4a0, 0x1d8a6, 0x0b550, 0x056a0, 0x1a5b4, 0x025d0, 0x092d0, 0x0d2b2, 0x0a950, 0x0b557, // 1940-1949
+        0x06ca0, 0x0b550, 0x15355, 0x04da0, 0x0a5b0, 0x14573, 0x052b0, 0x0a9a8, 0x0e950, 0x06aa0, // 1950-1959
+        0x0aea6, 0x0ab50, 0x04b60, 0x0aae4, 0x0a570, 0x05260, 0x0f263, 0x0d950, 0x05b57, 0x056a0, // 1960-1969
+        0x096d0, 0x04dd5, 0x04ad0, 0x0a4d0, 0x0d4d4, 0x0d250, 0x0d558, 0x0b540, 0x0b6a0, 0x195a6, // 1970-1979
+        0x095b0, 0x049b0, 0x0a974, 0x0a4b0, 0x0b27a, 0x06a50, 0x06d40, 0x0af46, 0x0ab60, 0x09570, // 1980-1989
+        0x04af5, 0x04970, 0x064b0, 0x074a3, 0x0ea50, 0x06b58, 0x05ac0, 0x0ab60, 0x096d5, 0x092e0, // 1990-1999
+        0x0c960, 0x0d954, 0x0d4a0, 0x0da50, 0x07552, 0x056a0, 0x0abb7, 0x025d0, 0x092d0, 0x0cab5, // 2000-2009
+        0x0a950, 0x0b4a0, 0x0baa4, 0x0ad50, 0x055d9, 0x04ba0, 0x0a5b0, 0x15176, 0x052b0, 0x0a930, // 2010-2019
+        0x07954, 0x06aa0, 0x0ad50, 0x05b52, 0x04b60, 0x0a6e6, 0x0a4e0, 0x0d260, 0x0ea65, 0x0d530, // 2020-2029
+        0x05aa0, 0x076a3, 0x096d0, 0x04afb, 0x04ad0, 0x0a4d0, 0x1d0b6, 0x0d250, 0x0d520, 0x0dd45, // 2030-2039
+        0x0b5a0, 0x056d0, 0x055b2, 0x049b0, 0x0a577, 0x0a4b0, 0x0aa50, 0x1b255, 0x06d20, 0x0ada0, // 2040-2049
+        0x14b63, 0x09370, 0x049f8, 0x04970, 0x064b0, 0x168a6, 0x0ea50, 0x06b20, 0x1a6c4, 0x0aae0, // 2050-2059
+        0x092e0, 0x0d2e3, 0x0c960, 0x0d557, 0x0d4a0, 0x0da50, 0x05d55, 0x056a0, 0x0a6d0, 0x055d4, // 2060-2069
+        0x052d0, 0x0a9b8, 0x0a950, 0x0b4a0, 0x0b6a6, 0x0ad50, 0x055a0, 0x0aba4, 0x0a5b0, 0x052b0, // 2070-2079
+        0x0b273, 0x06930, 0x07337, 0x06aa0, 0x0ad50, 0x14b55, 0x04b60, 0x0a570, 0x054e4, 0x0d160, // 2080-2089
+        0x0e968, 0x0d520, 0x0daa0, 0x16aa6, 0x056d0, 0x04ae0, 0x0a9d4, 0x0a2d0, 0x0d150, 0x0f252, // 2090-2099
+        0x0d520,                                                                                  // 2100
+    };
+
+    struct NewYearTable {
+        long long days[YEAR_COUNT + 1]; // 末项为农历 2101 年正月初一
+    };
+
+    static constexpr int YearDaysFromInfo(uint32_t info) {
+        int days = 348; // 12 个小月
+        for (uint32_t bit = 0x8000u; bit > 0x8u; bit >>= 1) {
+            days += (info & bit) ? 1 : 0;
+        }
+        if ((info & 0xF) != 0) {
+            days += (info & 0x10000u) ? 30 : 29;
+        }
+        return days;
+    }
+
+    static constexpr NewYearTable BuildNewYearTable() {
+        NewYearTable table{};
+        table.days[0] = CDMCivil::DaysFromCivil(1900, 1, 31);
+        for (int i = 0; i < YEAR_COUNT; ++i) {
+            table.days[i + 1] = table.days[i] + YearDaysFromInfo(LUNAR_INFO[i]);
+        }
+        return table;
+    }
+};
+
+class CDMLunarCalendar {
+public:
+    static const int MIN_YEAR = 1900;
+    static const int MAX_YEAR = 2100;
+    static const int YEAR_COUNT = MAX_YEAR - MIN_YEAR + 1;
+    static_assert(YEAR_COUNT == CDMLunarTable::YEAR_COUNT, "lunar table size");
+
+    // 闰月月份，0 表示该年无闰月；超出范围返回 -1
+    static constexpr int LeapMonth(int year) {
+        return IsYearInRange(year) ? static_cast<int>(CDMLunarTable::LUNAR_INFO[year - MIN_YEAR] & 0xF) : -1;
+    }
+
+    // 某月天数（29/30），月份不存在时返回 0
+    static constexpr int MonthDays(int year, int month, bool is_leap_month) {
+        if (!IsYearInRange(year) || month < 1 || month > 12) {
+            return 0;
+        }
+        const uint32_t info = CDMLunarTable::LUNAR_INFO[year - MIN_YEAR];
+        if (is_leap_month) {
+            return static_cast<int>(info & 0xF) != month ? 0 : ((info & 0x10000u) ? 30 : 29);
+        }
+        return (info & (0x10000u >> month)) ? 30 : 29;
+    }
+
+    static constexpr int YearDays(int year) {
+        return IsYearInRange(year) ? static_cast<int>(NEW_YEAR_TABLE.days[year - MIN_YEAR + 1] - NEW_YEAR_TABLE.days[year - MIN_YEAR]) : 0;
+    }
+
+    // 正月初一距 1970-01-01 的天数
+    static constexpr long long NewYearDays(int year) {
+        return IsYearInRange(year) ? NEW_YEAR_TABLE.days[year - MIN_YEAR] : 0;
+    }
+
+    static constexpr bool IsYearInRange(int year) {
+        return year >= MIN_YEAR && year <= MAX_YEAR;
+    }
+
+    // 距 1970-01-01 的天数 -> 农历日期；超出范围返回 false
+    static bool FromDays(long long days, DMLunarDate& lunar) {
+        const long long first = NEW_YEAR_TABLE.days[0];
+        const long long last = NEW_YEAR_TABLE.days[YEAR_COUNT];
+        if (days < first || days >= last) {
+            return false;
+        }
+        // 按回归年估算年份，最多修正一两步
+        int index = static_cast<int>((days - first) * 10000 / 3652422);
+        if (index >= YEAR_COUNT) {
+            index = YEAR_COUNT - 1;
+        }
+        while (NEW_YEAR_TABLE.days[index] > days) {
+            --index;
+        }
+        while (NEW_YEAR_TABLE.days[index + 1] <= days) {
+            ++index;
+        }
+        const int year = MIN_YEAR + index;
+        const int leap = LeapMonth(year);
+        int offset = static_cast<int>(days - NEW_YEAR_TABLE.days[index]);
+        for (int month = 1; month <= 12; ++month) {
+            const int length = MonthDays(year, month, false);
+            if (offset < length) {
+                lunar = DMLunarDate{ year, month, offset + 1, false };
+                return true;
+            }
+            offset -= length;
+            if (month == leap) {
+                const int leap_length = MonthDays(year, month, true);
+                if (offset < leap_length) {
+                    lunar = DMLunarDate{ year, month, offset + 1, true };
+                    return true;
+                }
+                offset -= leap_length;
+            }
+        }
+        return false;
+    }
+
+    static bool FromSolar(int year, int month, int day, DMLunarDate& lunar) {
+        if (month < 1 || month > 12 || day < 1 || day > CDMCivil::DaysInMonth(year, month)) {
+            return false;
+        }
+        return FromDays(CDMCivil::DaysFromCivil(year, month, day), lunar);
+    }
+
+    // 农历日期 -> 距 1970-01-01 的天数；日期不存在（如无此闰月、小月三十）返回 false
+    static bool ToDays(const DMLunarDate& lunar, long long& days) {
+        const int length = MonthDays(lunar.year, lunar.month, lunar.is_leap_month);
+        if (length == 0 || lunar.day < 1 || lunar.day > length) {
+            return false;
+        }
+        const int leap = LeapMonth(lunar.year);
+        long long offset = 0;
+        for (int month = 1; month < lunar.month; ++month) {
+            offset += MonthDays(lunar.year, month, false);
+            if (month == leap) {
+                offset += MonthDays(lunar.year, month, true);
+            }
+        }
+        if (lunar.is_leap_month) {
+            offset += MonthDays(lunar.year, lunar.month, false);
+        }
+        days = NEW_YEAR_TABLE.days[lunar.year - MIN_YEAR] + offset + lunar.day - 1;
+        return true;
+    }
+
+    static bool ToSolar(const DMLunarDate& lunar, DMCivilDate& solar) {
+        long long days = 0;
+        if (!ToDays(lunar, days)) {
+            return false;
+        }
+        solar = CDMCivil::CivilFromDays(days);
+        return true;
+    }
+
+    // 干支纪年，例如 "甲辰"
+    static std::string GanZhiYear(int year) {
+        static const char* const stems[10] = { "甲", "乙", "丙", "丁", "戊", "己", "庚", "辛", "壬", "癸" };
+        static const char* const branches[12] = { "子", "丑", "寅", "卯", "辰", "巳", "午", "未", "申", "酉", "戌", "亥" };
+        const int cycle = static_cast<int>(CDMCivil::FloorMod(year - 4, 60));
+        return std::string(stems[cycle % 10]) + branches[cycle % 12];
+    }
+
+    // 生肖，例如 "龙"
+    static std::string Zodiac(int year) {
+        static const char* const animals[12] = { "鼠", "牛", "虎", "兔", "龙", "蛇", "马", "羊", "猴", "鸡", "狗", "猪" };
+        return animals[CDMCivil::FloorMod(year - 4, 12)];
+    }
+
+    // 传统写法，例如 "甲辰年冬月廿五"、"乙巳年闰六月初一"
+    static std::string ToChineseString(const DMLunarDate& lunar) {
+        static const char* const months[12] = { "正", "二", "三", "四", "五", "六", "七", "八", "九", "十", "冬", "腊" };
+        static const char* const tens[4] = { "初", "十", "廿", "三" };
+        static const char* const units[10] = { "十", "一", "二", "三", "四", "五", "六", "七", "八", "九" };
+        std::string result = GanZhiYear(lunar.year) + "年";
+        if (lunar.is_leap_month) {
+            result += "闰";
+        }
+        result += months[(lunar.month - 1) % 12];
+        result += "月";
+        if (lunar.day == 10) {
+            result += "初十";
+        }
+        else if (lunar.day == 20) {
+            result += "二十";
+        }
+        else if (lunar.day == 30) {
+            result += "三十";
+        }
+        else {
+            result += tens[lunar.day / 10];
+            result += units[lunar.day % 10];
+        }
+        return result;
+    }
+
+    // 数字写法 "YYYY-MM-DD"，闰月在月份前加 'L'，例如 "2025-L06-01"
+    static std::string ToNumericString(const DMLunarDate& lunar) {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%04d-%s%02d-%02d", lunar.year, lunar.is_leap_month ? "L" : "",
+            lunar.month, lunar.day);
+        return buffer;
+    }
+
+private:
+    static constexpr CDMLunarTable::NewYearTable NEW_YEAR_TABLE = CDMLunarTable::BuildNewYearTable();
+};
+
+static_assert(CDMLunarCalendar::NewYearDays(2024) == CDMCivil::DaysFromCivil(2024, 2, 10), "lunar new year 2024");
+static_assert(CDMLunarCalendar::NewYearDays(2100) == CDMCivil::DaysFromCivil(2100, 2, 9), "lunar new year 2100");
+static_assert(CDMLunarCalendar::LeapMonth(2025) == 6, "2025 has a leap sixth month");
+
+#endif // __DMLUNAR_H__
@@ -0,0 +1,141 @@
+﻿// Copyright (c) 2018 brinkqiang (brink.qiang@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __DMMAPPEDFILE_H__
+#define __DMMAPPEDFILE_H__
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// 只读映射整个文件，页面在首次访问时才读入。空文件不做映射，Data() 为 nullptr。
+class CDMMappedFile {
+public:
+    // 打开并映射，失败抛出 std::runtime_error
+    explicit CDMMappedFile(const std::string& path) : path_(path) {
+#ifdef _WIN32
+        file_ = ::CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file_ == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error("Failed to open file: '" + path + "'");
+        }
+        LARGE_INTEGER size;
+        if (!::GetFileSizeEx(file_, &size) || size.QuadPart < 0) {
+            ::CloseHandle(file_);
+            throw std::runtime_error("Failed to stat file: '" + path + "'");
+        }
+        size_ = static_cast<size_t>(size.QuadPart);
+        if (size_ == 0) {
+            return;
+        }
+        mapping_ = ::CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        const void* view = mapping_ != nullptr ? ::MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (view == nullptr) {
+            if (mapping_ != nullptr) {
+                ::CloseHandle(mapping_);
+            }
+            ::CloseHandle(file_);
+            throw std::runtime_error("Failed to map file: '" + path + "'");
+        }
+        data_ = static_cast<const char*>(view);
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Failed to open file: '" + path + "'");
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || st.st_size < 0) {
+            ::close(fd);
+            throw std::runtime_error("Failed to stat file: '" + path + "'");
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        if (size_ == 0) {
+            ::close(fd);
+            return;
+        }
+        void* mapped = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapped == MAP_FAILED) {
+            throw std::runtime_error("Failed to mmap file: '" + path + "'");
+        }
+        data_ = static_cast<const char*>(mapped);
+#endif
+    }
+
+    CDMMappedFile(const CDMMappedFile&) = delete;
+    CDMMappedFile& operator=(const CDMMappedFile&) = delete;
+
+    ~CDMMappedFile() {
+#ifdef _WIN32
+        if (data_ != nullptr) {
+            ::UnmapViewOfFile(data_);
+            ::CloseHandle(mapping_);
+        }
+        ::CloseHandle(file_);
+#else
+        if (data_ != nullptr) {
+            ::munmap(const_cast<char*>(data_), size_);
+        }
+#endif
+    }
+
+    // 提示内核按顺序预读（大文件整体扫描前调用），不支持时忽略
+    void AdviseSequential() const {
+#if !defined(_WIN32) && defined(MADV_SEQUENTIAL)
+        if (data_ != nullptr) {
+            ::madvise(const_cast<char*>(data_), size_, MADV_SEQUENTIAL);
+        }
+#endif
+    }
+
+    inline const char* Data() const {
+        return data_;
+    }
+
+    inline size_t Size() const {
+        return size_;
+    }
+
+    inline const std::string& GetPath() const {
+        return path_;
+    }
+
+private:
+    std::string path_;
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    HANDLE file_ = INVALID_HANDLE_VALUE;
+    HANDLE mapping_ = nullptr;
+#endif
+};
+
+#endif // __DMMAPPEDFILE_H__
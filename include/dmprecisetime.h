@@ -0,0 +1,265 @@
+// Copyright (c) 2018 brinkqiang (brink.qiang@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __DMPRECISETIME_H__
+#define __DMPRECISETIME_H__
+
+#include "dmdatetime.h"
+
+// 亚秒精度的时间段与时间点：内部只有一个 64 位有符号 tick 计数，全部为整数运算。
+// TicksPerSecond 取 1000 / 1000000 / 1000000000，对应毫秒 / 微秒 / 纳秒分辨率。
+// 纳秒精度的可表示范围约为 1677-09-21 至 2262-04-11，微秒、毫秒精度远大于 time_t 的常用范围。
+// 换算到更粗的分辨率时，时间段向零截断，时间点向下取整（1970 年之前的时刻也落在正确的那一秒）。
+
+class CDMPreciseTicks {
+public:
+    // 把 value（每秒 from 个 tick）换算为每秒 to 个 tick，向零截断
+    static constexpr long long Convert(long long value, long long from, long long to) {
+        return (to >= from) ? value * (to / from) : value / (from / to);
+    }
+
+    // 同上，但向下取整
+    static constexpr long long ConvertFloor(long long value, long long from, long long to) {
+        return (to >= from) ? value * (to / from) : CDMCivil::FloorDiv(value, from / to);
+    }
+
+    // 小数位数：1000 -> 3, 1000000 -> 6, 1000000000 -> 9
+    static constexpr int Digits(long long ticks_per_second) {
+        return ticks_per_second <= 1 ? 0 : 1 + Digits(ticks_per_second / 10);
+    }
+};
+
+template<long long TicksPerSecond>
+class CDMBasicTimeSpan {
+    static_assert(TicksPerSecond == 1000LL || TicksPerSecond == 1000000LL || TicksPerSecond == 1000000000LL,
+        "TicksPerSecond must be 1000, 1000000 or 1000000000");
+
+private:
+    int64_t ticks_;
+
+public:
+    static constexpr long long TICKS_PER_SECOND = TicksPerSecond;
+
+    constexpr explicit CDMBasicTimeSpan(int64_t ticks = 0) : ticks_(ticks) {}
+
+    static constexpr CDMBasicTimeSpan FromSeconds(long long seconds) {
+        return CDMBasicTimeSpan(seconds * TicksPerSecond);
+    }
+    static constexpr CDMBasicTimeSpan FromMilliseconds(long long milliseconds) {
+        return CDMBasicTimeSpan(CDMPreciseTicks::Convert(milliseconds, 1000LL, TicksPerSecond));
+    }
+    static constexpr CDMBasicTimeSpan FromMicroseconds(long long microseconds) {
+        return CDMBasicTimeSpan(CDMPreciseTicks::Convert(microseconds, 1000000LL, TicksPerSecond));
+    }
+    static constexpr CDMBasicTimeSpan FromNanoseconds(long long nanoseconds) {
+        return CDMBasicTimeSpan(CDMPreciseTicks::Convert(nanoseconds, 1000000000LL, TicksPerSecond));
+    }
+    static CDMBasicTimeSpan FromTimeSpan(const CDMTimeSpan& span) {
+        return FromSeconds(static_cast<long long>(span.GetTotalSeconds()));
+    }
+
+    constexpr int64_t GetTicks() const { return ticks_; }
+    constexpr long long GetTotalSeconds() const { return ticks_ / TicksPerSecond; }
+    constexpr long long GetTotalMilliseconds() const { return CDMPreciseTicks::Convert(ticks_, TicksPerSecond, 1000LL); }
+    constexpr long long GetTotalMicroseconds() const { return CDMPreciseTicks::Convert(ticks_, TicksPerSecond, 1000000LL); }
+    constexpr long long GetTotalNanoseconds() const { return CDMPreciseTicks::Convert(ticks_, TicksPerSecond, 1000000000LL); }
+
+    // 截断到整秒
+    CDMTimeSpan ToTimeSpan() const { return CDMTimeSpan(static_cast<time_t>(GetTotalSeconds())); }
+
+    constexpr CDMBasicTimeSpan operator+(const CDMBasicTimeSpan& other) const { return CDMBasicTimeSpan(ticks_ + other.ticks_); }
+    constexpr CDMBasicTimeSpan operator-(const CDMBasicTimeSpan& other) const { return CDMBasicTimeSpan(ticks_ - other.ticks_); }
+    constexpr CDMBasicTimeSpan operator-() const { return CDMBasicTimeSpan(-ticks_); }
+    constexpr CDMBasicTimeSpan operator*(long long factor) const { return CDMBasicTimeSpan(ticks_ * factor); }
+    constexpr CDMBasicTimeSpan operator/(long long divisor) const { return CDMBasicTimeSpan(ticks_ / divisor); }
+    constexpr bool operator<(const CDMBasicTimeSpan& other) const { return ticks_ < other.ticks_; }
+    constexpr bool operator>(const CDMBasicTimeSpan& other) const { return ticks_ > other.ticks_; }
+    constexpr bool operator<=(const CDMBasicTimeSpan& other) const { return ticks_ <= other.ticks_; }
+    constexpr bool operator>=(const CDMBasicTimeSpan& other) const { return ticks_ >= other.ticks_; }
+    constexpr bool operator==(const CDMBasicTimeSpan& other) const { return ticks_ == other.ticks_; }
+    constexpr bool operator!=(const CDMBasicTimeSpan& other) const { return ticks_ != other.ticks_; }
+};
+
+template<long long TicksPerSecond>
+class CDMBasicDateTime {
+    static_assert(TicksPerSecond == 1000LL || TicksPerSecond == 1000000LL || TicksPerSecond == 1000000000LL,
+        "TicksPerSecond must be 1000, 1000000 or 1000000000");
+
+private:
+    int64_t ticks_; // 距 1970-01-01 00:00:00 UTC 的 tick 数
+
+    static constexpr int FRACTION_DIGITS = CDMPreciseTicks::Digits(TicksPerSecond);
+
+    // 在整秒文本 scratch[0, length) 的 tail_length 个尾部字节之前插入 ".fff"
+    inline size_t insert_fraction(char* scratch, size_t length, size_t tail_length) const {
+        const size_t head = length - tail_length;
+        std::memmove(scratch + head + 1 + FRACTION_DIGITS, scratch + head, tail_length);
+        scratch[head] = '.';
+        long long fraction = GetSubSecondTicks();
+        for (int i = FRACTION_DIGITS; i > 0; --i) {
+            scratch[head + i] = static_cast<char>('0' + fraction % 10);
+            fraction /= 10;
+        }
+        return length + 1 + FRACTION_DIGITS;
+    }
+
+public:
+    typedef CDMBasicTimeSpan<TicksPerSecond> TimeSpan;
+
+    static constexpr long long TICKS_PER_SECOND = TicksPerSecond;
+
+    constexpr explicit CDMBasicDateTime(int64_t ticks_since_epoch = 0) : ticks_(ticks_since_epoch) {}
+
+    explicit CDMBasicDateTime(const CDMDateTime& dt)
+        : ticks_(static_cast<int64_t>(dt.GetTimestamp()) * TicksPerSecond) {}
+
+    // 本地时间的年月日时分秒 + 秒内的 tick 数
+    CDMBasicDateTime(int year, int month, int day, int hour, int minute, int second, long long sub_second_ticks = 0)
+        : ticks_(static_cast<int64_t>(CDMDateTime(year, month, day, hour, minute, second).GetTimestamp()) * TicksPerSecond
+            + sub_second_ticks) {}
+
+    static constexpr CDMBasicDateTime FromTicks(int64_t ticks_since_epoch) {
+        return CDMBasicDateTime(ticks_since_epoch);
+    }
+
+    static constexpr CDMBasicDateTime FromTimestamp(time_t seconds, long long sub_second_ticks = 0) {
+        return CDMBasicDateTime(static_cast<int64_t>(seconds) * TicksPerSecond + sub_second_ticks);
+    }
+
+    // 默认使用 CLOCK_REALTIME；高频场景可改用 CLOCK_SOURCE_TSC / CLOCK_SOURCE_REALTIME_COARSE
+    static CDMBasicDateTime Now(CDMClock::ClockSource source = CDMClock::CLOCK_SOURCE_REALTIME) {
+        const long long ns = static_cast<long long>(CDMClock::NowNanoseconds(source));
+        return CDMBasicDateTime(CDMPreciseTicks::ConvertFloor(ns, 1000000000LL, TicksPerSecond));
+    }
+
+    constexpr int64_t GetTicks() const { return ticks_; }
+
+    // 向下取整到所在的那一秒
+    constexpr time_t GetTimestamp() const {
+        return static_cast<time_t>(CDMCivil::FloorDiv(ticks_, TicksPerSecond));
+    }
+
+    // 秒内的 tick 数，[0, TicksPerSecond)
+    constexpr long long GetSubSecondTicks() const { return CDMCivil::FloorMod(ticks_, TicksPerSecond); }
+    constexpr int GetMillisecond() const { return static_cast<int>(CDMPreciseTicks::Convert(GetSubSecondTicks(), TicksPerSecond, 1000LL)); }   // 0-999
+    constexpr int GetMicrosecond() const { return static_cast<int>(CDMPreciseTicks::Convert(GetSubSecondTicks(), TicksPerSecond, 1000000LL)); } // 0-999999
+    constexpr int GetNanosecond() const { return static_cast<int>(CDMPreciseTicks::Convert(GetSubSecondTicks(), TicksPerSecond, 1000000000LL)); } // 0-999999999
+
+    // 截断到整秒的 CDMDateTime，用于取年月日等日历字段
+    CDMDateTime ToDateTime() const { return CDMDateTime::FromTimestamp(GetTimestamp()); }
+
+    constexpr CDMBasicDateTime AddTicks(long long ticks) const { return CDMBasicDateTime(ticks_ + ticks); }
+    constexpr CDMBasicDateTime AddSeconds(long long seconds) const { return AddTicks(seconds * TicksPerSecond); }
+    constexpr CDMBasicDateTime AddMilliseconds(long long milliseconds) const {
+        return AddTicks(CDMPreciseTicks::Convert(milliseconds, 1000LL, TicksPerSecond));
+    }
+    constexpr CDMBasicDateTime AddMicroseconds(long long microseconds) const {
+        return AddTicks(CDMPreciseTicks::Convert(microseconds, 1000000LL, TicksPerSecond));
+    }
+    constexpr CDMBasicDateTime AddNanoseconds(long long nanoseconds) const {
+        return AddTicks(CDMPreciseTicks::Convert(nanoseconds, 1000000000LL, TicksPerSecond));
+    }
+
+    constexpr CDMBasicDateTime operator+(const TimeSpan& span) const { return AddTicks(span.GetTicks()); }
+    constexpr CDMBasicDateTime operator-(const TimeSpan& span) const { return AddTicks(-span.GetTicks()); }
+    constexpr TimeSpan operator-(const CDMBasicDateTime& other) const { return TimeSpan(ticks_ - other.ticks_); }
+    constexpr bool operator<(const CDMBasicDateTime& other) const { return ticks_ < other.ticks_; }
+    constexpr bool operator>(const CDMBasicDateTime& other) const { return ticks_ > other.ticks_; }
+    constexpr bool operator<=(const CDMBasicDateTime& other) const { return ticks_ <= other.ticks_; }
+    constexpr bool operator>=(const CDMBasicDateTime& other) const { return ticks_ >= other.ticks_; }
+    constexpr bool operator==(const CDMBasicDateTime& other) const { return ticks_ == other.ticks_; }
+    constexpr bool operator!=(const CDMBasicDateTime& other) const { return ticks_ != other.ticks_; }
+
+    // "YYYY-MM-DD HH:MM:SS.fff"（本地时间，小数位数随分辨率为 3/6/9）
+    inline size_t ToString(char* buffer, size_t capacity) const {
+        char scratch[128];
+        const CDMDateTime dt = ToDateTime();
+        const size_t length = dt.format_local(scratch, 64, CDMDateTime::TO_STRING_STANDARD);
+        return CDMDateTime::finish_buffer(buffer, capacity, scratch, insert_fraction(scratch, length, 0));
+    }
+
+    // "YYYY-MM-DDTHH:MM:SS.fffZ"
+    inline size_t ToUTCString(char* buffer, size_t capacity) const {
+        char scratch[128];
+        const CDMDateTime dt = ToDateTime();
+        const size_t length = dt.format_utc(scratch);
+        return CDMDateTime::finish_buffer(buffer, capacity, scratch, insert_fraction(scratch, length, 1));
+    }
+
+    // "YYYY-MM-DDTHH:MM:SS.fff±hh:mm"
+    inline size_t ToISOString(char* buffer, size_t capacity) const {
+        char scratch[128];
+        const CDMDateTime dt = ToDateTime();
+        const size_t length = dt.format_iso(scratch);
+        return CDMDateTime::finish_buffer(buffer, capacity, scratch, insert_fraction(scratch, length, 6));
+    }
+
+    inline std::string ToString() const {
+        char buffer[128];
+        return std::string(buffer, ToString(buffer, sizeof(buffer)));
+    }
+
+    inline std::string ToUTCString() const {
+        char buffer[128];
+        return std::string(buffer, ToUTCString(buffer, sizeof(buffer)));
+    }
+
+    inline std::string ToISOString() const {
+        char buffer[128];
+        return std::string(buffer, ToISOString(buffer, sizeof(buffer)));
+    }
+
+    // 与 CDMDateTime::TryParse 相同的内置格式，小数秒按分辨率向下截断（最多读取 9 位）
+    inline static bool TryParse(const char* str, size_t length, CDMBasicDateTime& result) {
+        time_t utc = 0;
+        long nanoseconds = 0;
+        if (str == nullptr || !CDMDateTime::parse_builtin(str, str + length, false, utc, &nanoseconds)) {
+            return false;
+        }
+        const long long limit = INT64_MAX / TicksPerSecond - 1;
+        if (static_cast<long long>(utc) > limit || static_cast<long long>(utc) < -limit) {
+            return false;
+        }
+        result = FromTimestamp(utc, CDMPreciseTicks::Convert(nanoseconds, 1000000000LL, TicksPerSecond));
+        return true;
+    }
+
+    inline static bool TryParse(std::string_view str, CDMBasicDateTime& result) {
+        return TryParse(str.data(), str.size(), result);
+    }
+
+    inline static CDMBasicDateTime Parse(const std::string& str) {
+        CDMBasicDateTime result;
+        if (!TryParse(str.data(), str.size(), result)) {
+            throw std::runtime_error("Failed to parse date/time: '" + str + "'");
+        }
+        return result;
+    }
+};
+
+typedef CDMBasicTimeSpan<1000LL> CDMTimeSpanMs;
+typedef CDMBasicTimeSpan<1000000LL> CDMTimeSpanUs;
+typedef CDMBasicTimeSpan<1000000000LL> CDMTimeSpanNs;
+
+typedef CDMBasicDateTime<1000LL> CDMDateTimeMs;
+typedef CDMBasicDateTime<1000000LL> CDMDateTimeUs;
+typedef CDMBasicDateTime<1000000000LL> CDMDateTimeNs;
+
+#endif // __DMPRECISETIME_H__
@@ -0,0 +1,726 @@
+﻿// Copyright (c) 2018 brinkqiang (brink.qiang@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __DMRRULE_H__
+#define __DMRRULE_H__
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "dmdatetime.h"
+
+// RFC 5545 RRULE 的按需展开，支持 FREQ=YEARLY/MONTHLY/WEEKLY/DAILY、INTERVAL、BYMONTH、BYMONTHDAY、
+// BYDAY（可带序数，如 1MO、-1FR）、BYSETPOS、COUNT、UNTIL 与 WKST。
+// 展开按 FREQ 划分周期（年 / 月 / 周 / 日）：每次只生成一个周期内的候选日期，依次用 BYMONTH、BYMONTHDAY、BYDAY
+// 过滤后再按 BYSETPOS 取位置，时分秒沿用 DTSTART 的本地时间。早于 DTSTART 的日期不计入（与 python-dateutil 一致，
+// DTSTART 本身不匹配规则时不会出现在结果中）。
+// 没有 COUNT 的规则可以由任意时刻直接算出所在周期，定位“某时刻之后的第一次”只需展开一两个周期；
+// 有 COUNT 的规则需要知道之前已产生的次数：解析时按周期顺序计数一遍（直到 COUNT 用完、UNTIL 或满一个 400 年循环为止），
+// 每隔若干周期（日 64、周 16、月 4、年 1）记一个累计值；定位时整循环按每循环次数相乘，循环内只需从最近的记录点展开剩余几个周期。
+
+class CDMRecurrenceRule {
+public:
+    enum Frequency {
+        FREQ_DAILY = 0,
+        FREQ_WEEKLY,
+        FREQ_MONTHLY,
+        FREQ_YEARLY,
+    };
+
+    // 逐个产出时间点，不预先展开整个序列
+    class Iterator {
+    public:
+        Iterator() : rule_(nullptr) {}
+
+        // 取下一次，序列结束时返回 false
+        bool Next(CDMDateTime& occurrence) {
+            while (rule_ != nullptr) {
+                if (position_ < days_.size()) {
+                    if (rule_->count_ > 0 && emitted_ >= rule_->count_) {
+                        break;
+                    }
+                    const long long day = days_[position_++];
+                    // 整天早于起点或定位时刻的候选不必构造时间
+                    if (day < rule_->day0_) {
+                        continue;
+                    }
+                    if (skip_until_ && day < skip_day_) {
+                        ++emitted_;
+                        continue;
+                    }
+                    const CDMDateTime candidate = rule_->at_day(day);
+                    if (candidate < rule_->start_ || (skip_until_ && !(skip_after_ < candidate))) {
+                        if (!(candidate < rule_->start_)) {
+                            ++emitted_;
+                        }
+                        continue;
+                    }
+                    if (rule_->has_until_ && rule_->until_ < candidate) {
+                        break;
+                    }
+                    ++emitted_;
+                    skip_until_ = false;
+                    occurrence = candidate;
+                    return true;
+                }
+                if (!advance()) {
+                    break;
+                }
+            }
+            rule_ = nullptr;
+            return false;
+        }
+
+    private:
+        friend class CDMRecurrenceRule;
+
+        // 展开下一个非空周期；连续空周期超过一个 400 年公历周期时认为规则不再产生结果
+        bool advance() {
+            for (long long guard = 0; guard < rule_->empty_period_limit(); ++guard) {
+                const long long period = period_++;
+                if (rule_->period_begin_day(period) > rule_->last_day_) {
+                    return false;
+                }
+                rule_->expand(period, days_, nth_hits_, selected_);
+                position_ = 0;
+                if (!days_.empty()) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        const CDMRecurrenceRule* rule_;
+        long long period_ = 0;
+        std::vector<long long> days_;
+        std::vector<uint8_t> nth_hits_;
+        std::vector<long long> selected_;
+        size_t position_ = 0;
+        long long emitted_ = 0;
+        bool skip_until_ = false; // 跳过不晚于 skip_after_ 的时间点（但仍计入 COUNT）
+        CDMDateTime skip_after_;
+        long long skip_day_ = 0;  // skip_after_ 的本地日期
+    };
+
+    CDMRecurrenceRule() = default;
+
+    // 解析 RRULE（可带 "RRULE:" 前缀），dtstart 为序列起点；不支持的规则部分或格式错误返回 false
+    static bool TryParse(std::string_view text, const CDMDateTime& dtstart, CDMRecurrenceRule& result) {
+        CDMRecurrenceRule rule;
+        rule.start_ = dtstart;
+        if (text.substr(0, 6) == "RRULE:") {
+            text.remove_prefix(6);
+        }
+        bool has_freq = false;
+        while (!text.empty()) {
+            const size_t semicolon = text.find(';');
+            std::string_view part = text.substr(0, semicolon);
+            text = semicolon == std::string_view::npos ? std::string_view() : text.substr(semicolon + 1);
+            if (part.empty()) {
+                continue;
+            }
+            const size_t equal = part.find('=');
+            if (equal == std::string_view::npos) {
+                return false;
+            }
+            const std::string_view name = part.substr(0, equal);
+            const std::string_view value = part.substr(equal + 1);
+            if (name == "FREQ") {
+                if (value == "DAILY") {
+                    rule.frequency_ = FREQ_DAILY;
+                }
+                else if (value == "WEEKLY") {
+                    rule.frequency_ = FREQ_WEEKLY;
+                }
+                else if (value == "MONTHLY") {
+                    rule.frequency_ = FREQ_MONTHLY;
+                }
+                else if (value == "YEARLY") {
+                    rule.frequency_ = FREQ_YEARLY;
+                }
+                else {
+                    return false;
+                }
+                has_freq = true;
+            }
+            else if (name == "INTERVAL") {
+                long long interval = 0;
+                if (!parse_integer(value, interval) || interval < 1 || interval > 100000) {
+                    return false;
+                }
+                rule.interval_ = interval;
+            }
+            else if (name == "COUNT") {
+                long long count = 0;
+                if (!parse_integer(value, count) || count < 1) {
+                    return false;
+                }
+                rule.count_ = count;
+            }
+            else if (name == "UNTIL") {
+                if (!parse_until(value, rule.until_)) {
+                    return false;
+                }
+                rule.has_until_ = true;
+            }
+            else if (name == "WKST") {
+                if (value.size() != 2 || (rule.week_start_ = weekday_from_name(value)) < 0) {
+                    return false;
+                }
+            }
+            else if (name == "BYMONTH") {
+                if (!parse_list(value, [&rule](long long v) {
+                    if (v < 1 || v > 12) {
+                        return false;
+                    }
+                    rule.months_ |= static_cast<uint16_t>(1u << v);
+                    return true;
+                })) {
+                    return false;
+                }
+            }
+            else if (name == "BYMONTHDAY") {
+                if (!parse_list(value, [&rule](long long v) {
+                    if (v == 0 || v < -31 || v > 31) {
+                        return false;
+                    }
+                    if (v > 0) {
+                        rule.month_days_ |= 1ULL << v;
+                    }
+                    else {
+                        rule.month_days_from_end_ |= 1ULL << -v;
+                    }
+                    return true;
+                })) {
+                    return false;
+                }
+            }
+            else if (name == "BYSETPOS") {
+                if (!parse_list(value, [&rule](long long v) {
+                    if (v == 0 || v < -366 || v > 366) {
+                        return false;
+                    }
+                    rule.set_positions_.push_back(static_cast<int>(v));
+                    return true;
+                })) {
+                    return false;
+                }
+            }
+            else if (name == "BYDAY") {
+                if (!parse_by_day(value, rule)) {
+                    return false;
+                }
+            }
+            else {
+                return false; // BYHOUR、BYWEEKNO、BYYEARDAY 等暂不支持
+            }
+        }
+        if (!has_freq || (rule.count_ > 0 && rule.has_until_)) {
+            return false;
+        }
+        rule.finish();
+        result = rule;
+        return true;
+    }
+
+    // 解析失败抛出 std::runtime_error
+    static CDMRecurrenceRule Parse(std::string_view text, const CDMDateTime& dtstart) {
+        CDMRecurrenceRule rule;
+        if (!TryParse(text, dtstart, rule)) {
+            throw std::runtime_error("Invalid RRULE: '" + std::string(text) + "'");
+        }
+        return rule;
+    }
+
+    inline Frequency GetFrequency() const {
+        return frequency_;
+    }
+
+    inline const CDMDateTime& GetStart() const {
+        return start_;
+    }
+
+    // 从头开始的迭代器
+    Iterator Begin() const {
+        Iterator it;
+        it.rule_ = this;
+        return it;
+    }
+
+    // 从严格晚于 instant 的第一次开始的迭代器
+    Iterator After(const CDMDateTime& instant) const {
+        Iterator it;
+        it.rule_ = this;
+        if (instant < start_) {
+            return it;
+        }
+        const long long day = local_days(instant);
+        long long period = period_of(CDMCivil::CivilFromDays(day));
+        if (period < 0) {
+            period = 0;
+        }
+        if (count_ > 0) {
+            // COUNT 要求知道之前已经产生了多少次
+            it.emitted_ = emitted_before(period, it);
+            it.days_.clear();
+        }
+        it.period_ = period;
+        it.skip_until_ = true;
+        it.skip_after_ = instant;
+        it.skip_day_ = day;
+        return it;
+    }
+
+    // 严格晚于 instant 的下一次，没有时返回 false
+    bool GetNextOccurrence(const CDMDateTime& instant, CDMDateTime& next) const {
+        Iterator it = After(instant);
+        return it.Next(next);
+    }
+
+    // 依次写出 [from, to) 内的时间点，最多 max_count 个，返回写出的个数
+    size_t Expand(const CDMDateTime& from, const CDMDateTime& to, std::vector<CDMDateTime>& out, size_t max_count) const {
+        Iterator it = After(from.AddSeconds(-1));
+        size_t written = 0;
+        CDMDateTime occurrence;
+        while (written < max_count && it.Next(occurrence) && occurrence < to) {
+            out.push_back(occurrence);
+            ++written;
+        }
+        return written;
+    }
+
+private:
+    struct NthWeekday {
+        int weekday; // 0=周日
+        int nth;     // 正数为第 n 个，负数为倒数第 n 个
+    };
+
+    static bool parse_integer(std::string_view text, long long& value) {
+        bool negative = false;
+        if (!text.empty() && (text[0] == '+' || text[0] == '-')) {
+            negative = text[0] == '-';
+            text.remove_prefix(1);
+        }
+        if (text.empty() || text.size() > 9) {
+            return false;
+        }
+        long long result = 0;
+        for (char c : text) {
+            if (c < '0' || c > '9') {
+                return false;
+            }
+            result = result * 10 + (c - '0');
+        }
+        value = negative ? -result : result;
+        return true;
+    }
+
+    template<typename Handler>
+    static bool parse_list(std::string_view text, Handler handler) {
+        if (text.empty()) {
+            return false;
+        }
+        while (true) {
+            const size_t comma = text.find(',');
+            long long value = 0;
+            if (!parse_integer(text.substr(0, comma), value) || !handler(value)) {
+                return false;
+            }
+            if (comma == std::string_view::npos) {
+                return true;
+            }
+            text = text.substr(comma + 1);
+        }
+    }
+
+    static int weekday_from_name(std::string_view name) {
+        static const char* const names[7] = { "SU", "MO", "TU", "WE", "TH", "FR", "SA" };
+        for (int i = 0; i < 7; ++i) {
+            if (name == names[i]) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    static bool parse_by_day(std::string_view text, CDMRecurrenceRule& rule) {
+        if (text.empty()) {
+            return false;
+        }
+        while (true) {
+            const size_t comma = text.find(',');
+            std::string_view item = text.substr(0, comma);
+            if (item.size() < 2) {
+                return false;
+            }
+            const int weekday = weekday_from_name(item.substr(item.size() - 2));
+            if (weekday < 0) {
+                return false;
+            }
+            item.remove_suffix(2);
+            if (item.empty()) {
+                rule.weekdays_ |= static_cast<uint8_t>(1u << weekday);
+            }
+            else {
+                long long nth = 0;
+                if (!parse_integer(item, nth) || nth == 0 || nth < -53 || nth > 53) {
+                    return false;
+                }
+                rule.nth_weekdays_.push_back(NthWeekday{ weekday, static_cast<int>(nth) });
+            }
+            if (comma == std::string_view::npos) {
+                return true;
+            }
+            text = text.substr(comma + 1);
+        }
+    }
+
+    // YYYYMMDD[THHMMSS[Z]]；只有日期时包含当天全天，带 Z 为 UTC，否则为本地时间
+    static bool parse_until(std::string_view text, CDMDateTime& until) {
+        long long date = 0;
+        if (text.size() < 8 || !parse_integer(text.substr(0, 8), date)) {
+            return false;
+        }
+        const int year = static_cast<int>(date / 10000);
+        const int month = static_cast<int>(date / 100 % 100);
+        const int day = static_cast<int>(date % 100);
+        if (month < 1 || month > 12 || day < 1 || day > CDMCivil::DaysInMonth(year, month)) {
+            return false;
+        }
+        if (text.size() == 8) {
+            until = CDMDateTime(year, month, day, 23, 59, 59);
+            return true;
+        }
+        long long time = 0;
+        if ((text.size() != 15 && text.size() != 16) || text[8] != 'T' || !parse_integer(text.substr(9, 6), time)) {
+            return false;
+        }
+        const int hour = static_cast<int>(time / 10000);
+        const int minute = static_cast<int>(time / 100 % 100);
+        const int second = static_cast<int>(time % 100);
+        if (hour > 23 || minute > 59 || second > 60) {
+            return false;
+        }
+        if (text.size() == 16) {
+            if (text[15] != 'Z') {
+                return false;
+            }
+            until = CDMDateTime::FromTimestamp(static_cast<time_t>(
+                CDMCivil::SecondsFromCivil(year, month, day, hour, minute, second)));
+            return true;
+        }
+        until = CDMDateTime(year, month, day, hour, minute, second);
+        return true;
+    }
+
+    static inline long long local_days(const CDMDateTime& when) {
+        return CDMCivil::DaysFromCivil(when.GetYear(), when.GetMonth(), when.GetDay());
+    }
+
+    // 补齐 RFC 5545 的隐含规则，并预先算好各周期的起点
+    void finish() {
+        const long long day0 = local_days(start_);
+        const DMCivilDate date0 = CDMCivil::CivilFromDays(day0);
+        if (weekdays_ == 0 && nth_weekdays_.empty() && month_days_ == 0 && month_days_from_end_ == 0) {
+            // 没有 BYDAY / BYMONTHDAY 时沿用 DTSTART 的日期
+            if (frequency_ == FREQ_YEARLY) {
+                if (months_ == 0) {
+                    months_ = static_cast<uint16_t>(1u << date0.month);
+                }
+                month_days_ = 1ULL << date0.day;
+            }
+            else if (frequency_ == FREQ_MONTHLY) {
+                month_days_ = 1ULL << date0.day;
+            }
+            else if (frequency_ == FREQ_WEEKLY) {
+                weekdays_ = static_cast<uint8_t>(1u << CDMCivil::WeekdayFromDays(day0));
+            }
+        }
+        if (frequency_ < FREQ_MONTHLY) {
+            // 周、日频率下序数没有意义，按普通星期处理
+            for (const NthWeekday& nth : nth_weekdays_) {
+                weekdays_ |= static_cast<uint8_t>(1u << nth.weekday);
+            }
+            nth_weekdays_.clear();
+        }
+        std::sort(set_positions_.begin(), set_positions_.end());
+        set_positions_.erase(std::unique(set_positions_.begin(), set_positions_.end()), set_positions_.end());
+        hour_ = start_.GetHour();
+        minute_ = start_.GetMinute();
+        second_ = start_.GetSecond();
+        year0_ = date0.year;
+        month0_ = static_cast<long long>(date0.year) * 12 + date0.month - 1;
+        week0_ = day0 - CDMCivil::FloorMod(CDMCivil::WeekdayFromDays(day0) - week_start_, 7);
+        day0_ = day0;
+        last_day_ = has_until_ ? local_days(until_) : CDMCivil::DaysFromCivil(9999, 12, 31);
+        build_count_index();
+    }
+
+    // COUNT 计数索引的记录间隔（周期数），各频率下定位时最多补展开约两个月的日期
+    long long checkpoint_periods() const {
+        static const long long spacing[4] = { 64, 16, 4, 1 };
+        return spacing[frequency_];
+    }
+
+    // 一个 400 年公历循环内的日、周、月、年数；跨过整数个循环后日期与星期完全重复
+    long long cycle_units() const {
+        static const long long cycle[4] = { 146097, 20871, 4800, 400 };
+        return cycle[frequency_];
+    }
+
+    static long long gcd(long long a, long long b) {
+        while (b != 0) {
+            const long long r = a % b;
+            a = b;
+            b = r;
+        }
+        return a;
+    }
+
+    inline bool before_start(long long day) const {
+        return day < day0_ || (day == day0_ && at_day(day) < start_);
+    }
+
+    // COUNT 规则的计数索引：周期 p 的候选（不扣除 DTSTART 之前的）每隔 checkpoint_periods() 个周期记一次前缀和。
+    // 第 p 与 p + cycle_periods_ 个周期相差整数个 400 年循环，候选个数相同，因此只需统计一个循环；
+    // 循环内 COUNT 已用完或越过 UNTIL 时提前结束，并记下此后不再产生结果的第一个周期
+    void build_count_index() {
+        count_checkpoints_.clear();
+        cycle_periods_ = cycle_units() / gcd(cycle_units(), interval_);
+        cycle_count_ = 0;
+        skipped_before_start_ = 0;
+        exhausted_period_ = -1;
+        if (count_ <= 0) {
+            return;
+        }
+        std::vector<long long> days;
+        std::vector<uint8_t> nth_hits;
+        std::vector<long long> selected;
+        long long total = 0;
+        for (long long period = 0; period < cycle_periods_; ++period) {
+            if (period % checkpoint_periods() == 0) {
+                count_checkpoints_.push_back(total);
+            }
+            if (period_begin_day(period) > last_day_) {
+                exhausted_period_ = period;
+                return;
+            }
+            expand(period, days, nth_hits, selected);
+            if (period == 0) {
+                for (long long day : days) {
+                    skipped_before_start_ += before_start(day) ? 1 : 0;
+                }
+            }
+            total += static_cast<long long>(days.size());
+            if (total - skipped_before_start_ >= count_) {
+                exhausted_period_ = period + 1;
+                return;
+            }
+        }
+        cycle_count_ = total;
+    }
+
+    // 周期 period 之前已产生的次数（不超过 COUNT）
+    long long emitted_before(long long period, Iterator& it) const {
+        if (exhausted_period_ >= 0 && period >= exhausted_period_) {
+            return count_;
+        }
+        const long long offset = period % cycle_periods_;
+        const long long checkpoint = offset / checkpoint_periods();
+        long long total = period / cycle_periods_ * cycle_count_ + count_checkpoints_[static_cast<size_t>(checkpoint)];
+        // 余下不足一个记录间隔的周期逐个展开（与第 period 个周期相差整数个循环，日历相同）
+        for (long long p = checkpoint * checkpoint_periods(); p < offset; ++p) {
+            expand(p, it.days_, it.nth_hits_, it.selected_);
+            total += static_cast<long long>(it.days_.size());
+        }
+        return std::min(total - skipped_before_start_, count_);
+    }
+
+    // 日期所在周期的编号（相对 DTSTART 所在周期，已按 INTERVAL 向下取整）
+    long long period_of(const DMCivilDate& date) const {
+        const long long days = CDMCivil::DaysFromCivil(date.year, date.month, date.day);
+        switch (frequency_) {
+        case FREQ_YEARLY:
+            return CDMCivil::FloorDiv(date.year - year0_, interval_);
+        case FREQ_MONTHLY:
+            return CDMCivil::FloorDiv(static_cast<long long>(date.year) * 12 + date.month - 1 - month0_, interval_);
+        case FREQ_WEEKLY:
+            return CDMCivil::FloorDiv(CDMCivil::FloorDiv(days - week0_, 7), interval_);
+        default:
+            return CDMCivil::FloorDiv(days - day0_, interval_);
+        }
+    }
+
+    long long period_begin_day(long long period) const {
+        switch (frequency_) {
+        case FREQ_YEARLY:
+            return CDMCivil::DaysFromCivil(year0_ + period * interval_, 1, 1);
+        case FREQ_MONTHLY: {
+            const long long month = month0_ + period * interval_;
+            return CDMCivil::DaysFromCivil(CDMCivil::FloorDiv(month, 12), static_cast<int>(CDMCivil::FloorMod(month, 12)) + 1, 1);
+        }
+        case FREQ_WEEKLY:
+            return week0_ + period * interval_ * 7;
+        default:
+            return day0_ + period * interval_;
+        }
+    }
+
+    long long empty_period_limit() const {
+        return cycle_units() / interval_ + 1;
+    }
+
+    inline CDMDateTime at_day(long long day) const {
+        const DMCivilDate date = CDMCivil::CivilFromDays(day);
+        return CDMDateTime(date.year, date.month, date.day, hour_, minute_, second_);
+    }
+
+    // 把 [first, last] 内各个序数星期对应的日期标记到 hits（下标相对 base）
+    void mark_nth_weekdays(long long first, long long last, long long base, std::vector<uint8_t>& hits) const {
+        const int first_weekday = CDMCivil::WeekdayFromDays(first);
+        const int last_weekday = CDMCivil::WeekdayFromDays(last);
+        for (const NthWeekday& nth : nth_weekdays_) {
+            long long day;
+            if (nth.nth > 0) {
+                day = first + (nth.weekday - first_weekday + 7) % 7 + (nth.nth - 1) * 7LL;
+            }
+            else {
+                day = last - (last_weekday - nth.weekday + 7) % 7 + (nth.nth + 1) * 7LL;
+            }
+            if (day >= first && day <= last) {
+                hits[static_cast<size_t>(day - base)] = 1;
+            }
+        }
+    }
+
+    // 展开一个周期，结果按时间排序写入 days（距 1970-01-01 的天数）；nth_hits、selected 为调用方提供的缓冲区
+    void expand(long long period, std::vector<long long>& days, std::vector<uint8_t>& nth_hits, std::vector<long long>& selected) const {
+        days.clear();
+        const long long begin = period_begin_day(period);
+        long long end;
+        switch (frequency_) {
+        case FREQ_YEARLY:
+            end = CDMCivil::DaysFromCivil(year0_ + period * interval_ + 1, 1, 1);
+            break;
+        case FREQ_MONTHLY: {
+            const long long month = month0_ + period * interval_ + 1;
+            end = CDMCivil::DaysFromCivil(CDMCivil::FloorDiv(month, 12), static_cast<int>(CDMCivil::FloorMod(month, 12)) + 1, 1);
+            break;
+        }
+        case FREQ_WEEKLY:
+            end = begin + 7;
+            break;
+        default:
+            end = begin + 1;
+            break;
+        }
+        // 序数星期的作用范围：MONTHLY 或带 BYMONTH 的 YEARLY 为当月，否则为当年
+        const bool has_nth = !nth_weekdays_.empty();
+        if (has_nth) {
+            nth_hits.assign(static_cast<size_t>(end - begin), 0);
+            if (frequency_ == FREQ_YEARLY && months_ == 0) {
+                mark_nth_weekdays(begin, end - 1, begin, nth_hits);
+            }
+            else {
+                for (long long first = begin; first < end;) {
+                    const DMCivilDate date = CDMCivil::CivilFromDays(first);
+                    const long long last = first + CDMCivil::DaysInMonth(date.year, date.month) - 1;
+                    if (months_ == 0 || ((months_ >> date.month) & 1u)) {
+                        mark_nth_weekdays(first, last, begin, nth_hits);
+                    }
+                    first = last + 1;
+                }
+            }
+        }
+        const bool has_weekday = weekdays_ != 0 || has_nth;
+        const bool has_month_day = month_days_ != 0 || month_days_from_end_ != 0;
+        DMCivilDate date = CDMCivil::CivilFromDays(begin);
+        int days_in_month = CDMCivil::DaysInMonth(date.year, date.month);
+        int weekday = CDMCivil::WeekdayFromDays(begin);
+        for (long long day = begin; day < end; ++day) {
+            bool keep = months_ == 0 || ((months_ >> date.month) & 1u);
+            if (keep && has_month_day) {
+                keep = ((month_days_ >> date.day) & 1u) || ((month_days_from_end_ >> (days_in_month - date.day + 1)) & 1u);
+            }
+            if (keep && has_weekday) {
+                keep = ((weekdays_ >> weekday) & 1u) || (has_nth && nth_hits[static_cast<size_t>(day - begin)]);
+            }
+            if (keep) {
+                days.push_back(day);
+            }
+            // 逐日推进公历日期
+            weekday = weekday == 6 ? 0 : weekday + 1;
+            if (++date.day > days_in_month) {
+                date.day = 1;
+                if (++date.month > 12) {
+                    date.month = 1;
+                    ++date.year;
+                }
+                days_in_month = CDMCivil::DaysInMonth(date.year, date.month);
+            }
+        }
+        if (!set_positions_.empty() && !days.empty()) {
+            selected.clear();
+            const long long size = static_cast<long long>(days.size());
+            for (int position : set_positions_) {
+                const long long index = position > 0 ? position - 1 : size + position;
+                if (index >= 0 && index < size) {
+                    selected.push_back(days[static_cast<size_t>(index)]);
+                }
+            }
+            std::sort(selected.begin(), selected.end());
+            selected.erase(std::unique(selected.begin(), selected.end()), selected.end());
+            days.swap(selected);
+        }
+    }
+
+    Frequency frequency_ = FREQ_DAILY;
+    long long interval_ = 1;
+    long long count_ = 0;
+    bool has_until_ = false;
+    CDMDateTime until_;
+    CDMDateTime start_;
+    int week_start_ = 1; // WKST，默认周一
+    uint16_t months_ = 0;
+    uint64_t month_days_ = 0;
+    uint64_t month_days_from_end_ = 0;
+    uint8_t weekdays_ = 0;
+    std::vector<NthWeekday> nth_weekdays_;
+    std::vector<int> set_positions_;
+    int hour_ = 0;
+    int minute_ = 0;
+    int second_ = 0;
+    long long year0_ = 0;
+    long long month0_ = 0;
+    long long week0_ = 0;
+    long long day0_ = 0;
+    long long last_day_ = 0;
+
+    std::vector<long long> count_checkpoints_;
+    long long cycle_periods_ = 1;         // 日历重复一次所需的周期数
+    long long cycle_count_ = 0;           // 一个循环内的候选个数
+    long long skipped_before_start_ = 0;  // 第 0 个周期中早于 DTSTART 的候选个数
+    long long exhausted_period_ = -1;     // 从该周期起不再产生结果，-1 表示一个循环内未用完
+};
+
+#endif // __DMRRULE_H__
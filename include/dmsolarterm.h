@@ -0,0 +1,394 @@
+﻿// Copyright (c) 2018 brinkqiang (brink.qiang@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __DMSOLARTERM_H__
+#define __DMSOLARTERM_H__
+
+#include <cstdint>
+#include <ctime>
+#include "dmcivil.h"
+
+// 二十四节气，覆盖公历 1900-2100 年。
+// 交节时刻离线按 VSOP87（截断项）+ 章动、光行差求太阳视黄经，再扣除 ΔT 得到 UT，精确到分钟。
+// 每个节气取 201 年中最早出现的北京时间日期作为基准日，表中只存交节时刻距该基准日 00:00（北京时间）
+// 的分钟数（0-4687，uint16），查询时由 CDMCivil 的日期算法还原，不做任何天文计算。
+// 节气编号按公历年内顺序：0 = 小寒（太阳黄经 285°），每个节气 +15°，23 = 冬至。
+
+class CDMSolarTermTable {
+public:
+    static const int MIN_YEAR = 1900;
+    static const int YEAR_COUNT = 201;
+    static const int TERM_COUNT = 24;
+
+    static constexpr unsigned char BASE_MONTH[TERM_COUNT] = {
+        1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12
+    };
+    static constexpr unsigned char BASE_DAY[TERM_COUNT] = {
+        4, 19, 3, 18, 4, 19, 4, 19, 4, 20, 4, 20, 6, 22, 6, 22, 6, 22, 7, 22, 6, 21, 6, 21
+    };
+
+    static constexpr uint16_t MINUTE_OFFSET[YEAR_COUNT][TERM_COUNT] = {
+        { 3004, 2613, 2272, 2041, 3382, 3459, 2273, 2727, 3355, 2717, 3639, 3220, 2830, 2436, 3411, 2840, 3557, 2660, 3013, 3175, 3160, 2988, 2696, 2322 }, // 1900
+        { 3353, 2957, 2620, 2385, 3731, 3804, 2625, 3074, 3711, 3065, 3997, 3568, 3188, 2784, 3766, 3188, 3910, 3009, 3367, 3526, 3515, 3341, 3053, 2677 }, // 1901
+        { 3712, 3312, 2978, 2740, 4088, 4157, 2978, 3424, 4059, 3414, 4340, 3915, 3526, 3130, 4102, 3533, 4247, 3355, 3705, 3876, 3858, 3695, 3401, 3036 }, // 1902
+        { 4064, 3674, 3331, 3101, 4439, 4515, 3326, 3779, 4406, 3765, 4687, 4265, 3877, 3479, 4456, 3882, 4602, 3704, 4062, 4223, 4213, 4041, 3755, 3380 }, // 1903
+        { 4417, 4018, 3684, 3445, 3352, 3419, 2239, 2682, 3319, 2669, 3601, 3172, 2792, 2390, 3372, 2796, 3518, 2620, 2976, 3139, 3125, 2956, 2665, 2294 }, // 1904
+        { 3327, 2932, 2596, 2361, 3706, 3778, 2595, 3044, 3674, 3031, 3954, 3532, 3140, 2746, 3717, 3149, 3862, 2970, 3320, 3488, 3470, 3305, 3011, 2644 }, // 1905
+        { 3674, 3283, 2944, 2715, 4056, 4133, 2947, 3399, 4029, 3385, 4309, 3882, 3495, 3093, 4072, 3494, 4216, 3315, 3675, 3835, 3827, 3654, 3369, 2993 }, // 1906
+        { 4032, 3631, 3299, 3059, 4407, 4473, 3295, 3737, 4374, 3723, 4653, 4223, 3839, 3438, 4416, 3844, 4562, 3669, 4023, 4192, 4176, 4012, 3719, 3352 }, // 1907
+        { 4381, 3988, 3647, 3414, 3314, 3388, 2200, 2652, 3279, 2638, 3559, 3139, 2748, 2354, 3327, 2757, 3472, 2578, 2931, 3097, 3082, 2915, 2624, 2253 }, // 1908
+        { 3285, 2891, 2553, 2319, 3661, 3733, 2550, 2998, 3631, 2985, 3914, 3486, 3104, 2701, 3683, 3104, 3827, 2925, 3283, 3443, 3433, 3260, 2975, 2600 }, // 1909
+        { 3638, 3239, 2908, 2668, 4017, 4083, 2903, 3346, 3980, 3330, 4257, 3829, 3441, 3043, 4017, 3447, 4162, 3271, 3621, 3791, 3774, 3611, 3317, 2952 }, // 1910
+        { 3981, 3592, 3250, 3021, 4359, 4435, 3245, 3696, 4321, 3679, 4598, 4176, 3785, 3389, 4364, 3793, 4513, 3618, 3975, 4138, 4127, 3956, 3668, 3293 }, // 1911
+        { 4328, 3929, 3594, 3356, 3261, 3329, 2148, 2593, 3227, 2577, 3508, 3077, 2697, 2294, 3277, 2701, 3426, 2528, 2887, 3050, 3039, 2868, 2579, 2205 }, // 1912
+        { 3238, 2839, 2503, 2264, 3609, 3678, 2496, 2943, 3575, 2930, 3854, 3430, 3039, 2644, 3616, 3048, 3762, 2873, 3224, 3395, 3378, 3215, 2921, 2555 }, // 1913
+        { 3583, 3192, 2849, 2618, 3956, 4031, 2842, 3293, 3920, 3278, 4200, 3775, 3387, 2987, 3965, 3390, 4113, 3214, 3575, 3737, 3731, 3560, 3277, 2902 }, // 1914
+        { 3940, 3540, 3206, 2963, 4308, 4371, 3189, 3629, 4263, 3611, 4540, 4109, 3728, 3326, 4308, 3735, 4457, 3564, 3921, 4090, 4078, 3913, 3624, 3256 }, // 1915
+        { 4288, 3894, 3554, 3318, 3218, 3287, 2098, 2545, 3170, 2526, 3446, 3025, 2634, 2241, 3215, 2649, 3365, 2475, 2828, 2997, 2982, 2818, 2526, 2159 }, // 1916
+        { 3190, 2797, 2458, 2225, 3565, 3637, 2450, 2898, 3526, 2879, 3803, 3374, 2990, 2588, 3570, 2994, 3719, 2820, 3182, 3344, 3337, 3165, 2881, 2506 }, // 1917
+        { 3544, 3145, 2813, 2573, 3921, 3986, 2805, 3246, 3878, 3226, 4151, 3720, 3332, 2932, 3907, 3337, 4055, 3166, 3520, 3693, 3679, 3518, 3226, 2861 }, // 1918
+        { 3892, 3501, 3159, 2928, 4266, 4339, 3149, 3599, 4222, 3579, 4497, 4074, 3681, 3284, 4258, 3688, 4408, 3515, 3873, 4041, 4032, 3865, 3578, 3207 }, // 1919
+        { 4241, 3844, 3507, 3269, 3171, 3239, 2055, 2499, 3132, 2482, 3411, 2980, 2599, 2195, 3178, 2601, 3327, 2428, 2789, 2953, 2945, 2775, 2490, 2117 }, // 1920
+        { 3154, 2755, 2420, 2180, 3525, 3591, 2409, 2852, 3484, 2837, 3762, 3336, 2947, 2550, 3524, 2955, 3670, 2780, 3131, 3302, 3286, 3124, 2831, 2467 }, // 1921
+        { 3497, 3108, 2767, 2536, 3874, 3949, 2758, 3209, 3833, 3190, 4110, 3687, 3298, 2900, 3877, 3304, 4026, 3130, 3489, 3653, 3645, 3475, 3191, 2817 }, // 1922
+        { 3854, 3455, 3121, 2880, 4225, 4289, 3106, 3546, 4178, 3525, 4454, 4023, 3642, 3241, 4225, 3652, 4377, 3484, 3843, 4011, 4000, 3834, 3545, 3173 }, // 1923
+        { 4206, 3809, 3470, 3232, 3133, 3200, 2013, 2459, 3086, 2441, 3362, 2939, 2549, 2158, 3132, 2568, 3286, 2398, 2752, 2924, 2909, 2746, 2453, 2085 }, // 1924
+        { 3113, 2720, 2377, 2143, 3480, 3552, 2363, 2811, 3438, 2793, 3717, 3290, 2905, 2505, 3487, 2913, 3640, 2743, 3108, 3271, 3266, 3095, 2812, 2437 }, // 1925
+        { 3474, 3073, 2738, 2495, 3840, 3901, 2718, 3156, 3789, 3135, 4062, 3630, 3246, 2845, 3824, 3254, 3976, 3087, 3445, 3618, 3608, 3448, 3159, 2793 }, // 1926
+        { 3825, 3432, 3090, 2854, 4190, 4259, 3066, 3512, 4133, 3488, 4405, 3982, 3590, 3197, 4171, 3605, 4325, 3437, 3795, 3967, 3957, 3794, 3506, 3139 }, // 1927
+        { 4171, 3777, 3437, 3199, 3097, 3164, 1975, 2417, 3044, 2393, 3317, 2887, 2504, 2102, 3088, 2513, 3242, 2346, 2710, 2875, 2870, 2700, 2417, 2044 }, // 1928
+        { 3082, 2682, 2349, 2107, 3452, 3515, 2331, 2771, 3401, 2748, 3671, 3241, 2852, 2453, 3429, 2861, 3580, 2692, 3047, 3222, 3208, 3048, 2756, 2393 }, // 1929
+        { 3423, 3033, 2691, 2460, 3797, 3870, 2678, 3126, 3747, 3102, 4018, 3593, 3200, 2802, 3777, 3206, 3928, 3036, 3398, 3566, 3560, 3395, 3111, 2740 }, // 1930
+        { 3776, 3378, 3041, 2800, 4142, 4206, 3021, 3460, 4090, 3435, 4362, 3928, 3546, 3141, 4125, 3550, 4277, 3383, 3747, 3916, 3910, 3745, 3460, 3090 }, // 1931
+        { 4125, 3727, 3390, 3148, 3050, 3114, 1926, 2368, 2995, 2347, 3268, 2843, 2452, 2058, 3032, 2466, 3183, 2296, 2650, 2824, 2810, 2650, 2358, 1994 }, // 1932
+        { 3023, 2633, 2289, 2056, 3392, 3463, 2271, 2718, 3342, 2697, 3618, 3192, 2805, 2406, 3386, 2812, 3538, 2641, 3004, 3168, 3163, 2993, 2711, 2338 }, // 1933
+        { 3377, 2977, 2644, 2402, 3746, 3808, 2624, 3060, 3691, 3035, 3962, 3528, 3145, 2742, 3724, 3152, 3876, 2985, 3345, 3516, 3507, 3344, 3057, 2690 }, // 1934
+        { 3722, 3328, 2989, 2752, 4090, 4158, 2966, 3410, 4032, 3385, 4302, 3878, 3486, 3093, 4068, 3504, 4224, 3338, 3696, 3869, 3858, 3695, 3405, 3037 }, // 1935
+        { 4067, 3672, 3329, 3093, 2989, 3058, 1867, 2311, 2937, 2288, 3211, 2782, 2398, 1998, 2983, 2410, 3141, 2246, 2613, 2778, 2775, 2605, 2322, 1947 }, // 1936
+        { 2984, 2581, 2246, 2001, 3345, 3405, 2222, 2659, 3291, 2637, 3563, 3132, 2746, 2347, 3325, 2758, 3479, 2593, 2951, 3127, 3115, 2956, 2666, 2302 }, // 1937
+        { 3331, 2939, 2595, 2360, 3694, 3763, 2569, 3015, 3635, 2990, 3907, 3484, 3091, 2697, 3673, 3106, 3828, 2940, 3301, 3474, 3468, 3306, 3022, 2653 }, // 1938
+        { 3688, 3291, 2951, 2709, 4046, 4109, 2918, 3355, 3981, 3327, 4252, 3819, 3438, 3037, 4023, 3451, 4182, 3289, 3657, 3826, 3824, 3658, 3377, 3006 }, // 1939
+        { 4044, 3644, 3308, 3064, 2964, 3024, 1835, 2271, 2896, 2243, 3164, 2736, 2348, 1954, 2932, 2369, 3089, 2205, 2562, 2739, 2727, 2569, 2278, 1915 }, // 1940
+        { 2944, 2554, 2210, 1977, 3310, 3381, 2185, 2631, 3250, 2603, 3519, 3093, 2703, 2306, 3286, 2717, 3444, 2553, 2918, 3087, 3084, 2918, 2636, 2264 }, // 1941
+        { 3302, 2904, 2569, 2327, 3669, 3731, 2544, 2979, 3607, 2949, 3873, 3436, 3052, 2647, 3630, 3058, 3786, 2896, 3262, 3435, 3431, 3271, 2987, 2620 }, // 1942
+        { 3655, 3259, 2920, 2680, 4019, 4083, 2891, 3332, 3954, 3303, 4219, 3792, 3399, 3005, 3978, 3415, 4135, 3252, 3610, 3788, 3779, 3621, 3333, 2969 }, // 1943
+        { 3999, 3607, 3263, 3027, 2921, 2989, 1794, 2238, 2860, 2211, 3131, 2702, 2316, 1916, 2899, 2326, 3056, 2162, 2529, 2696, 2695, 2527, 2248, 1875 }, // 1944
+        { 2915, 2514, 2180, 1935, 3278, 3337, 2152, 2587, 3217, 2560, 3486, 3052, 2667, 2265, 3245, 2675, 3398, 2510, 2869, 3044, 3034, 2875, 2588, 2224 }, // 1945
+        { 3256, 2865, 2524, 2289, 3625, 3693, 2499, 2942, 3562, 2914, 3829, 3404, 3011, 2617, 3592, 3026, 3747, 2861, 3221, 3395, 3387, 3226, 2940, 2573 }, // 1946
+        { 3606, 3212, 2870, 2632, 3968, 4033, 2840, 3280, 3903, 3249, 4171, 3739, 3356, 2954, 3941, 3369, 4101, 3209, 3577, 3746, 3744, 3578, 3296, 2923 }, // 1947
+        { 3960, 3558, 3222, 2977, 2878, 2937, 1750, 2185, 2812, 2158, 3080, 2651, 2264, 1868, 2846, 2283, 3005, 2122, 2480, 2658, 2647, 2489, 2198, 1833 }, // 1948
+        { 2861, 2469, 2123, 1887, 3219, 3288, 2092, 2537, 3157, 2511, 3427, 3003, 2612, 2217, 3195, 2628, 3354, 2466, 2831, 3003, 3000, 2836, 2553, 2183 }, // 1949
+        { 3219, 2820, 2481, 2238, 3575, 3635, 2445, 2879, 3505, 2847, 3771, 3336, 2953, 2550, 3535, 2963, 3694, 2804, 3172, 3345, 3344, 3183, 2902, 2533 }, // 1950
+        { 3570, 3172, 2834, 2590, 3927, 3986, 2793, 3228, 3849, 3195, 4113, 3685, 3294, 2901, 3877, 3316, 4038, 3157, 3516, 3696, 3687, 3531, 3242, 2880 }, // 1951
+        { 3910, 3519, 3173, 2937, 2827, 2894, 1695, 2137, 2754, 2104, 3020, 2593, 2205, 1807, 2791, 2223, 2954, 2064, 2432, 2602, 2602, 2436, 2156, 1783 }, // 1952
+        { 2822, 2421, 2086, 1841, 3183, 3241, 2053, 2486, 3112, 2453, 3376, 2940, 2555, 2152, 3135, 2565, 3293, 2406, 2770, 2946, 2941, 2782, 2497, 2132 }, // 1953
+        { 3165, 2771, 2431, 2192, 3529, 3594, 2399, 2840, 3458, 2807, 3721, 3294, 2899, 2505, 3479, 2916, 3638, 2755, 3117, 3296, 3291, 3134, 2848, 2484 }, // 1954
+        { 3516, 3122, 2778, 2539, 3871, 3935, 2739, 3178, 3798, 3144, 4063, 3631, 3246, 2845, 3830, 3259, 3992, 3101, 3472, 3643, 3645, 3481, 3203, 2831 }, // 1955
+        { 3870, 3468, 3132, 2885, 2785, 2841, 1651, 2084, 2710, 2053, 2976, 2544, 2158, 1760, 2740, 2175, 2899, 2015, 2376, 2554, 2546, 2390, 2102, 1740 }, // 1956
+        { 2771, 2379, 2035, 1798, 3130, 3197, 1999, 2441, 3058, 2410, 3325, 2901, 2508, 2115, 3092, 2528, 3252, 2366, 2730, 2904, 2900, 2739, 2456, 2089 }, // 1957
+        { 3124, 2729, 2389, 2149, 3485, 3546, 2352, 2787, 3409, 2751, 3672, 3237, 2853, 2451, 3437, 2866, 3599, 2709, 3079, 3251, 3252, 3089, 2810, 2440 }, // 1958
+        { 3478, 3079, 2742, 2498, 3837, 3895, 2703, 3137, 3759, 3102, 4020, 3590, 3200, 2805, 3784, 3223, 3948, 3068, 3430, 3611, 3602, 3447, 3157, 2794 }, // 1959
+        { 3823, 3430, 3083, 2846, 2736, 2803, 1604, 2046, 2663, 2014, 2929, 2502, 2113, 1717, 2700, 2134, 2865, 1979, 2349, 2522, 2522, 2358, 2078, 1706 }, // 1960
+        { 2743, 2341, 2002, 1757, 3095, 3152, 1962, 2395, 3021, 2362, 3286, 2850, 2467, 2064, 3048, 2479, 3209, 2322, 2691, 2867, 2866, 2708, 2426, 2060 }, // 1961
+        { 3095, 2698, 2357, 2115, 3450, 3510, 2314, 2751, 3370, 2717, 3631, 3204, 2811, 2418, 3394, 2832, 3555, 2675, 3038, 3220, 3215, 3062, 2777, 2415 }, // 1962
+        { 3447, 3054, 2708, 2469, 3797, 3860, 2659, 3096, 3712, 3058, 3974, 3544, 3158, 2759, 3745, 3177, 3912, 3023, 3396, 3569, 3572, 3409, 3133, 2762 }, // 1963
+        { 3802, 3401, 3065, 2817, 2716, 2770, 1578, 2007, 2631, 1970, 2892, 2457, 2072, 1673, 2656, 2091, 2819, 1937, 2301, 2481, 2475, 2319, 2033, 1670 }, // 1964
+        { 2702, 2309, 1966, 1728, 3061, 3125, 1927, 2366, 2982, 2330, 3242, 2816, 2421, 2028, 3005, 2443, 3168, 2286, 2651, 2830, 2826, 2669, 2385, 2020 }, // 1965
+        { 3054, 2660, 2318, 2078, 3411, 3473, 2277, 2712, 3331, 2672, 3590, 3153, 2767, 2363, 3349, 2778, 3512, 2623, 2997, 3171, 3175, 3014, 2738, 2368 }, // 1966
+        { 3408, 3008, 2671, 2424, 3762, 3817, 2625, 3055, 3678, 3018, 3936, 3503, 3113, 2716, 3695, 3132, 3858, 2978, 3341, 3524, 3517, 3364, 3078, 2716 }, // 1967
+        { 3746, 3354, 3008, 2769, 2658, 2722, 1521, 1961, 2576, 1926, 2839, 2413, 2022, 1627, 2607, 2043, 2771, 1886, 2254, 2430, 2429, 2269, 1988, 1620 }, // 1968
+        { 2657, 2258, 1919, 1675, 3011, 3068, 1875, 2307, 2930, 2270, 3192, 2755, 2372, 1968, 2954, 2383, 3115, 2227, 2597, 2771, 2771, 2611, 2331, 1964 }, // 1969
+        { 3002, 2604, 2266, 2022, 3359, 3416, 2222, 2655, 3274, 2617, 3532, 3103, 2710, 2317, 3294, 2734, 3458, 2579, 2942, 3124, 3118, 2965, 2677, 2316 }, // 1970
+        { 3345, 2953, 2606, 2367, 3695, 3758, 2556, 2994, 3608, 2955, 3869, 3440, 3051, 2655, 3640, 3075, 3810, 2925, 3299, 3473, 3477, 3314, 3036, 2664 }, // 1971
+        { 3702, 3299, 2960, 2711, 2608, 2662, 1469, 1898, 2521, 1860, 2782, 2346, 1963, 1563, 2549, 1983, 2715, 1833, 2202, 2381, 2379, 2223, 1939, 1573 }, // 1972
+        { 2605, 2208, 1864, 1621, 2953, 3013, 1814, 2251, 2867, 2214, 3127, 2701, 2307, 1916, 2893, 2333, 3059, 2181, 2547, 2730, 2727, 2574, 2290, 1928 }, // 1973
+        { 2960, 2566, 2220, 1979, 3307, 3367, 2165, 2599, 3214, 2556, 3472, 3038, 2651, 2250, 3237, 2669, 3405, 2518, 2895, 3071, 3078, 2918, 2645, 2276 }, // 1974
+        { 3318, 2916, 2579, 2330, 3666, 3717, 2522, 2947, 3567, 2904, 3822, 3387, 2999, 2602, 3585, 3024, 3753, 2875, 3242, 3426, 3423, 3271, 2986, 2626 }, // 1975
+        { 3657, 3265, 2920, 2680, 2568, 2630, 1427, 1863, 2475, 1821, 2731, 2304, 1911, 1518, 2498, 1938, 2668, 1788, 2158, 2338, 2339, 2182, 1901, 1535 }, // 1976
+        { 2571, 2175, 1833, 1591, 2924, 2982, 1786, 2217, 2836, 2175, 3092, 2654, 2268, 1864, 2850, 2280, 3016, 2129, 2504, 2681, 2686, 2527, 2251, 1883 }, // 1977
+        { 2923, 2524, 2187, 1941, 3278, 3334, 2139, 2570, 3189, 2529, 3443, 3010, 2617, 2220, 3198, 2637, 3362, 2485, 2851, 3037, 3034, 2885, 2600, 2241 }, // 1978
+        { 3272, 2880, 2532, 2293, 3620, 3682, 2478, 2915, 3527, 2874, 3785, 3356, 2965, 2569, 3551, 2987, 3720, 2836, 3210, 3388, 3393, 3234, 2958, 2590 }, // 1979
+        { 3629, 3229, 2890, 2642, 2537, 2590, 1395, 1823, 2445, 1782, 2704, 2267, 1884, 1482, 2469, 1901, 2633, 1749, 2119, 2297, 2298, 2141, 1861, 1496 }, // 1980
+        { 2533, 2136, 1795, 1552, 2885, 2943, 1745, 2179, 2795, 2140, 3053, 2625, 2232, 1840, 2817, 2258, 2983, 2105, 2469, 2653, 2648, 2496, 2211, 1851 }, // 1981
+        { 2883, 2491, 2145, 1906, 3235, 3296, 2093, 2528, 3140, 2483, 3396, 2963, 2575, 2175, 3162, 2595, 3332, 2446, 2822, 2998, 3004, 2843, 2568, 2198 }, // 1982
+        { 3239, 2837, 2500, 2251, 3587, 3639, 2444, 2870, 3491, 2827, 3746, 3309, 2923, 2524, 3510, 2947, 3680, 2801, 3171, 3354, 3352, 3198, 2914, 2550 }, // 1983
+        { 3581, 3185, 2839, 2596, 2485, 2544, 1342, 1778, 2391, 1738, 2649, 2222, 1829, 1438, 2418, 1860, 2590, 1713, 2082, 2266, 2265, 2111, 1828, 1463 }, // 1984
+        { 2495, 2098, 1752, 1507, 2836, 2894, 1694, 2126, 2743, 2083, 3000, 2564, 2179, 1776, 2764, 2196, 2933, 2047, 2424, 2602, 2609, 2451, 2176, 1808 }, // 1985
+        { 2848, 2446, 2108, 1858, 3192, 3243, 2046, 2472, 3091, 2428, 3344, 2910, 2521, 2124, 3106, 2546, 3275, 2399, 2767, 2954, 2953, 2804, 2521, 2162 }, // 1986
+        { 3193, 2800, 2452, 2210, 3534, 3592, 2384, 2818, 3426, 2770, 3679, 3251, 2859, 2466, 3449, 2890, 3624, 2745, 3120, 3301, 3306, 3149, 2872, 2506 }, // 1987
+        { 3544, 3144, 2803, 2555, 2447, 2499, 1299, 1725, 2342, 1677, 2595, 2157, 1773, 1371, 2360, 1794, 2531, 1649, 2024, 2204, 2209, 2052, 1774, 1408 }, // 1988
+        { 2446, 2047, 1707, 1461, 2794, 2848, 1650, 2079, 2694, 2034, 2945, 2513, 2119, 1725, 2704, 2146, 2874, 2000, 2367, 2555, 2554, 2405, 2121, 1762 }, // 1989
+        { 2793, 2402, 2054, 1814, 3139, 3199, 1993, 2427, 3036, 2377, 3286, 2853, 2460, 2062, 3045, 2481, 3217, 2335, 2714, 2894, 2904, 2747, 2474, 2107 }, // 1990
+        { 3148, 2747, 2408, 2158, 3492, 3542, 2345, 2769, 3387, 2720, 3638, 3199, 2813, 2411, 3397, 2833, 3567, 2688, 3061, 3245, 3248, 3096, 2816, 2454 }, // 1991
+        { 3489, 3093, 2748, 2504, 2392, 2448, 1245, 1677, 2289, 1632, 2542, 2114, 1720, 1329, 2307, 1750, 2478, 1603, 1971, 2157, 2157, 2006, 1724, 1363 }, // 1992
+        { 2396, 2003, 1657, 1415, 2743, 2801, 1597, 2029, 2642, 1982, 2895, 2460, 2072, 1671, 2658, 2090, 2828, 1942, 2320, 2497, 2505, 2347, 2074, 1706 }, // 1993
+        { 2748, 2347, 2011, 1762, 3098, 3148, 1952, 2376, 2994, 2328, 3245, 2808, 2419, 2021, 3004, 2444, 3175, 2299, 2669, 2856, 2855, 2706, 2423, 2063 }, // 1994
+        { 3094, 2701, 2353, 2111, 3436, 3495, 2288, 2722, 3330, 2674, 3582, 3154, 2761, 2370, 3352, 2795, 3529, 2653, 3027, 3211, 3216, 3061, 2782, 2417 }, // 1995
+        { 3451, 3053, 2708, 2461, 2350, 2403, 1202, 1630, 2246, 1583, 2501, 2064, 1680, 1279, 2269, 1703, 2442, 1560, 1939, 2119, 2127, 1969, 1694, 1326 }, // 1996
+        { 2364, 1963, 1622, 1372, 2704, 2755, 1556, 1983, 2600, 1938, 2853, 2420, 2029, 1635, 2616, 2059, 2789, 1916, 2285, 2475, 2474, 2327, 2045, 1687 }, // 1997
+        { 2718, 2326, 1977, 1735, 3057, 3115, 1905, 2337, 2943, 2286, 3194, 2763, 2370, 1975, 2960, 2399, 3136, 2257, 2636, 2819, 2828, 2674, 2402, 2036 }, // 1998
+        { 3077, 2677, 2337, 2087, 3418, 3466, 2265, 2686, 3301, 2633, 3549, 3109, 2725, 2324, 3314, 2751, 3490, 2611, 2988, 3172, 3178, 3025, 2748, 2384 }, // 1999
+        { 3421, 3023, 2680, 2433, 2323, 2375, 1172, 1600, 2210, 1550, 2459, 2028, 1634, 1243, 2223, 1668, 2399, 1528, 1898, 2087, 2088, 1939, 1657, 1298 }, // 2000
+        { 2329, 1936, 1589, 1347, 2673, 2731, 1525, 1956, 2565, 1904, 2814, 2378, 1987, 1586, 2572, 2007, 2746, 1865, 2245, 2426, 2437, 2280, 2009, 1641 }, // 2001
+        { 2684, 2282, 1944, 1693, 3028, 3076, 1878, 2301, 2917, 2249, 3165, 2724, 2336, 1935, 2919, 2357, 3091, 2215, 2589, 2778, 2782, 2634, 2354, 1994 }, // 2002
+        { 3028, 2633, 2286, 2040, 3365, 3420, 2213, 2643, 3251, 2593, 3500, 3070, 2676, 2284, 3264, 2708, 3440, 2567, 2941, 3128, 3133, 2983, 2705, 2344 }, // 2003
+        { 3379, 2982, 2636, 2390, 2276, 2329, 1123, 1550, 2163, 1499, 2414, 1977, 1591, 1190, 2180, 1613, 2353, 1470, 1849, 2029, 2039, 1882, 1609, 1242 }, // 2004
+        { 2283, 1882, 1543, 1292, 2625, 2673, 1474, 1897, 2513, 1847, 2762, 2326, 1937, 1541, 2523, 1965, 2697, 1823, 2193, 2382, 2382, 2235, 1953, 1595 }, // 2005
+        { 2627, 2235, 1887, 1645, 2969, 3026, 1816, 2246, 2851, 2192, 3097, 2666, 2271, 1878, 2861, 2303, 3039, 2163, 2541, 2726, 2735, 2582, 2307, 1942 }, // 2006
+        { 2980, 2581, 2238, 1989, 3318, 3367, 2165, 2587, 3200, 2532, 3447, 3006, 2622, 2220, 3211, 2648, 3389, 2511, 2892, 3075, 3084, 2930, 2654, 2288 }, // 2007
+        { 3325, 2924, 2580, 2330, 2219, 2268, 1066, 1491, 2104, 1441, 2352, 1919, 1527, 1135, 2116, 1562, 2294, 1425, 1797, 1989, 1991, 1844, 1562, 1204 }, // 2008
+        { 2234, 1840, 1490, 1246, 2568, 2624, 1414, 1844, 2451, 1791, 2699, 2266, 1874, 1476, 2461, 1899, 2638, 1759, 2140, 2323, 2336, 2183, 1912, 1547 }, // 2009
+        { 2589, 2188, 1848, 1596, 2926, 2972, 1771, 2190, 2804, 2134, 3049, 2608, 2222, 1821, 2809, 2247, 2985, 2109, 2487, 2675, 2683, 2535, 2258, 1898 }, // 2010
+        { 2935, 2539, 2193, 1945, 3270, 3321, 2112, 2537, 3143, 2481, 3387, 2956, 2562, 2172, 3153, 2601, 3334, 2465, 2839, 3030, 3035, 2888, 2609, 2250 }, // 2011
+        { 3284, 2890, 2542, 2298, 2181, 2234, 1026, 1452, 2060, 1396, 2306, 1869, 1481, 1081, 2071, 1507, 2249, 1369, 1752, 1933, 1946, 1790, 1519, 1152 }, // 2012
+        { 2194, 1792, 1453, 1202, 2535, 2582, 1383, 1803, 2418, 1750, 2663, 2224, 1835, 1436, 2420, 1862, 2596, 1724, 2098, 2290, 2294, 2148, 1869, 1511 }, // 2013
+        { 2544, 2151, 1803, 1559, 2882, 2937, 1727, 2156, 2759, 2099, 3003, 2571, 2175, 1781, 2763, 2206, 2941, 2069, 2448, 2637, 2647, 2498, 2224, 1863 }, // 2014
+        { 2901, 2503, 2159, 1910, 3236, 3285, 2079, 2502, 3113, 2445, 3358, 2918, 2532, 2130, 3121, 2557, 3300, 2420, 2803, 2987, 2999, 2845, 2573, 2208 }, // 2015
+        { 3248, 2847, 2506, 2254, 2144, 2190,  988, 1410, 2022, 1357, 2269, 1834, 1443, 1050, 2033, 1478, 2211, 1341, 1713, 1906, 1908, 1762, 1481, 1124 }, // 2016
+        { 2156, 1764, 1414, 1171, 2493, 2549, 1337, 1767, 2371, 1711, 2617, 2184, 1791, 1395, 2380, 1820, 2559, 1682, 2062, 2247, 2258, 2105, 1833, 1468 }, // 2017
+        { 2509, 2109, 1769, 1518, 2848, 2895, 1693, 2113, 2725, 2055, 2969, 2527, 2142, 1740, 2731, 2169, 2910, 2034, 2415, 2602, 2612, 2461, 2186, 1823 }, // 2018
+        { 2859, 2459, 2114, 1864, 3190, 3238, 2031, 2455, 3063, 2399, 3306, 2874, 2481, 2090, 3073, 2522, 3257, 2390, 2766, 2960, 2964, 2819, 2538, 2179 }, // 2019
+        { 3210, 2815, 2463, 2217, 2097, 2150,  938, 1366, 1972, 1309, 2218, 1784, 1394,  997, 1986, 1425, 2168, 1290, 1675, 1859, 1874, 1720, 1449, 1082 }, // 2020
+        { 2123, 1720, 1379, 1124, 2454, 2497, 1295, 1713, 2327, 1657, 2572, 2132, 1745, 1346, 2334, 1775, 2513, 1641, 2019, 2211, 2219, 2074, 1797, 1439 }, // 2021
+        { 2474, 2079, 1731, 1483, 2804, 2853, 1640, 2064, 2666, 2003, 2906, 2474, 2078, 1687, 2669, 2116, 2852, 1984, 2362, 2556, 2565, 2420, 2146, 1788 }, // 2022
+        { 2825, 2429, 2083, 1834, 3156, 3204, 1993, 2414, 3019, 2349, 3258, 2818, 2431, 2030, 3023, 2461, 3207, 2330, 2716, 2901, 2916, 2763, 2493, 2127 }, // 2023
+        { 3169, 2767, 2427, 2173, 2063, 2106,  902, 1320, 1930, 1260, 2170, 1731, 1340,  944, 1929, 1375, 2111, 1244, 1620, 1815, 1820, 1676, 1397, 1040 }, // 2024
+        { 2073, 1680, 1330, 1087, 2407, 2461, 1249, 1676, 2277, 1615, 2517, 2082, 1685, 1289, 2271, 1714, 2452, 1579, 1961, 2151, 2164, 2015, 1744, 1383 }, // 2025
+        { 2423, 2025, 1682, 1432, 2759, 2806, 1600, 2019, 2629, 1957, 2868, 2424, 2037, 1633, 2623, 2059, 2801, 1925, 2309, 2498, 2512, 2363, 2092, 1730 }, // 2026
+        { 2770, 2370, 2026, 1773, 3099, 3145, 1937, 2358, 2965, 2298, 3206, 2771, 2377, 1985, 2967, 2414, 3148, 2282, 2657, 2853, 2858, 2716, 2437, 2082 }, // 2027
+        { 3115, 2722, 2371, 2126, 2005, 2057,  843, 1269, 1872, 1210, 2116, 1682, 1290,  894, 1881, 1321, 2062, 1185, 1568, 1753, 1767, 1614, 1345,  980 }, // 2028
+        { 2022, 1621, 1281, 1028, 2357, 2402, 1198, 1616, 2228, 1556, 2470, 2028, 1642, 1242, 2232, 1672, 2412, 1538, 1918, 2108, 2117, 1969, 1694, 1334 }, // 2029
+        { 2370, 1974, 1628, 1380, 2703, 2752, 1541, 1963, 2566, 1901, 2804, 2371, 1975, 1585, 2567, 2016, 2753, 1887, 2265, 2460, 2468, 2324, 2047, 1689 }, // 2030
+        { 2723, 2328, 1978, 1731, 3051, 3101, 1888, 2311, 2915, 2248, 3156, 2717, 2329, 1930, 2923, 2363, 3110, 2235, 2623, 2809, 2825, 2672, 2403, 2035 }, // 2031
+        { 3076, 2671, 2329, 2072, 1960, 2002,  797, 1214, 1826, 1155, 2068, 1629, 1241,  845, 1833, 1278, 2018, 1151, 1530, 1726, 1734, 1591, 1313,  956 }, // 2032
+        { 1988, 1593, 1241,  994, 2312, 2363, 1148, 1573, 2174, 1511, 2413, 1981, 1585, 1193, 2176, 1622, 2360, 1491, 1874, 2067, 2081, 1936, 1665, 1306 }, // 2033
+        { 2344, 1947, 1601, 1350, 2672, 2717, 1506, 1924, 2529, 1857, 2766, 2324, 1937, 1536, 2529, 1967, 2714, 1839, 2227, 2416, 2433, 2285, 2017, 1654 }, // 2034
+        { 2696, 2294, 1952, 1696, 3022, 3063, 1854, 2269, 2875, 2203, 3111, 2673, 2281, 1888, 2874, 2324, 3062, 2199, 2577, 2776, 2784, 2643, 2365, 2011 }, // 2035
+        { 3043, 2651, 2300, 2054, 1932, 1983,  766, 1190, 1789, 1125, 2027, 1592, 1197,  802, 1789, 1232, 1975, 1103, 1489, 1679, 1694, 1545, 1276,  913 }, // 2036
+        { 1954, 1554, 1211,  959, 2286, 2330, 1124, 1540, 2149, 1475, 2387, 1942, 1555, 1152, 2143, 1582, 2325, 1453, 1838, 2030, 2044, 1898, 1627, 1267 }, // 2037
+        { 2307, 1908, 1563, 1312, 2635, 2680, 1469, 1888, 2491, 1823, 2725, 2289, 1892, 1500, 2481, 1930, 2666, 1802, 2181, 2380, 2391, 2251, 1976, 1622 }, // 2038
+        { 2656, 2263, 1913, 1665, 2983, 3032, 1816, 2238, 2838, 2171, 3075, 2637, 2246, 1848, 2838, 2278, 3024, 2149, 2537, 2725, 2743, 2592, 2325, 1960 }, // 2039
+        { 3003, 2601, 2260, 2004, 1891, 1931,  725, 1139, 1749, 1076, 1988, 1546, 1159,  761, 1750, 1193, 1934, 1065, 1445, 1640, 1649, 1505, 1230,  873 }, // 2040
+        { 1908, 1513, 1165,  917, 2238, 2287, 1072, 1495, 2094, 1429, 2330, 1896, 1498, 1106, 2088, 1536, 2273, 1406, 1787, 1982, 1993, 1849, 1576, 1218 }, // 2041
+        { 2255, 1860, 1513, 1264, 2586, 2633, 1420, 1840, 2443, 1771, 2678, 2236, 1847, 1446, 2439, 1878, 2625, 1751, 2140, 2329, 2347, 2197, 1929, 1564 }, // 2042
+        { 2605, 2201, 1859, 1601, 2928, 2968, 1760, 2174, 2782, 2109, 3018, 2578, 2188, 1793, 2781, 2229, 2970, 2107, 2487, 2687, 2696, 2555, 2277, 1921 }, // 2043
+        { 2952, 2557, 2204, 1956, 1831, 1880,  663, 1087, 1685, 1022, 1924, 1491, 1096,  703, 1688, 1134, 1876, 1008, 1393, 1586, 1602, 1455, 1185,  823 }, // 2044
+        { 1862, 1462, 1116,  862, 2185, 2227, 1017, 1433, 2039, 1366, 2277, 1834, 1448, 1047, 2039, 1479, 2225, 1353, 1740, 1932, 1949, 1804, 1535, 1175 }, // 2045
+        { 2216, 1816, 1471, 1215, 2538, 2578, 1365, 1779, 2380, 1708, 2612, 2175, 1780, 1388, 2373, 1824, 2563, 1701, 2082, 2283, 2294, 2156, 1881, 1528 }, // 2046
+        { 2562, 2170, 1818, 1570, 2885, 2933, 1713, 2132, 2728, 2060, 2961, 2523, 2130, 1735, 2726, 2171, 2918, 2048, 2437, 2628, 2647, 2498, 2231, 1867 }, // 2047
+        { 2909, 2507, 2164, 1908, 1794, 1834,  625, 1037, 1644,  968, 1878, 1434, 1047,  647, 1639, 1082, 1828,  960, 1346, 1542, 1557, 1413, 1140,  782 }, // 2048
+        { 1818, 1421, 1073,  822, 2143, 2188,  974, 1393, 1992, 1324, 2223, 1787, 1389,  996, 1978, 1427, 2165, 1302, 1685, 1885, 1898, 1759, 1486, 1132 }, // 2049
+        { 2168, 1774, 1424, 1175, 2493, 2539, 1323, 1742, 2342, 1671, 2574, 2133, 1741, 1341, 2332, 1772, 2520, 1648, 2040, 2231, 2253, 2106, 1841, 1478 }, // 2050
+        { 2522, 2118, 1776, 1517, 2842, 2879, 1669, 2080, 2687, 2011, 2920, 2478, 2089, 1693, 2681, 2129, 2871, 2007, 2390, 2590, 2602, 2462, 2188, 1834 }, // 2051
+        { 2868, 2474, 2123, 1873, 1749, 1796,  577,  998, 1595,  929, 1829, 1396, 1000,  609, 1593, 1041, 1782,  915, 1299, 1495, 1509, 1366, 1095,  737 }, // 2052
+        { 1776, 1379, 1033,  782, 2103, 2147,  934, 1350, 1953, 1279, 2187, 1744, 1357,  956, 1950, 1390, 2138, 1266, 1656, 1847, 1866, 1718, 1452, 1090 }, // 2053
+        { 2132, 1731, 1388, 1131, 2455, 2494, 1283, 1695, 2298, 1623, 2527, 2087, 1693, 1300, 2287, 1738, 2479, 1619, 2002, 2205, 2216, 2079, 1803, 1450 }, // 2054
+        { 2482, 2089, 1735, 1487, 2801, 2848, 1628, 2048, 2644, 1976, 2876, 2440, 2045, 1652, 2641, 2088, 2835, 1969, 2359, 2553, 2572, 2426, 2158, 1795 }, // 2055
+        { 2835, 2433, 2087, 1830, 1712, 1751,  540,  952, 1558,  882, 1792, 1348,  962,  562, 1556,  999, 1747,  879, 1269, 1465, 1483, 1340, 1071,  711 }, // 2056
+        { 1750, 1350, 1002,  747, 2067, 2108,  892, 1307, 1906, 1235, 2136, 1699, 1302,  910, 1894, 1345, 2084, 1223, 1606, 1809, 1822, 1686, 1414, 1063 }, // 2057
+        { 2098, 1706, 1354, 1105, 2420, 2465, 1244, 1661, 2256, 1584, 2484, 2044, 1651, 1254, 2245, 1688, 2438, 1568, 1961, 2154, 2177, 2031, 1767, 1405 }, // 2058
+        { 2449, 2046, 1704, 1445, 2768, 2804, 1592, 2000, 2604, 1924, 2832, 2387, 1999, 1601, 2592, 2040, 2786, 1923, 2310, 2510, 2525, 2386, 2113, 1758 }, // 2059
+        { 2794, 2398, 2048, 1797, 1674, 1718,  499,  917, 1513,  843, 1741, 1305,  907,  515, 1499,  949, 1690,  828, 1213, 1413, 1429, 1288, 1017,  661 }, // 2060
+        { 1698, 1302,  954,  703, 2021, 2066,  850, 1266, 1866, 1192, 2096, 1652, 1262,  860, 1853, 1293, 2042, 1171, 1564, 1757, 1780, 1634, 1370, 1009 }, // 2061
+        { 2052, 1650, 1307, 1048, 2371, 2407, 1195, 1604, 2207, 1530, 2434, 1991, 1598, 1202, 2189, 1638, 2380, 1520, 1904, 2108, 2122, 1987, 1714, 1362 }, // 2062
+        { 2397, 2004, 1651, 1401, 2714, 2759, 1537, 1955, 2548, 1879, 2777, 2342, 1945, 1553, 2540, 1988, 2733, 1868, 2257, 2453, 2472, 2328, 2060, 1701 }, // 2063
+        { 2741, 2341, 1995, 1739, 1619, 1658,  444,  856, 1458,  781, 1690, 1245,  859,  459, 1454,  896, 1646,  777, 1168, 1362, 1381, 1236,  969,  608 }, // 2064
+        { 1649, 1248,  903,  647, 1969, 2008,  794, 1206, 1805, 1130, 2032, 1592, 1196,  804, 1789, 1241, 1982, 1122, 1506, 1709, 1722, 1586, 1312,  960 }, // 2065
+        { 1994, 1602, 1249, 1000, 2314, 2360, 1137, 1555, 2148, 1477, 2376, 1936, 1542, 1146, 2137, 1583, 2333, 1467, 1861, 2056, 2079, 1933, 1668, 1305 }, // 2066
+        { 2347, 1943, 1597, 1337, 2658, 2693, 1480, 1888, 2492, 1813, 2721, 2276, 1889, 1490, 2485, 1932, 2682, 1819, 2211, 2412, 2430, 2290, 2020, 1663 }, // 2067
+        { 2699, 2300, 1949, 1693, 1569, 1609,  389,  804, 1400,  730, 1629, 1193,  797,  406, 1391,  844, 1585,  726, 1113, 1317, 1333, 1197,  926,  572 }, // 2068
+        { 1608, 1213,  861,  609, 1922, 1965,  744, 1158, 1754, 1081, 1983, 1541, 1151,  752, 1746, 1189, 1940, 1072, 1467, 1662, 1687, 1543, 1282,  922 }, // 2069
+        { 1967, 1565, 1221,  961, 2282, 2315, 1099, 1504, 2104, 1423, 2328, 1882, 1492, 1095, 2086, 1537, 2283, 1424, 1813, 2018, 2035, 1901, 1630, 1279 }, // 2070
+        { 2316, 1922, 1570, 1319, 2632, 2674, 1450, 1865, 2455, 1783, 2678, 2240, 1842, 1452, 2439, 1891, 2637, 1777, 2168, 2369, 2388, 2248, 1980, 1623 }, // 2071
+        { 2663, 2265, 1917, 1663, 1541, 1581,  363,  775, 1373,  695, 1600, 1153,  765,  364, 1359,  802, 1555,  687, 1083, 1279, 1303, 1160,  896,  536 }, // 2072
+        { 1578, 1177,  832,  574, 1896, 1933,  719, 1128, 1727, 1049, 1950, 1507, 1110,  715, 1700, 1151, 1893, 1035, 1421, 1627, 1644, 1511, 1240,  890 }, // 2073
+        { 1926, 1534, 1181,  932, 2244, 2289, 1065, 1481, 2073, 1401, 2297, 1858, 1461, 1065, 2053, 1500, 2248, 1383, 1777, 1975, 1999, 1857, 1594, 1235 }, // 2074
+        { 2277, 1876, 1530, 1272, 2591, 2626, 1411, 1818, 2419, 1739, 2646, 2200, 1813, 1413, 2408, 1853, 2603, 1738, 2131, 2330, 2351, 2211, 1944, 1587 }, // 2075
+        { 2627, 2227, 1879, 1623, 1500, 1538,  320,  732, 1328,  654, 1554, 1116,  720,  329, 1314,  767, 1508,  650, 1034, 1239, 1253, 1117,  845,  493 }, // 2076
+        { 1528, 1135,  783,  533, 1846, 1891,  668, 1084, 1678, 1005, 1904, 1463, 1070,  673, 1666, 1111, 1863,  995, 1390, 1585, 1610, 1465, 1202,  840 }, // 2077
+        { 1884, 1481, 1137,  876, 2197, 2230, 1016, 1421, 2021, 1339, 2244, 1798, 1408, 1010, 2004, 1453, 2203, 1344, 1736, 1940, 1959, 1822, 1552, 1198 }, // 2078
+        { 2233, 1836, 1483, 1228, 2541, 2580, 1357, 1770, 2362, 1689, 2586, 2149, 1751, 1362, 2349, 1804, 2550, 1693, 2083, 2287, 2307, 2169, 1900, 1544 }, // 2079
+        { 2579, 2181, 1828, 1572, 1445, 1484,  262,  674, 1270,  594, 1497, 1054,  665,  267, 1263,  708, 1462,  596,  994, 1191, 1218, 1075,  813,  452 }, // 2080
+        { 1496, 1091,  746,  483, 1802, 1834,  617, 1021, 1620,  938, 1841, 1396, 1003,  608, 1597, 1049, 1794,  937, 1326, 1534, 1552, 1421, 1151,  802 }, // 2081
+        { 1838, 1446, 1092,  840, 2150, 2190,  963, 1375, 1963, 1288, 2182, 1743, 1345,  953, 1941, 1393, 2142, 1283, 1677, 1880, 1904, 1765, 1501, 1144 }, // 2082
+        { 2186, 1786, 1438, 1180, 2496, 2530, 1310, 1715, 2311, 1628, 2532, 2083, 1695, 1295, 2292, 1739, 2494, 1631, 2029, 2230, 2255, 2115, 1851, 1493 }, // 2083
+        { 2535, 2133, 1786, 1527, 1405, 1439,  220,  627, 1223,  544, 1442, 1000,  603,  210, 1196,  650, 1394,  539,  927, 1136, 1153, 1021,  751,  401 }, // 2084
+        { 1436, 1043,  689,  439, 1750, 1793,  568,  982, 1573,  899, 1794, 1353,  956,  559, 1549,  996, 1747,  883, 1280, 1480, 1507, 1367, 1107,  748 }, // 2085
+        { 1793, 1391, 1046,  785, 2103, 2135,  917, 1320, 1919, 1234, 2138, 1689, 1300,  899, 1893, 1341, 2092, 1232, 1627, 1832, 1855, 1721, 1455, 1102 }, // 2086
+        { 2142, 1745, 1395, 1138, 2452, 2488, 1264, 1674, 2264, 1589, 2484, 2046, 1648, 1258, 2244, 1699, 2444, 1588, 1977, 2184, 2203, 2069, 1800, 1448 }, // 2087
+        { 2485, 2090, 1738, 1485, 1357, 1397,  172,  584, 1176,  500, 1400,  956,  566,  168, 1163,  609, 1364,  498,  896, 1093, 1120,  977,  716,  356 }, // 2088
+        { 1401,  998,  654,  393, 1714, 1746,  530,  933, 1532,  848, 1750, 1303,  911,  513, 1504,  955, 1704,  847, 1238, 1445, 1464, 1332, 1063,  712 }, // 2089
+        { 1748, 1354, 1002,  750, 2061, 2102,  876, 1288, 1876, 1202, 2095, 1656, 1256,  865, 1852, 1307, 2055, 1199, 1593, 1799, 1822, 1686, 1419, 1063 }, // 2090
+        { 2102, 1702, 1350, 1093, 2406, 2442, 1220, 1627, 2223, 1542, 2445, 1999, 1611, 1211, 2209, 1656, 2413, 1550, 1951, 2152, 2180, 2040, 1778, 1418 }, // 2091
+        { 2460, 2056, 1708, 1446, 1322, 1353,  134,  539, 1136,  456, 1357,  915,  521,  127, 1116,  570, 1316,  461,  851, 1061, 1080,  950,  681,  332 }, // 2092
+        { 1367,  973,  618,  366, 1674, 1714,  486,  898, 1486,  812, 1706, 1267,  870,  477, 1467,  918, 1669,  809, 1206, 1408, 1435, 1297, 1037,  680 }, // 2093
+        { 1724, 1324,  977,  716, 2031, 2061,  840, 1241, 1835, 1149, 2052, 1602, 1214,  814, 1811, 1260, 2016, 1156, 1555, 1760, 1786, 1651, 1388, 1033 }, // 2094
+        { 2075, 1675, 1327, 1068, 2382, 2415, 1191, 1596, 2186, 1506, 2400, 1959, 1561, 1171, 2158, 1616, 2363, 1511, 1902, 2112, 2132, 2001, 1731, 1380 }, // 2095
+        { 2416, 2021, 1666, 1414, 1283, 1322,   95,  506, 1095,  418, 1314,  870,  476,   79, 1073,  521, 1277,  414,  815, 1016, 1046,  905,  645,  286 }, // 2096
+        { 1330,  927,  582,  319, 1638, 1668,  450,  851, 1448,  762, 1663, 1213,  821,  421, 1413,  862, 1613,  755, 1150, 1359, 1383, 1252,  987,  637 }, // 2097
+        { 1676, 1280,  928,  673, 1984, 2020,  793, 1201, 1788, 1111, 2003, 1563, 1162,  770, 1756, 1211, 1958, 1104, 1497, 1706, 1730, 1598, 1332,  980 }, // 2098
+        { 2019, 1622, 1269, 1012, 2322, 2357, 1131, 1538, 2129, 1448, 2348, 1901, 1511, 1113, 2110, 1557, 2314, 1451, 1852, 2052, 2082, 1942, 1683, 1324 }, // 2099
+        { 2369, 1965, 1620, 1357, 2674, 2703, 1483, 1885, 2481, 1797, 2698, 2252, 1859, 1464, 2454, 1907, 2655, 1800, 2191, 2400, 2420, 2289, 2020, 1671 }, // 2100
+    };
+};
+
+class CDMSolarTerm {
+public:
+    enum Term {
+        MINOR_COLD = 0,         // 小寒
+        MAJOR_COLD,             // 大寒
+        START_OF_SPRING,        // 立春
+        RAIN_WATER,             // 雨水
+        AWAKENING_OF_INSECTS,   // 惊蛰
+        SPRING_EQUINOX,         // 春分
+        PURE_BRIGHTNESS,        // 清明
+        GRAIN_RAIN,             // 谷雨
+        START_OF_SUMMER,        // 立夏
+        GRAIN_BUDS,             // 小满
+        GRAIN_IN_EAR,           // 芒种
+        SUMMER_SOLSTICE,        // 夏至
+        MINOR_HEAT,             // 小暑
+        MAJOR_HEAT,             // 大暑
+        START_OF_AUTUMN,        // 立秋
+        END_OF_HEAT,            // 处暑
+        WHITE_DEW,              // 白露
+        AUTUMN_EQUINOX,         // 秋分
+        COLD_DEW,               // 寒露
+        FROST_DESCENT,          // 霜降
+        START_OF_WINTER,        // 立冬
+        MINOR_SNOW,             // 小雪
+        MAJOR_SNOW,             // 大雪
+        WINTER_SOLSTICE,        // 冬至
+        TERM_COUNT
+    };
+
+    static const int MIN_YEAR = 1900;
+    static const int MAX_YEAR = 2100;
+    static const int CHINA_UTC_OFFSET = 8 * 3600; // 节气日期按北京时间
+    static_assert(MAX_YEAR - MIN_YEAR + 1 == CDMSolarTermTable::YEAR_COUNT, "solar term table size");
+    static_assert(static_cast<int>(TERM_COUNT) == CDMSolarTermTable::TERM_COUNT, "solar term count");
+
+    static constexpr bool IsYearInRange(int year) {
+        return year >= MIN_YEAR && year <= MAX_YEAR;
+    }
+
+    static constexpr bool IsValid(int year, int term) {
+        return IsYearInRange(year) && term >= 0 && term < TERM_COUNT;
+    }
+
+    // 交节时刻（UTC 时间戳，精确到分钟）；year/term 超出范围时返回 -1
+    static constexpr long long Timestamp(int year, int term) {
+        return IsValid(year, term)
+            ? CDMCivil::DaysFromCivil(year, CDMSolarTermTable::BASE_MONTH[term], CDMSolarTermTable::BASE_DAY[term]) * CDMCivil::SECONDS_PER_DAY
+                - CHINA_UTC_OFFSET + CDMSolarTermTable::MINUTE_OFFSET[year - MIN_YEAR][term] * 60LL
+            : -1;
+    }
+
+    // 交节当天（北京时间）距 1970-01-01 的天数；超出范围返回 0，先用 IsValid 判断
+    static constexpr long long Days(int year, int term) {
+        return IsValid(year, term)
+            ? CDMCivil::DaysFromCivil(year, CDMSolarTermTable::BASE_MONTH[term], CDMSolarTermTable::BASE_DAY[term])
+                + CDMSolarTermTable::MINUTE_OFFSET[year - MIN_YEAR][term] / 1440
+            : 0;
+    }
+
+    // 交节当天的北京时间日期
+    static bool GetDate(int year, int term, int& month, int& day) {
+        if (!IsValid(year, term)) {
+            return false;
+        }
+        const DMCivilDate date = CDMCivil::CivilFromDays(Days(year, term));
+        month = date.month;
+        day = date.day;
+        return true;
+    }
+
+    // 严格晚于 t 的下一个节气；超出表范围返回 false
+    static bool Next(time_t t, int& year, int& term, long long& timestamp) {
+        // 第 2m、2m+1 个节气都落在第 m+1 月上半月与下半月，上个月的节气必然早于 t，
+        // 从 t 所在月的第一个节气往后最多走三步
+        const long long seconds = static_cast<long long>(t);
+        const DMCivilDate date = CDMCivil::CivilFromDays(CDMCivil::FloorDiv(seconds, CDMCivil::SECONDS_PER_DAY));
+        int y = date.year;
+        int k = (date.month - 1) * 2;
+        if (y < MIN_YEAR) {
+            y = MIN_YEAR;
+            k = 0;
+        }
+        for (;;) {
+            if (!IsYearInRange(y)) {
+                return false;
+            }
+            const long long when = Timestamp(y, k);
+            if (when > seconds) {
+                year = y;
+                term = k;
+                timestamp = when;
+                return true;
+            }
+            if (++k == TERM_COUNT) {
+                k = 0;
+                ++y;
+            }
+        }
+    }
+
+    // t 所处的节气（交节时刻 <= t 的最后一个）；早于 1900 年小寒或超出范围返回 false。
+    // 2100 年冬至之后只能确定到 2101 年小寒的基准日（各年偏移非负，小寒不早于这一天）为止，此后返回 false
+    static bool Current(time_t t, int& year, int& term, long long& timestamp) {
+        int next_year = 0;
+        int next_term = 0;
+        long long next_timestamp = 0;
+        if (!Next(t, next_year, next_term, next_timestamp)) {
+            const long long last = Timestamp(MAX_YEAR, TERM_COUNT - 1);
+            const long long next_earliest = CDMCivil::DaysFromCivil(MAX_YEAR + 1, CDMSolarTermTable::BASE_MONTH[0], CDMSolarTermTable::BASE_DAY[0])
+                * CDMCivil::SECONDS_PER_DAY - CHINA_UTC_OFFSET;
+            const long long seconds = static_cast<long long>(t);
+            if (seconds < last || seconds >= next_earliest) {
+                return false;
+            }
+            year = MAX_YEAR;
+            term = TERM_COUNT - 1;
+            timestamp = last;
+            return true;
+        }
+        year = next_term == 0 ? next_year - 1 : next_year;
+        term = next_term == 0 ? TERM_COUNT - 1 : next_term - 1;
+        if (!IsYearInRange(year)) {
+            return false;
+        }
+        timestamp = Timestamp(year, term);
+        return true;
+    }
+
+    static const char* GetName(int term) {
+        static const char* const names[TERM_COUNT] = {
+            "小寒", "大寒", "立春", "雨水", "惊蛰", "春分", "清明", "谷雨", "立夏", "小满", "芒种", "夏至",
+            "小暑", "大暑", "立秋", "处暑", "白露", "秋分", "寒露", "霜降", "立冬", "小雪", "大雪", "冬至"
+        };
+        return term >= 0 && term < TERM_COUNT ? names[term] : "";
+    }
+};
+
+// 2024 立春 2024-02-04 16:27（北京时间），2024 冬至 2024-12-21
+static_assert(CDMSolarTerm::Timestamp(2024, CDMSolarTerm::START_OF_SPRING) == 1707035220LL, "2024 start of spring");
+static_assert(CDMSolarTerm::Days(2024, CDMSolarTerm::WINTER_SOLSTICE) == CDMCivil::DaysFromCivil(2024, 12, 21), "2024 winter solstice");
+
+#endif // __DMSOLARTERM_H__
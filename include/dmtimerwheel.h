@@ -0,0 +1,477 @@
+﻿// Copyright (c) 2018 brinkqiang (brink.qiang@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __DMTIMERWHEEL_H__
+#define __DMTIMERWHEEL_H__
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+#include "dmdatetime.h"
+
+// 分层时间轮，精度一秒，时间一律取 CDMDateTime 的时间戳。
+// 五层：第 0 层 256 个槽（每槽 1 秒），第 1-4 层各 64 个槽（每槽分别 2^8、2^14、2^20、2^26 秒），
+// 可直接容纳约 136 年内的定时器，更远的先放在最高层，逐层下沉时再重新定位。
+//   AddTimer / Cancel  O(1)：槽是定时器下标的连续数组，取消时与末尾交换删除；TimerId 带代数，过期或取消后的 Id 失效
+//   Advance            按秒推进，每秒把第 0 层的一个槽整批取出触发；槽为空时借助占用位图直接跳过
+// 日历型周期定时器（每天 / 每周 / 每月）在触发后用 TomorrowAt / NextWeekdayAt / NextMonthOn
+// 由本次计划时间推算下一次，按本地时间对齐，不会因为夏令时或月份长短累积漂移。
+// 非线程安全，回调在 Advance 的调用线程中执行，回调内可以继续添加或取消定时器。
+
+class CDMTimerWheel {
+public:
+    typedef uint64_t TimerId;
+    typedef std::function<void(TimerId id, const CDMDateTime& scheduled)> Callback;
+
+    static const TimerId INVALID_TIMER = 0;
+
+    explicit CDMTimerWheel(const CDMDateTime& start = CDMDateTime::Now())
+        : current_(static_cast<long long>(start.GetTimestamp())) {
+        std::fill(occupied_, occupied_ + 4, 0);
+    }
+
+    // 已经处理到的时刻
+    inline CDMDateTime GetCurrentTime() const {
+        return CDMDateTime::FromTimestamp(static_cast<time_t>(current_));
+    }
+
+    inline size_t Size() const {
+        return size_;
+    }
+
+    inline bool Empty() const {
+        return size_ == 0;
+    }
+
+    // 在 when 触发一次；when 不晚于当前时刻时在下一秒触发
+    inline TimerId AddTimer(const CDMDateTime& when, Callback callback) {
+        return add(static_cast<long long>(when.GetTimestamp()), std::move(callback), Recurrence());
+    }
+
+    inline TimerId AddTimer(const CDMTimeSpan& delay, Callback callback) {
+        return add(current_ + static_cast<long long>(delay.GetTotalSeconds()), std::move(callback), Recurrence());
+    }
+
+    // 每隔 period 触发一次，首次在 period 之后
+    inline TimerId AddInterval(const CDMTimeSpan& period, Callback callback) {
+        const long long seconds = static_cast<long long>(period.GetTotalSeconds());
+        if (seconds <= 0) {
+            throw std::runtime_error("Timer period must be positive.");
+        }
+        Recurrence recurrence;
+        recurrence.kind = RECUR_INTERVAL;
+        recurrence.period = seconds;
+        return add(current_ + seconds, std::move(callback), recurrence);
+    }
+
+    // 每天本地时间 hour:minute:second
+    inline TimerId AddDaily(int hour, int minute, int second, Callback callback) {
+        return add_calendar(RECUR_DAILY, 0, hour, minute, second, std::move(callback));
+    }
+
+    // 每周 weekday（0=周日 … 6=周六）的 hour:minute:second
+    inline TimerId AddWeekly(int weekday, int hour, int minute, int second, Callback callback) {
+        if (weekday < 0 || weekday > 6) {
+            throw std::out_of_range("weekday must be between 0 (Sunday) and 6 (Saturday).");
+        }
+        return add_calendar(RECUR_WEEKLY, weekday, hour, minute, second, std::move(callback));
+    }
+
+    // 每月 day 日的 hour:minute:second；当月没有这一天（如 2 月 30 日）时在当月最后一天触发
+    inline TimerId AddMonthly(int day, int hour, int minute, int second, Callback callback) {
+        if (day < 1 || day > 31) {
+            throw std::out_of_range("day must be between 1 and 31.");
+        }
+        return add_calendar(RECUR_MONTHLY, day, hour, minute, second, std::move(callback));
+    }
+
+    // 取消定时器；Id 已失效时返回 false。可以在回调中取消自己，周期定时器随之停止
+    inline bool Cancel(TimerId id) {
+        const uint32_t index = find(id);
+        if (index == NIL) {
+            return false;
+        }
+        Slot& slot = slots_[index];
+        if (slot.slot >= SLOT_FIRING) {
+            // 同一批次里尚未执行的或正在执行的回调，轮到它时再回收
+            slot.cancelled = true;
+            return true;
+        }
+        unlink(index);
+        release(index);
+        return true;
+    }
+
+    // 下一次触发的计划时间，Id 已失效时返回 false
+    inline bool GetFireTime(TimerId id, CDMDateTime& when) const {
+        const uint32_t index = find(id);
+        if (index == NIL || slots_[index].cancelled) {
+            return false;
+        }
+        when = CDMDateTime::FromTimestamp(static_cast<time_t>(slots_[index].expires));
+        return true;
+    }
+
+    // 推进到 now，依次触发 (当前时刻, now] 内到期的定时器，返回触发次数
+    inline size_t Advance(const CDMDateTime& now) {
+        const long long target = static_cast<long long>(now.GetTimestamp());
+        size_t fired = 0;
+        while (current_ < target) {
+            if (size_ == 0) {
+                current_ = target;
+                break;
+            }
+            long long tick = current_ + 1;
+            if ((tick & L0_MASK) == 0) {
+                cascade(tick);
+            }
+            const int slot = static_cast<int>(tick & L0_MASK);
+            if (buckets_[slot].empty()) {
+                // 跳到本轮第 0 层的下一个非空槽，或下一次下沉的边界
+                const int next = next_occupied_l0(slot);
+                const long long jump = (tick & ~static_cast<long long>(L0_MASK)) + next;
+                if (jump > target) {
+                    current_ = target;
+                    break;
+                }
+                if (next > L0_MASK) {
+                    current_ = jump - 1;
+                    continue;
+                }
+                tick = jump;
+            }
+            current_ = tick;
+            fired += expire(static_cast<int>(tick & L0_MASK));
+        }
+        return fired;
+    }
+
+    inline size_t Advance() {
+        return Advance(CDMDateTime::Now());
+    }
+
+private:
+    static const uint32_t NIL = 0xFFFFFFFFu;
+    static const int L0_BITS = 8;
+    static const int LN_BITS = 6;
+    static const int L0_SIZE = 1 << L0_BITS;
+    static const int LN_SIZE = 1 << LN_BITS;
+    static const int L0_MASK = L0_SIZE - 1;
+    static const int LN_MASK = LN_SIZE - 1;
+    static const int LEVELS = 5;
+    static const int SLOT_COUNT = L0_SIZE + (LEVELS - 1) * LN_SIZE;
+    static const int SLOT_FIRING = SLOT_COUNT;        // 本秒待触发的这一批
+    static const int SLOT_EXECUTING = SLOT_COUNT + 1; // 回调正在执行
+    static const int SLOT_NONE = -1;
+    static const long long MAX_DELTA = (1LL << (L0_BITS + (LEVELS - 1) * LN_BITS)) - 1;
+
+    enum RecurrenceKind {
+        RECUR_NONE = 0,
+        RECUR_INTERVAL,
+        RECUR_DAILY,
+        RECUR_WEEKLY,
+        RECUR_MONTHLY,
+    };
+
+    struct Recurrence {
+        RecurrenceKind kind = RECUR_NONE;
+        long long period = 0;
+        int day = 0; // 每周为星期几，每月为几号
+        int hour = 0;
+        int minute = 0;
+        int second = 0;
+    };
+
+    // 调度用的字段单独紧凑存放，挂槽、下沉、取消只访问这一部分
+    struct Slot {
+        long long expires = 0;
+        uint32_t generation = 1;
+        uint32_t position = 0; // 在所在槽数组中的下标
+        int slot = SLOT_NONE;
+        bool cancelled = false;
+    };
+
+    // 回调与周期规则只在触发时访问；deque 保证回调执行期间新增定时器不会让它失效
+    struct Task {
+        Recurrence recurrence;
+        Callback callback;
+    };
+
+    inline TimerId add(long long expires, Callback callback, const Recurrence& recurrence) {
+        uint32_t index;
+        if (!free_.empty()) {
+            index = free_.back();
+            free_.pop_back();
+        }
+        else {
+            index = static_cast<uint32_t>(slots_.size());
+            slots_.emplace_back();
+            tasks_.emplace_back();
+        }
+        Slot& slot = slots_[index];
+        slot.expires = expires;
+        slot.cancelled = false;
+        Task& task = tasks_[index];
+        task.recurrence = recurrence;
+        task.callback = std::move(callback);
+        place(index, current_ + 1);
+        ++size_;
+        return (static_cast<TimerId>(slot.generation) << 32) | index;
+    }
+
+    inline TimerId add_calendar(RecurrenceKind kind, int day, int hour, int minute, int second, Callback callback) {
+        Recurrence recurrence;
+        recurrence.kind = kind;
+        recurrence.day = day;
+        recurrence.hour = hour;
+        recurrence.minute = minute;
+        recurrence.second = second;
+        return add(first_calendar_fire(recurrence, CDMDateTime::FromTimestamp(static_cast<time_t>(current_))), std::move(callback), recurrence);
+    }
+
+    inline uint32_t find(TimerId id) const {
+        const uint32_t index = static_cast<uint32_t>(id & 0xFFFFFFFFu);
+        if (index >= slots_.size()) {
+            return NIL;
+        }
+        const Slot& slot = slots_[index];
+        if (slot.generation != static_cast<uint32_t>(id >> 32) || slot.slot == SLOT_NONE) {
+            return NIL;
+        }
+        return index;
+    }
+
+    // 按到期时间相对 base（下一个待处理的秒）的距离选择层和槽，已过期的放在 base
+    inline void place(uint32_t index, long long base) {
+        const long long expires = std::max(slots_[index].expires, base);
+        const long long delta = std::min(expires - base, MAX_DELTA);
+        const long long at = base + delta;
+        int slot;
+        if (delta < L0_SIZE) {
+            slot = static_cast<int>(at & L0_MASK);
+        }
+        else {
+            int level = 1;
+            while (level < LEVELS - 1 && delta >= (1LL << (L0_BITS + level * LN_BITS))) {
+                ++level;
+            }
+            slot = L0_SIZE + (level - 1) * LN_SIZE + static_cast<int>((at >> (L0_BITS + (level - 1) * LN_BITS)) & LN_MASK);
+        }
+        link(index, slot);
+    }
+
+    inline void link(uint32_t index, int slot) {
+        std::vector<uint32_t>& bucket = buckets_[slot];
+        slots_[index].slot = slot;
+        slots_[index].position = static_cast<uint32_t>(bucket.size());
+        bucket.push_back(index);
+        if (slot < L0_SIZE) {
+            occupied_[slot >> 6] |= 1ULL << (slot & 63);
+        }
+    }
+
+    inline void unlink(uint32_t index) {
+        Slot& slot = slots_[index];
+        std::vector<uint32_t>& bucket = buckets_[slot.slot];
+        const uint32_t last = bucket.back();
+        bucket[slot.position] = last;
+        slots_[last].position = slot.position;
+        bucket.pop_back();
+        if (slot.slot < L0_SIZE && bucket.empty()) {
+            occupied_[slot.slot >> 6] &= ~(1ULL << (slot.slot & 63));
+        }
+        slot.slot = SLOT_NONE;
+    }
+
+    inline void release(uint32_t index) {
+        Slot& slot = slots_[index];
+        slot.slot = SLOT_NONE;
+        ++slot.generation;
+        if (slot.generation == 0) {
+            slot.generation = 1;
+        }
+        tasks_[index].callback = nullptr;
+        free_.push_back(index);
+        --size_;
+    }
+
+    // 第 0 层 from 及之后第一个非空槽，没有时返回 L0_SIZE
+    inline int next_occupied_l0(int from) const {
+        for (int word = from >> 6; word < L0_SIZE / 64; ++word) {
+            uint64_t bits = occupied_[word];
+            if (word == (from >> 6)) {
+                bits &= ~0ULL << (from & 63);
+            }
+            if (bits != 0) {
+                return word * 64 + count_trailing_zeros(bits);
+            }
+        }
+        return L0_SIZE;
+    }
+
+    static inline int count_trailing_zeros(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzll(value);
+#else
+        int index = 0;
+        while ((value & 1u) == 0) {
+            value >>= 1;
+            ++index;
+        }
+        return index;
+#endif
+    }
+
+    // tick 落在第 0 层一轮的起点：把上一层对应的槽重新分配到下层，必要时逐层向上
+    inline void cascade(long long tick) {
+        for (int level = 1; level < LEVELS; ++level) {
+            const int shift = L0_BITS + (level - 1) * LN_BITS;
+            const int index = static_cast<int>((tick >> shift) & LN_MASK);
+            const int slot = L0_SIZE + (level - 1) * LN_SIZE + index;
+            scratch_.swap(buckets_[slot]);
+            for (uint32_t node : scratch_) {
+                place(node, tick);
+            }
+            scratch_.clear();
+            if (index != 0) {
+                break;
+            }
+        }
+    }
+
+    // 触发第 0 层的一个槽，返回触发次数
+    inline size_t expire(int slot) {
+        // 整批换出到 firing_，回调里新增的定时器进入各自的槽，取消同批的定时器只做标记
+        std::vector<uint32_t> firing;
+        firing.swap(firing_);
+        firing.swap(buckets_[slot]);
+        occupied_[slot >> 6] &= ~(1ULL << (slot & 63));
+        for (uint32_t index : firing) {
+            slots_[index].slot = SLOT_FIRING;
+        }
+        size_t fired = 0;
+        for (uint32_t index : firing) {
+            Slot& state = slots_[index];
+            if (state.cancelled) {
+                release(index);
+                continue;
+            }
+            if (state.expires > current_) {
+                // 超出 MAX_DELTA 的远期定时器，落到这里时尚未到期
+                place(index, current_ + 1);
+                continue;
+            }
+            state.slot = SLOT_EXECUTING;
+            const TimerId id = (static_cast<TimerId>(state.generation) << 32) | index;
+            const CDMDateTime scheduled = CDMDateTime::FromTimestamp(static_cast<time_t>(state.expires));
+            Task& task = tasks_[index];
+            task.callback(id, scheduled);
+            ++fired;
+            // 回调中可能新增定时器使 slots_ 扩容，重新取引用
+            Slot& after = slots_[index];
+            if (after.cancelled || task.recurrence.kind == RECUR_NONE) {
+                release(index);
+                continue;
+            }
+            after.expires = next_fire(task.recurrence, scheduled);
+            place(index, current_ + 1);
+        }
+        firing.clear();
+        firing_.swap(firing);
+        return fired;
+    }
+
+    // 由本次计划时间推算下一次；推算结果不晚于当前时刻时（本地时间回拨等）改从当前时刻推算
+    inline long long next_fire(const Recurrence& recurrence, const CDMDateTime& scheduled) const {
+        long long next;
+        switch (recurrence.kind) {
+        case RECUR_INTERVAL:
+            next = static_cast<long long>(scheduled.GetTimestamp()) + recurrence.period;
+            if (next <= current_) {
+                next += ((current_ - next) / recurrence.period + 1) * recurrence.period;
+            }
+            return next;
+        case RECUR_DAILY:
+            next = static_cast<long long>(scheduled.TomorrowAt(recurrence.hour, recurrence.minute, recurrence.second).GetTimestamp());
+            break;
+        case RECUR_WEEKLY:
+            next = static_cast<long long>(scheduled.NextWeekdayAt(recurrence.day, recurrence.hour, recurrence.minute, recurrence.second).GetTimestamp());
+            break;
+        default:
+            next = static_cast<long long>(next_month_on(scheduled, recurrence).GetTimestamp());
+            break;
+        }
+        if (next <= current_) {
+            next = first_calendar_fire(recurrence, CDMDateTime::FromTimestamp(static_cast<time_t>(current_)));
+        }
+        return next;
+    }
+
+    // 严格晚于 now 的第一次日历触发时间
+    static inline long long first_calendar_fire(const Recurrence& recurrence, const CDMDateTime& now) {
+        CDMDateTime next;
+        switch (recurrence.kind) {
+        case RECUR_DAILY:
+            next = now.TodayAt(recurrence.hour, recurrence.minute, recurrence.second);
+            if (next <= now) {
+                next = now.TomorrowAt(recurrence.hour, recurrence.minute, recurrence.second);
+            }
+            break;
+        case RECUR_WEEKLY:
+            next = now.TodayAt(recurrence.hour, recurrence.minute, recurrence.second);
+            if (now.GetDayOfWeek() != recurrence.day || next <= now) {
+                next = now.NextWeekdayAt(recurrence.day, recurrence.hour, recurrence.minute, recurrence.second);
+            }
+            break;
+        default:
+            next = CDMDateTime(now.GetYear(), now.GetMonth(),
+                std::min(recurrence.day, CDMCivil::DaysInMonth(now.GetYear(), now.GetMonth())),
+                recurrence.hour, recurrence.minute, recurrence.second);
+            if (next <= now) {
+                next = next_month_on(now, recurrence);
+            }
+            break;
+        }
+        return static_cast<long long>(next.GetTimestamp());
+    }
+
+    // NextMonthOn，但把日期夹到下个月的天数以内
+    static inline CDMDateTime next_month_on(const CDMDateTime& from, const Recurrence& recurrence) {
+        const int year = from.GetMonth() == 12 ? from.GetYear() + 1 : from.GetYear();
+        const int month = from.GetMonth() % 12 + 1;
+        return from.NextMonthOn(std::min(recurrence.day, CDMCivil::DaysInMonth(year, month)),
+            recurrence.hour, recurrence.minute, recurrence.second);
+    }
+
+    long long current_;
+    size_t size_ = 0;
+    std::vector<Slot> slots_;
+    std::deque<Task> tasks_;
+    std::vector<uint32_t> free_;
+    std::vector<uint32_t> buckets_[SLOT_COUNT];
+    std::vector<uint32_t> scratch_;
+    std::vector<uint32_t> firing_;
+    uint64_t occupied_[4]; // 第 0 层非空槽位图
+};
+
+#endif // __DMTIMERWHEEL_H__
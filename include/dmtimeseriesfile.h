@@ -0,0 +1,336 @@
+﻿// Copyright (c) 2018 brinkqiang (brink.qiang@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __DMTIMESERIESFILE_H__
+#define __DMTIMESERIESFILE_H__
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "dmmappedfile.h"
+#include "dmtimestampcolumn.h"
+
+// 有序时间戳的文件格式，读取端整体 mmap，按时间范围查询时只访问命中的块。
+//
+//   文件头   16 字节   "DMTS" | 版本(u32) | 块大小(u32) | 保留(u32)
+//   数据块   每块为 CDMTimestampColumn 的 delta-of-delta 比特流（64 位字，8 字节对齐）
+//   块索引   每块一项 Entry：首值、末值、数据偏移、个数、字数
+//   文件尾   Footer：索引偏移、块数、总个数、字节序标记、"DMTSEND\0"
+//
+// 写入端要求时间戳不减，块首值 / 末值即块内最小 / 最大值；索引在 Close 时统一写出。
+// 读取端打开时只校验文件头尾，块索引项在用到时检查。查询对块索引二分，取一小时的数据只会让索引的几页
+// 与一两个数据块所在的页缺页，与文件总大小无关。整数按本机字节序存放，字节序不同的文件会被拒绝。
+
+class CDMTimeSeriesFile {
+public:
+    enum { DEFAULT_BLOCK_SIZE = 1024, VERSION = 1 };
+
+    struct Header {
+        char magic[4];
+        uint32_t version;
+        uint32_t block_size;
+        uint32_t reserved;
+    };
+
+    struct Entry {
+        int64_t first;
+        int64_t last;
+        uint64_t offset;     // 块数据在文件中的字节偏移
+        uint32_t count;
+        uint32_t word_count;
+    };
+
+    struct Footer {
+        uint64_t index_offset;
+        uint64_t block_count;
+        uint64_t total_count;
+        uint64_t byte_order;
+        char magic[8];
+    };
+
+    static constexpr uint64_t BYTE_ORDER_MARK = 0x0102030405060708ULL;
+};
+
+class CDMTimeSeriesWriter {
+public:
+    explicit CDMTimeSeriesWriter(const std::string& path, size_t block_size = CDMTimeSeriesFile::DEFAULT_BLOCK_SIZE)
+        : path_(path), column_(block_size), block_size_(block_size) {
+#ifdef _WIN32
+        if (fopen_s(&fp_, path.c_str(), "wb") != 0) {
+            fp_ = nullptr;
+        }
+#else
+        fp_ = std::fopen(path.c_str(), "wb");
+#endif
+        if (fp_ == nullptr) {
+            throw std::runtime_error("Failed to create time series file: '" + path + "'");
+        }
+        CDMTimeSeriesFile::Header header{};
+        std::memcpy(header.magic, "DMTS", 4);
+        header.version = CDMTimeSeriesFile::VERSION;
+        header.block_size = static_cast<uint32_t>(block_size);
+        try {
+            write(&header, sizeof(header));
+        }
+        catch (...) {
+            std::fclose(fp_);
+            throw;
+        }
+    }
+
+    CDMTimeSeriesWriter(const CDMTimeSeriesWriter&) = delete;
+    CDMTimeSeriesWriter& operator=(const CDMTimeSeriesWriter&) = delete;
+
+    ~CDMTimeSeriesWriter() {
+        try {
+            Close();
+        }
+        catch (...) {
+        }
+    }
+
+    // 追加一个时间戳，必须不早于上一个，否则抛出 std::runtime_error
+    void Append(time_t timestamp) {
+        if (fp_ == nullptr) {
+            throw std::runtime_error("Time series file is closed: '" + path_ + "'");
+        }
+        if (total_count_ > 0 && timestamp < last_) {
+            throw std::runtime_error("Time series timestamps must be non-decreasing.");
+        }
+        column_.Append(timestamp);
+        last_ = timestamp;
+        ++total_count_;
+        if (column_.Size() == block_size_) {
+            flush_block();
+        }
+    }
+
+    inline void Append(const CDMDateTime& when) {
+        Append(when.GetTimestamp());
+    }
+
+    void Append(const time_t* timestamps, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            Append(timestamps[i]);
+        }
+    }
+
+    inline uint64_t Size() const {
+        return total_count_;
+    }
+
+    // 写出最后一块、块索引与文件尾；重复调用无效果
+    void Close() {
+        if (fp_ == nullptr) {
+            return;
+        }
+        flush_block();
+        CDMTimeSeriesFile::Footer footer{};
+        footer.index_offset = offset_;
+        footer.block_count = entries_.size();
+        footer.total_count = total_count_;
+        footer.byte_order = CDMTimeSeriesFile::BYTE_ORDER_MARK;
+        std::memcpy(footer.magic, "DMTSEND", 8);
+        if (!entries_.empty()) {
+            write(entries_.data(), entries_.size() * sizeof(CDMTimeSeriesFile::Entry));
+        }
+        write(&footer, sizeof(footer));
+        const bool ok = std::fclose(fp_) == 0;
+        fp_ = nullptr;
+        if (!ok) {
+            throw std::runtime_error("Failed to close time series file: '" + path_ + "'");
+        }
+    }
+
+private:
+    void write(const void* data, size_t size) {
+        if (std::fwrite(data, 1, size, fp_) != size) {
+            throw std::runtime_error("Failed to write time series file: '" + path_ + "'");
+        }
+        offset_ += size;
+    }
+
+    void flush_block() {
+        if (column_.Empty()) {
+            return;
+        }
+        const uint64_t* words = nullptr;
+        size_t word_count = 0;
+        column_.GetBlockWords(0, words, word_count);
+        const CDMTimestampColumn::Block& block = column_.GetBlock(0);
+        entries_.push_back(CDMTimeSeriesFile::Entry{ block.first, block.max, offset_, block.count, static_cast<uint32_t>(word_count) });
+        write(words, word_count * sizeof(uint64_t));
+        column_.Clear();
+    }
+
+    std::string path_;
+    FILE* fp_ = nullptr;
+    CDMTimestampColumn column_;
+    size_t block_size_;
+    uint64_t offset_ = 0;
+    uint64_t total_count_ = 0;
+    time_t last_ = 0;
+    std::vector<CDMTimeSeriesFile::Entry> entries_;
+};
+
+class CDMTimeSeriesReader {
+public:
+    // 映射并校验文件，失败抛出 std::runtime_error
+    explicit CDMTimeSeriesReader(const std::string& path)
+        : path_(path), file_(path), data_(reinterpret_cast<const unsigned char*>(file_.Data())), size_(file_.Size()) {
+        validate();
+    }
+
+    inline uint64_t Size() const {
+        return footer_.total_count;
+    }
+
+    inline size_t GetBlockCount() const {
+        return static_cast<size_t>(footer_.block_count);
+    }
+
+    inline const CDMTimeSeriesFile::Entry& GetBlock(size_t block) const {
+        return entries_[block];
+    }
+
+    // 文件中最早 / 最晚的时间戳，空文件抛出 std::runtime_error
+    CDMDateTime GetFirst() const {
+        check_not_empty();
+        return CDMDateTime::FromTimestamp(static_cast<time_t>(entries_[0].first));
+    }
+
+    CDMDateTime GetLast() const {
+        check_not_empty();
+        return CDMDateTime::FromTimestamp(static_cast<time_t>(entries_[footer_.block_count - 1].last));
+    }
+
+    // 解码第 block 块到 out（至少 GetBlock(block).count 个）
+    size_t DecodeBlock(size_t block, time_t* out) const {
+        const CDMTimeSeriesFile::Entry& entry = entries_[block];
+        if (entry.count == 0 || entry.offset % 8 != 0 || entry.offset < sizeof(CDMTimeSeriesFile::Header) ||
+            entry.offset > footer_.index_offset || entry.word_count > (footer_.index_offset - entry.offset) / 8) {
+            throw std::runtime_error("Corrupted time series block index: '" + path_ + "'");
+        }
+        return CDMTimestampColumn::DecodeWords(block_words(entry), entry.word_count, static_cast<time_t>(entry.first), entry.count, out);
+    }
+
+    // 追加 [start, end) 内的时间戳，返回追加的个数
+    size_t Query(const CDMDateTime& start, const CDMDateTime& end, std::vector<time_t>& out) const {
+        const size_t before = out.size();
+        visit_range(start.GetTimestamp(), end.GetTimestamp(), [&out](const time_t* begin, const time_t* finish) {
+            out.insert(out.end(), begin, finish);
+        }, [&out](size_t block, const CDMTimeSeriesReader& reader) {
+            const size_t offset = out.size();
+            out.resize(offset + reader.entries_[block].count);
+            reader.DecodeBlock(block, out.data() + offset);
+        });
+        return out.size() - before;
+    }
+
+    // [start, end) 内的个数：完整落在范围内的块直接用索引里的个数，只解码两端的块
+    uint64_t Count(const CDMDateTime& start, const CDMDateTime& end) const {
+        uint64_t count = 0;
+        visit_range(start.GetTimestamp(), end.GetTimestamp(), [&count](const time_t* begin, const time_t* finish) {
+            count += static_cast<uint64_t>(finish - begin);
+        }, [&count](size_t block, const CDMTimeSeriesReader& reader) {
+            count += reader.entries_[block].count;
+        });
+        return count;
+    }
+
+private:
+    void check_not_empty() const {
+        if (footer_.block_count == 0) {
+            throw std::runtime_error("Time series file is empty: '" + path_ + "'");
+        }
+    }
+
+    inline const uint64_t* block_words(const CDMTimeSeriesFile::Entry& entry) const {
+        return reinterpret_cast<const uint64_t*>(data_ + entry.offset);
+    }
+
+    // 对与 [begin, end) 相交的块：完整包含的块交给 whole(block)，两端的块解码后把命中部分交给 partial(first, last)
+    template<typename Partial, typename Whole>
+    void visit_range(time_t begin, time_t end, Partial&& partial, Whole&& whole) const {
+        if (!(begin < end)) {
+            return;
+        }
+        const int64_t lo = static_cast<int64_t>(begin);
+        const int64_t hi = static_cast<int64_t>(end);
+        const CDMTimeSeriesFile::Entry* first = entries_;
+        const CDMTimeSeriesFile::Entry* last = entries_ + footer_.block_count;
+        // 第一个末值不早于 begin 的块
+        const CDMTimeSeriesFile::Entry* it = std::lower_bound(first, last, lo,
+            [](const CDMTimeSeriesFile::Entry& entry, int64_t value) { return entry.last < value; });
+        std::vector<time_t> scratch;
+        for (; it != last && it->first < hi; ++it) {
+            const size_t block = static_cast<size_t>(it - first);
+            if (it->first >= lo && it->last < hi) {
+                whole(block, *this);
+                continue;
+            }
+            scratch.resize(it->count);
+            DecodeBlock(block, scratch.data());
+            const time_t* data = scratch.data();
+            const time_t* from = std::lower_bound(data, data + scratch.size(), begin);
+            const time_t* to = std::lower_bound(from, data + scratch.size(), end);
+            partial(from, to);
+        }
+    }
+
+    void validate() {
+        const size_t header_size = sizeof(CDMTimeSeriesFile::Header);
+        const size_t footer_size = sizeof(CDMTimeSeriesFile::Footer);
+        if (size_ < header_size + footer_size) {
+            throw std::runtime_error("Time series file is truncated: '" + path_ + "'");
+        }
+        CDMTimeSeriesFile::Header header;
+        std::memcpy(&header, data_, header_size);
+        std::memcpy(&footer_, data_ + size_ - footer_size, footer_size);
+        if (std::memcmp(header.magic, "DMTS", 4) != 0 || std::memcmp(footer_.magic, "DMTSEND", 8) != 0) {
+            throw std::runtime_error("Not a time series file: '" + path_ + "'");
+        }
+        if (header.version != CDMTimeSeriesFile::VERSION || footer_.byte_order != CDMTimeSeriesFile::BYTE_ORDER_MARK) {
+            throw std::runtime_error("Unsupported time series file version or byte order: '" + path_ + "'");
+        }
+        // 先限定索引偏移再做减法，损坏的偏移不会因加法回绕而通过校验
+        const uint64_t index_bytes = footer_.block_count * sizeof(CDMTimeSeriesFile::Entry);
+        if (footer_.index_offset % 8 != 0 || footer_.block_count > size_ / sizeof(CDMTimeSeriesFile::Entry) ||
+            footer_.index_offset < header_size || footer_.index_offset > size_ - footer_size ||
+            size_ - footer_size - footer_.index_offset != index_bytes) {
+            throw std::runtime_error("Corrupted time series index: '" + path_ + "'");
+        }
+        // 块索引项在访问时才校验，打开文件不触碰整个索引
+        entries_ = reinterpret_cast<const CDMTimeSeriesFile::Entry*>(data_ + footer_.index_offset);
+    }
+
+    std::string path_;
+    CDMMappedFile file_;
+    const unsigned char* data_;
+    size_t size_;
+    CDMTimeSeriesFile::Footer footer_{};
+    const CDMTimeSeriesFile::Entry* entries_ = nullptr;
+};
+
+#endif // __DMTIMESERIESFILE_H__
@@ -0,0 +1,390 @@
+﻿// Copyright (c) 2018 brinkqiang (brink.qiang@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __DMTIMESTAMPCOLUMN_H__
+#define __DMTIMESTAMPCOLUMN_H__
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "dmdatetime.h"
+
+// 时间戳列的 delta-of-delta 压缩（Gorilla 风格）。
+// 按块存放，每块最多 block_size 个时间戳，块头记录首值、最小值、最大值、个数与数据起始字；
+// 块内从第二个值起只写“本次间隔 - 上次间隔”（dod），按高位在前的比特流编码：
+//   0                    dod = 0
+//   10    + 7 位         dod ∈ [-63, 64]
+//   110   + 9 位         dod ∈ [-255, 256]
+//   1110  + 12 位        dod ∈ [-2047, 2048]
+//   11110 + 32 位        dod 可用 int32 表示
+//   11111 + 64 位        其他
+// 间隔固定的序列每个时间戳只占 1 位，解码时用前导零计数一次展开整段连续的 0。
+// 每块从新的 64 位字开始，可以按块随机访问；最小 / 最大值用于按时间范围查询时跳过整块。
+
+class CDMTimestampColumn {
+public:
+    enum { DEFAULT_BLOCK_SIZE = 1024 };
+
+    // 块头
+    struct Block {
+        long long first;
+        long long min;
+        long long max;
+        uint32_t count;
+        uint32_t word_offset; // 块数据在字数组中的起始下标
+    };
+
+    explicit CDMTimestampColumn(size_t block_size = DEFAULT_BLOCK_SIZE) : block_size_(block_size) {
+        if (block_size == 0 || block_size > 0xFFFFFFFFu) {
+            throw std::runtime_error("Invalid timestamp column block size.");
+        }
+    }
+
+    // 追加一个时间戳，块写满后自动开始新块
+    void Append(time_t timestamp) {
+        const long long value = static_cast<long long>(timestamp);
+        if (blocks_.empty() || blocks_.back().count == block_size_) {
+            if (words_.size() > 0xFFFFFFFFu) {
+                throw std::runtime_error("Timestamp column is too large.");
+            }
+            blocks_.push_back(Block{ value, value, value, 1, static_cast<uint32_t>(words_.size()) });
+            bit_count_ = 0;
+            previous_ = value;
+            previous_delta_ = 0;
+            ++size_;
+            return;
+        }
+        Block& block = blocks_.back();
+        const uint64_t delta = static_cast<uint64_t>(value) - static_cast<uint64_t>(previous_);
+        const long long dod = static_cast<long long>(delta - previous_delta_);
+        if (dod == 0) {
+            write_bits(0, 1);
+        }
+        else if (dod >= -63 && dod <= 64) {
+            write_bits((0x2ULL << 7) | static_cast<uint64_t>(dod + 63), 9);
+        }
+        else if (dod >= -255 && dod <= 256) {
+            write_bits((0x6ULL << 9) | static_cast<uint64_t>(dod + 255), 12);
+        }
+        else if (dod >= -2047 && dod <= 2048) {
+            write_bits((0xEULL << 12) | static_cast<uint64_t>(dod + 2047), 16);
+        }
+        else if (dod >= INT32_MIN && dod <= INT32_MAX) {
+            write_bits((0x1EULL << 32) | static_cast<uint32_t>(static_cast<int32_t>(dod)), 37);
+        }
+        else {
+            write_bits(0x1F, 5);
+            write_bits(static_cast<uint64_t>(dod), 64);
+        }
+        block.min = std::min(block.min, value);
+        block.max = std::max(block.max, value);
+        ++block.count;
+        previous_ = value;
+        previous_delta_ = delta;
+        ++size_;
+    }
+
+    inline void Append(const CDMDateTime& when) {
+        Append(when.GetTimestamp());
+    }
+
+    void Append(const time_t* timestamps, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            Append(timestamps[i]);
+        }
+    }
+
+    inline size_t Size() const {
+        return size_;
+    }
+
+    inline bool Empty() const {
+        return size_ == 0;
+    }
+
+    inline size_t GetBlockSize() const {
+        return block_size_;
+    }
+
+    inline size_t GetBlockCount() const {
+        return blocks_.size();
+    }
+
+    inline const Block& GetBlock(size_t block) const {
+        return blocks_[block];
+    }
+
+    // 压缩数据（块头 + 比特流）占用的字节数
+    inline size_t GetCompressedBytes() const {
+        return blocks_.size() * sizeof(Block) + words_.size() * sizeof(uint64_t);
+    }
+
+    void Clear() {
+        blocks_.clear();
+        words_.clear();
+        size_ = 0;
+        bit_count_ = 0;
+    }
+
+    // 解码第 block 块到 out（至少能容纳 GetBlock(block).count 个），返回个数
+    size_t DecodeBlock(size_t block, time_t* out) const {
+        return decode_block(block, out, blocks_[block].count);
+    }
+
+    size_t DecodeBlock(size_t block, CDMDateTime* out) const {
+        const size_t count = blocks_[block].count;
+        std::vector<time_t> stamps(count);
+        decode_block(block, stamps.data(), count);
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = CDMDateTime::FromTimestamp(stamps[i]);
+        }
+        return count;
+    }
+
+    // 解码第 first 个起的 count 个时间戳，只访问覆盖该范围的块
+    void Decode(size_t first, size_t count, time_t* out) const {
+        if (first > size_ || count > size_ - first) {
+            throw std::runtime_error("Timestamp column range out of bounds.");
+        }
+        std::vector<time_t> scratch;
+        size_t block = first / block_size_;
+        size_t skip = first % block_size_;
+        while (count > 0) {
+            const size_t available = blocks_[block].count - skip;
+            const size_t take = std::min(count, available);
+            if (skip == 0 && take == blocks_[block].count) {
+                decode_block(block, out, take);
+            }
+            else {
+                scratch.resize(skip + take);
+                decode_block(block, scratch.data(), skip + take);
+                std::copy(scratch.begin() + static_cast<std::ptrdiff_t>(skip), scratch.end(), out);
+            }
+            out += take;
+            count -= take;
+            skip = 0;
+            ++block;
+        }
+    }
+
+    void Decode(size_t first, size_t count, CDMDateTime* out) const {
+        std::vector<time_t> stamps(count);
+        Decode(first, count, stamps.data());
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = CDMDateTime::FromTimestamp(stamps[i]);
+        }
+    }
+
+    std::vector<time_t> ToVector() const {
+        std::vector<time_t> result(size_);
+        time_t* out = result.data();
+        for (size_t block = 0; block < blocks_.size(); ++block) {
+            out += decode_block(block, out, blocks_[block].count);
+        }
+        return result;
+    }
+
+    // 第 index 个时间戳，需要解码所在块的前半部分
+    time_t At(size_t index) const {
+        if (index >= size_) {
+            throw std::runtime_error("Timestamp column index out of bounds.");
+        }
+        time_t value = 0;
+        Decode(index, 1, &value);
+        return value;
+    }
+
+    // 追加 [begin, end) 内的时间戳（保持列内顺序），最小 / 最大值不相交的块整块跳过；返回追加的个数
+    size_t FindRange(time_t begin, time_t end, std::vector<time_t>& out) const {
+        const long long lo = static_cast<long long>(begin);
+        const long long hi = static_cast<long long>(end);
+        std::vector<time_t> scratch;
+        const size_t before = out.size();
+        for (size_t block = 0; block < blocks_.size(); ++block) {
+            const Block& header = blocks_[block];
+            if (header.max < lo || header.min >= hi) {
+                continue;
+            }
+            if (header.min >= lo && header.max < hi) {
+                const size_t offset = out.size();
+                out.resize(offset + header.count);
+                decode_block(block, out.data() + offset, header.count);
+                continue;
+            }
+            scratch.resize(header.count);
+            decode_block(block, scratch.data(), header.count);
+            for (time_t t : scratch) {
+                if (static_cast<long long>(t) >= lo && static_cast<long long>(t) < hi) {
+                    out.push_back(t);
+                }
+            }
+        }
+        return out.size() - before;
+    }
+
+    // 解码一块的比特流：words 为块数据（word_count 个字），first 为块首值，解码前 count 个写入 out。
+    // 可直接作用于文件映射中的块数据（见 dmtimeseriesfile.h）
+    static size_t DecodeWords(const uint64_t* words, size_t word_count, time_t first, size_t count, time_t* out) {
+        size_t position = 0;
+        uint64_t value = static_cast<uint64_t>(first);
+        uint64_t delta = 0;
+        if (count == 0) {
+            return 0;
+        }
+        out[0] = static_cast<time_t>(value);
+        size_t i = 1;
+        // bits 为从 position 起的窗口（高位对齐），available 为其中有效的位数；
+        // 不足一个 37 位符号时才重新读取，多数符号只在寄存器里移位
+        uint64_t bits = 0;
+        int available = 0;
+        while (i < count) {
+            if (available < 37) {
+                bits = peek(words, word_count, position);
+                available = 64;
+            }
+            if ((bits >> 62) == 0) {
+                // 两个以上连续的 0：间隔不变，整段展开
+                const int zeros = bits == 0 ? available : std::min(count_leading_zeros(bits), available);
+                const size_t run = std::min(static_cast<size_t>(zeros), count - i);
+                for (size_t k = 0; k < run; ++k) {
+                    out[i + k] = static_cast<time_t>(value + (k + 1) * delta);
+                }
+                value += run * delta;
+                i += run;
+                position += run;
+                bits = run == 64 ? 0 : bits << run;
+                available -= static_cast<int>(run);
+                continue;
+            }
+            uint64_t dod;
+            int used;
+            if ((bits >> 62) != 0x3) {
+                // 单个 0 与 10 前缀在抖动数据里交替出现，用掩码二选一，避免分支预测失败
+                const uint64_t wide = bits >> 63;
+                dod = (((bits >> 55) & 0x7F) - 63) & (0 - wide);
+                used = 1 + 8 * static_cast<int>(wide);
+            }
+            else if ((bits >> 61) == 0x6) {
+                dod = ((bits >> 52) & 0x1FF) - 255;
+                used = 12;
+            }
+            else if ((bits >> 60) == 0xE) {
+                dod = ((bits >> 48) & 0xFFF) - 2047;
+                used = 16;
+            }
+            else if ((bits >> 59) == 0x1E) {
+                dod = static_cast<uint64_t>(static_cast<long long>(static_cast<int32_t>(static_cast<uint32_t>(bits >> 27))));
+                used = 37;
+            }
+            else {
+                dod = peek(words, word_count, position + 5);
+                used = 69;
+            }
+            position += static_cast<size_t>(used);
+            if (used < available) {
+                bits <<= used;
+                available -= used;
+            }
+            else {
+                available = 0;
+            }
+            delta += dod;
+            value += delta;
+            out[i++] = static_cast<time_t>(value);
+        }
+        return count;
+    }
+
+    // 第 block 块的比特流（words 指向内部存储，追加后可能失效）
+    inline void GetBlockWords(size_t block, const uint64_t*& words, size_t& word_count) const {
+        const size_t begin = blocks_[block].word_offset;
+        const size_t end = block + 1 < blocks_.size() ? blocks_[block + 1].word_offset : words_.size();
+        words = words_.data() + begin;
+        word_count = end - begin;
+    }
+
+private:
+    static inline int count_leading_zeros(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_clzll(value);
+#elif defined(_M_X64) || defined(_M_ARM64)
+        unsigned long index = 0;
+        _BitScanReverse64(&index, value);
+        return 63 - static_cast<int>(index);
+#else
+        int count = 0;
+        while ((value & (1ULL << 63)) == 0) {
+            value <<= 1;
+            ++count;
+        }
+        return count;
+#endif
+    }
+
+    // 追加 value 的低 bits 位（bits <= 64），当前块的比特流从 blocks_.back().word_offset 开始
+    inline void write_bits(uint64_t value, int bits) {
+        const int used = static_cast<int>(bit_count_ & 63);
+        if (used == 0) {
+            words_.push_back(0);
+        }
+        const int free = 64 - used;
+        if (bits <= free) {
+            words_.back() |= bits == 64 ? value : (value << (free - bits));
+        }
+        else {
+            words_.back() |= value >> (bits - free);
+            words_.push_back(value << (64 - (bits - free)));
+        }
+        bit_count_ += static_cast<uint64_t>(bits);
+    }
+
+    // 从 position 位开始的 64 位，越过 end 的部分补 0
+    static inline uint64_t peek(const uint64_t* words, size_t end, size_t position) {
+        const size_t index = position >> 6;
+        const int shift = static_cast<int>(position & 63);
+        if (index >= end) {
+            return 0;
+        }
+        uint64_t bits = words[index] << shift;
+        if (shift != 0 && index + 1 < end) {
+            bits |= words[index + 1] >> (64 - shift);
+        }
+        return bits;
+    }
+
+    // 解码第 block 块的前 limit 个时间戳
+    size_t decode_block(size_t block, time_t* out, size_t limit) const {
+        const Block& header = blocks_[block];
+        const size_t end = block + 1 < blocks_.size() ? blocks_[block + 1].word_offset : words_.size();
+        return DecodeWords(words_.data() + header.word_offset, end - header.word_offset, static_cast<time_t>(header.first), limit, out);
+    }
+
+    size_t block_size_;
+    size_t size_ = 0;
+    std::vector<Block> blocks_;
+    std::vector<uint64_t> words_;
+    // 当前块的编码状态
+    uint64_t bit_count_ = 0;
+    long long previous_ = 0;
+    uint64_t previous_delta_ = 0;
+};
+
+#endif // __DMTIMESTAMPCOLUMN_H__
@@ -0,0 +1,563 @@
+// Copyright (c) 2018 brinkqiang (brink.qiang@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __DMTIMEZONE_H__
+#define __DMTIMEZONE_H__
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <cstdint>
+#include <cstdlib>
+#include <cstdio>
+#include <ctime>
+#include "dmcivil.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// 内置 TZif (RFC 8536, v1/v2/v3) 时区引擎。
+// 加载时把 zoneinfo 文件 mmap 进来解析成两张有序数组（切换时刻 / 切换后偏移），
+// 并把尾部 POSIX TZ 规则预展开到 TRANSITION_HORIZON_YEAR，之后的时刻按规则现算。
+// 查询不加锁、不读环境变量，可供任意多线程并发调用。
+// 闰秒修正（right/ 目录下的时区）会被忽略，时间戳按 POSIX 秒处理。
+
+class CDMTimeZone {
+public:
+    static const int TRANSITION_HORIZON_YEAR = 2100;
+
+    // 按 IANA 名称（如 "Asia/Shanghai"）获取时区，首次调用时加载并永久缓存。
+    // 搜索目录为 $TZDIR，其次 /usr/share/zoneinfo。失败抛出 std::runtime_error。
+    static const CDMTimeZone* Get(const std::string& name) {
+        std::lock_guard<std::mutex> lock(registry_mutex());
+        auto& registry = zone_registry();
+        auto it = registry.find(name);
+        if (it != registry.end()) {
+            return it->second.get();
+        }
+        std::unique_ptr<CDMTimeZone> zone(new CDMTimeZone(name));
+        zone->load_file(resolve_path(name));
+        const CDMTimeZone* result = zone.get();
+        registry[name] = std::move(zone);
+        return result;
+    }
+
+    // 进程本地时区：$TZ 指定的名称（可带前导 ':'），未设置时读取 /etc/localtime。
+    static const CDMTimeZone* Local() {
+        const char* tz = std::getenv("TZ");
+        if (tz != nullptr && *tz != '\0') {
+            return Get(tz[0] == ':' ? tz + 1 : tz);
+        }
+        std::lock_guard<std::mutex> lock(registry_mutex());
+        auto& registry = zone_registry();
+        auto it = registry.find("localtime");
+        if (it != registry.end()) {
+            return it->second.get();
+        }
+        std::unique_ptr<CDMTimeZone> zone(new CDMTimeZone("localtime"));
+        zone->load_file("/etc/localtime");
+        const CDMTimeZone* result = zone.get();
+        registry["localtime"] = std::move(zone);
+        return result;
+    }
+
+    // 直接从内存中的 TZif 数据构造，不进入全局缓存，由调用者管理生命周期
+    static std::unique_ptr<CDMTimeZone> FromTZif(const std::string& name, const unsigned char* data, size_t size) {
+        std::unique_ptr<CDMTimeZone> zone(new CDMTimeZone(name));
+        zone->parse(data, size);
+        return zone;
+    }
+
+    const std::string& GetName() const { return name_; }
+
+    // UTC 时刻 -> 本地时间相对 UTC 的偏移（秒），东八区为 +28800
+    int GetUTCOffset(time_t utc) const {
+        const int64_t t = static_cast<int64_t>(utc);
+        if (has_rule_ && t >= horizon_) {
+            return rule_offset(t);
+        }
+        return offsets_[upper_index(t)];
+    }
+
+    // 与 GetUTCOffset 相同，同时给出该偏移保持不变的 UTC 区间 [run_begin, run_end)，
+    // 批量换算时同一区间内的时间戳不必再查表
+    int GetUTCOffsetRun(time_t utc, int64_t& run_begin, int64_t& run_end) const {
+        const int64_t t = static_cast<int64_t>(utc);
+        if (has_rule_ && t >= horizon_) {
+            return rule_offset_run(t, run_begin, run_end);
+        }
+        const size_t index = upper_index(t);
+        run_begin = index == 0 ? INT64_MIN : transitions_[index - 1];
+        run_end = index < transitions_.size() ? transitions_[index] : INT64_MAX;
+        return offsets_[index];
+    }
+
+    bool IsDaylightSavingTime(time_t utc) const {
+        const int64_t t = static_cast<int64_t>(utc);
+        if (has_rule_ && t >= horizon_) {
+            return rule_offset(t) != rule_.std_offset;
+        }
+        return is_dst_[upper_index(t)] != 0;
+    }
+
+    size_t GetTransitionCount() const { return transitions_.size(); }
+
+private:
+    struct TransitionRule {
+        // 日期规则: kind 'M' (Mm.w.d), 'J' (Jn, 不计闰日), 'N' (n, 计闰日, 0 起)
+        char kind = 'M';
+        int month = 0;
+        int week = 0;
+        int weekday = 0;
+        int day = 0;
+        int time = 7200; // 本地时间的秒数，v3 允许负值或超过 24h
+    };
+
+    struct PosixRule {
+        int std_offset = 0;
+        int dst_offset = 0;
+        bool has_dst = false;
+        TransitionRule start;
+        TransitionRule end;
+    };
+
+    explicit CDMTimeZone(const std::string& name) : name_(name) {}
+
+    static std::mutex& registry_mutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    static std::map<std::string, std::unique_ptr<CDMTimeZone>>& zone_registry() {
+        static std::map<std::string, std::unique_ptr<CDMTimeZone>> registry;
+        return registry;
+    }
+
+    static std::string resolve_path(const std::string& name) {
+        if (name.empty() || name.find("..") != std::string::npos) {
+            throw std::runtime_error("Invalid time zone name: '" + name + "'");
+        }
+        if (name[0] == '/') {
+            return name;
+        }
+        const char* tzdir = std::getenv("TZDIR");
+        std::string dir = (tzdir != nullptr && *tzdir != '\0') ? tzdir : "/usr/share/zoneinfo";
+        return dir + "/" + name;
+    }
+
+    void load_file(const std::string& path) {
+#ifdef _WIN32
+        FILE* fp = nullptr;
+        if (fopen_s(&fp, path.c_str(), "rb") != 0 || fp == nullptr) {
+            throw std::runtime_error("Failed to open time zone file: '" + path + "'");
+        }
+        std::vector<unsigned char> data;
+        unsigned char chunk[4096];
+        size_t n = 0;
+        while ((n = fread(chunk, 1, sizeof(chunk), fp)) > 0) {
+            data.insert(data.end(), chunk, chunk + n);
+        }
+        fclose(fp);
+        parse(data.data(), data.size());
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Failed to open time zone file: '" + path + "'");
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+            ::close(fd);
+            throw std::runtime_error("Failed to stat time zone file: '" + path + "'");
+        }
+        const size_t size = static_cast<size_t>(st.st_size);
+        void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapped == MAP_FAILED) {
+            throw std::runtime_error("Failed to mmap time zone file: '" + path + "'");
+        }
+        try {
+            parse(static_cast<const unsigned char*>(mapped), size);
+        }
+        catch (...) {
+            ::munmap(mapped, size);
+            throw;
+        }
+        ::munmap(mapped, size);
+#endif
+    }
+
+    static int64_t read_be(const unsigned char* p, int bytes) {
+        uint64_t v = 0;
+        for (int i = 0; i < bytes; ++i) {
+            v = (v << 8) | p[i];
+        }
+        if (bytes < 8 && (v >> (bytes * 8 - 1)) != 0) {
+            v |= ~0ULL << (bytes * 8); // 符号扩展
+        }
+        return static_cast<int64_t>(v);
+    }
+
+    void parse(const unsigned char* data, size_t size) {
+        struct Header {
+            int64_t isutcnt, isstdcnt, leapcnt, timecnt, typecnt, charcnt;
+        };
+        auto read_header = [&](size_t pos, Header& h) -> int {
+            if (pos + 44 > size || data[pos] != 'T' || data[pos + 1] != 'Z' || data[pos + 2] != 'i' || data[pos + 3] != 'f') {
+                throw std::runtime_error("Invalid TZif data for time zone '" + name_ + "'");
+            }
+            const int version = data[pos + 4] == 0 ? 1 : data[pos + 4] - '0';
+            h.isutcnt = read_be(data + pos + 20, 4);
+            h.isstdcnt = read_be(data + pos + 24, 4);
+            h.leapcnt = read_be(data + pos + 28, 4);
+            h.timecnt = read_be(data + pos + 32, 4);
+            h.typecnt = read_be(data + pos + 36, 4);
+            h.charcnt = read_be(data + pos + 40, 4);
+            if (h.typecnt <= 0 || h.timecnt < 0 || h.charcnt < 0 || h.leapcnt < 0 || h.isutcnt < 0 || h.isstdcnt < 0) {
+                throw std::runtime_error("Corrupt TZif header for time zone '" + name_ + "'");
+            }
+            return version;
+        };
+        auto block_size = [](const Header& h, int time_bytes) -> size_t {
+            return static_cast<size_t>(h.timecnt * time_bytes + h.timecnt + h.typecnt * 6 + h.charcnt
+                + h.leapcnt * (time_bytes + 4) + h.isstdcnt + h.isutcnt);
+        };
+
+        Header h{};
+        const int version = read_header(0, h);
+        size_t pos = 44;
+        int time_bytes = 4;
+        if (version >= 2) {
+            pos += block_size(h, 4);
+            read_header(pos, h);
+            pos += 44;
+            time_bytes = 8;
+        }
+        if (pos + block_size(h, time_bytes) > size) {
+            throw std::runtime_error("Truncated TZif data for time zone '" + name_ + "'");
+        }
+
+        const unsigned char* times = data + pos;
+        const unsigned char* indices = times + h.timecnt * time_bytes;
+        const unsigned char* types = indices + h.timecnt;
+
+        std::vector<int32_t> type_offsets(static_cast<size_t>(h.typecnt));
+        std::vector<uint8_t> type_dst(static_cast<size_t>(h.typecnt));
+        for (int64_t i = 0; i < h.typecnt; ++i) {
+            type_offsets[i] = static_cast<int32_t>(read_be(types + i * 6, 4));
+            type_dst[i] = types[i * 6 + 4];
+        }
+
+        transitions_.clear();
+        offsets_.clear();
+        is_dst_.clear();
+        offsets_.push_back(type_offsets[0]);
+        is_dst_.push_back(type_dst[0]);
+        for (int64_t i = 0; i < h.timecnt; ++i) {
+            const int64_t at = read_be(times + i * time_bytes, time_bytes);
+            const uint8_t type = indices[i];
+            if (type >= h.typecnt) {
+                throw std::runtime_error("Corrupt TZif transition for time zone '" + name_ + "'");
+            }
+            if (!transitions_.empty() && at <= transitions_.back()) {
+                continue;
+            }
+            transitions_.push_back(at);
+            offsets_.push_back(type_offsets[type]);
+            is_dst_.push_back(type_dst[type]);
+        }
+
+        has_rule_ = false;
+        if (version >= 2) {
+            const size_t footer = pos + block_size(h, time_bytes);
+            if (footer < size && data[footer] == '\n') {
+                size_t end = footer + 1;
+                while (end < size && data[end] != '\n') {
+                    ++end;
+                }
+                const std::string tz(reinterpret_cast<const char*>(data + footer + 1), end - footer - 1);
+                if (!tz.empty()) {
+                    has_rule_ = parse_posix_rule(tz, rule_);
+                }
+            }
+        }
+        expand_rule();
+    }
+
+    // 把 POSIX 规则在最后一次显式切换之后、TRANSITION_HORIZON_YEAR 之前的切换展开进有序数组
+    void expand_rule() {
+        if (has_rule_ && rule_.has_dst) {
+            const int64_t last = transitions_.empty() ? INT64_MIN : transitions_.back();
+            const int first_year = transitions_.empty() ? 1970
+                : CDMCivil::CivilFromDays(CDMCivil::FloorDiv(last, CDMCivil::SECONDS_PER_DAY)).year;
+            for (int year = first_year; year <= TRANSITION_HORIZON_YEAR; ++year) {
+                int64_t dst_begin = 0;
+                int64_t dst_end = 0;
+                rule_transitions(year, dst_begin, dst_end);
+                const int64_t first = dst_begin < dst_end ? dst_begin : dst_end;
+                const int64_t second = dst_begin < dst_end ? dst_end : dst_begin;
+                const int first_offset = dst_begin < dst_end ? rule_.dst_offset : rule_.std_offset;
+                const int second_offset = dst_begin < dst_end ? rule_.std_offset : rule_.dst_offset;
+                if (first > last) {
+                    append_transition(first, first_offset, first_offset != rule_.std_offset);
+                }
+                if (second > last) {
+                    append_transition(second, second_offset, second_offset != rule_.std_offset);
+                }
+            }
+        }
+        horizon_ = transitions_.empty() ? INT64_MIN : transitions_.back();
+    }
+
+    void append_transition(int64_t at, int offset, bool dst) {
+        if (!transitions_.empty() && at <= transitions_.back()) {
+            return;
+        }
+        if (offsets_.back() == offset) {
+            return;
+        }
+        transitions_.push_back(at);
+        offsets_.push_back(offset);
+        is_dst_.push_back(dst ? 1 : 0);
+    }
+
+    // 无分支二分：返回 <= t 的切换个数，即 offsets_ 的下标
+    size_t upper_index(int64_t t) const {
+        const int64_t* base = transitions_.data();
+        size_t n = transitions_.size();
+        if (n == 0 || t < base[0]) {
+            return 0;
+        }
+        while (n > 1) {
+            const size_t half = n / 2;
+            base = (base[half] <= t) ? base + half : base;
+            n -= half;
+        }
+        return static_cast<size_t>(base - transitions_.data()) + 1;
+    }
+
+    // 某年夏令时开始/结束对应的 UTC 时刻
+    void rule_transitions(int year, int64_t& dst_begin, int64_t& dst_end) const {
+        dst_begin = rule_date_days(rule_.start, year) * CDMCivil::SECONDS_PER_DAY + rule_.start.time - rule_.std_offset;
+        dst_end = rule_date_days(rule_.end, year) * CDMCivil::SECONDS_PER_DAY + rule_.end.time - rule_.dst_offset;
+    }
+
+    int rule_offset(int64_t t) const {
+        if (!rule_.has_dst) {
+            return rule_.std_offset;
+        }
+        const int year = CDMCivil::CivilFromDays(CDMCivil::FloorDiv(t + rule_.std_offset, CDMCivil::SECONDS_PER_DAY)).year;
+        int64_t dst_begin = 0;
+        int64_t dst_end = 0;
+        rule_transitions(year, dst_begin, dst_end);
+        const bool in_dst = (dst_begin < dst_end) ? (t >= dst_begin && t < dst_end) : !(t >= dst_end && t < dst_begin);
+        return in_dst ? rule_.dst_offset : rule_.std_offset;
+    }
+
+    // 规则区间内的偏移及其不变区间：取前后各一年的切换时刻夹住 t
+    int rule_offset_run(int64_t t, int64_t& run_begin, int64_t& run_end) const {
+        run_begin = horizon_;
+        run_end = INT64_MAX;
+        if (!rule_.has_dst) {
+            return rule_.std_offset;
+        }
+        const int year = CDMCivil::CivilFromDays(CDMCivil::FloorDiv(t + rule_.std_offset, CDMCivil::SECONDS_PER_DAY)).year;
+        for (int y = year - 1; y <= year + 1; ++y) {
+            int64_t edges[2] = { 0, 0 };
+            rule_transitions(y, edges[0], edges[1]);
+            for (int64_t edge : edges) {
+                if (edge <= t && edge > run_begin) {
+                    run_begin = edge;
+                }
+                if (edge > t && edge < run_end) {
+                    run_end = edge;
+                }
+            }
+        }
+        return rule_offset(t);
+    }
+
+    static long long rule_date_days(const TransitionRule& r, int year) {
+        if (r.kind == 'J') {
+            // 1-365，不计 2 月 29 日
+            long long days = CDMCivil::DaysFromCivil(year, 1, 1) + r.day - 1;
+            if (CDMCivil::IsLeapYear(year) && r.day >= 60) {
+                ++days;
+            }
+            return days;
+        }
+        if (r.kind == 'N') {
+            return CDMCivil::DaysFromCivil(year, 1, 1) + r.day;
+        }
+        const long long first = CDMCivil::DaysFromCivil(year, r.month, 1);
+        const int first_wday = CDMCivil::WeekdayFromDays(first);
+        long long day = first + (r.weekday - first_wday + 7) % 7 + (r.week - 1) * 7LL;
+        const long long month_end = first + CDMCivil::DaysInMonth(year, r.month);
+        while (day >= month_end) {
+            day -= 7; // week == 5 表示最后一个
+        }
+        return day;
+    }
+
+    static bool parse_posix_rule(const std::string& tz, PosixRule& rule) {
+        const char* p = tz.c_str();
+        if (!skip_name(p)) {
+            return false;
+        }
+        int std_posix = 0;
+        if (!parse_hms(p, std_posix)) {
+            return false;
+        }
+        rule.std_offset = -std_posix;
+        rule.has_dst = false;
+        if (*p == '\0') {
+            return true;
+        }
+        if (!skip_name(p)) {
+            return false;
+        }
+        rule.has_dst = true;
+        rule.dst_offset = rule.std_offset + 3600;
+        if (*p != ',' && *p != '\0') {
+            int dst_posix = 0;
+            if (!parse_hms(p, dst_posix)) {
+                return false;
+            }
+            rule.dst_offset = -dst_posix;
+        }
+        if (*p != ',') {
+            // 缺省规则（美国旧规则）在 TZif 尾部极少出现，按 M3.2.0,M11.1.0 处理
+            rule.start = TransitionRule{ 'M', 3, 2, 0, 0, 7200 };
+            rule.end = TransitionRule{ 'M', 11, 1, 0, 0, 7200 };
+            return *p == '\0';
+        }
+        ++p;
+        if (!parse_date_rule(p, rule.start) || *p != ',') {
+            return false;
+        }
+        ++p;
+        return parse_date_rule(p, rule.end) && *p == '\0';
+    }
+
+    static bool skip_name(const char*& p) {
+        if (*p == '<') {
+            while (*p != '\0' && *p != '>') {
+                ++p;
+            }
+            if (*p != '>') {
+                return false;
+            }
+            ++p;
+            return true;
+        }
+        const char* begin = p;
+        while ((*p >= 'A' && *p <= 'Z') || (*p >= 'a' && *p <= 'z')) {
+            ++p;
+        }
+        return p - begin >= 3;
+    }
+
+    static bool parse_int(const char*& p, int& value) {
+        if (*p < '0' || *p > '9') {
+            return false;
+        }
+        value = 0;
+        while (*p >= '0' && *p <= '9') {
+            value = value * 10 + (*p - '0');
+            ++p;
+        }
+        return true;
+    }
+
+    // [+-]hh[:mm[:ss]]
+    static bool parse_hms(const char*& p, int& seconds) {
+        int sign = 1;
+        if (*p == '+' || *p == '-') {
+            sign = (*p == '-') ? -1 : 1;
+            ++p;
+        }
+        int hh = 0, mm = 0, ss = 0;
+        if (!parse_int(p, hh)) {
+            return false;
+        }
+        if (*p == ':') {
+            ++p;
+            if (!parse_int(p, mm)) {
+                return false;
+            }
+            if (*p == ':') {
+                ++p;
+                if (!parse_int(p, ss)) {
+                    return false;
+                }
+            }
+        }
+        seconds = sign * (hh * 3600 + mm * 60 + ss);
+        return true;
+    }
+
+    static bool parse_date_rule(const char*& p, TransitionRule& r) {
+        r = TransitionRule{};
+        if (*p == 'M') {
+            ++p;
+            r.kind = 'M';
+            if (!parse_int(p, r.month) || *p++ != '.' || !parse_int(p, r.week) || *p++ != '.' || !parse_int(p, r.weekday)) {
+                return false;
+            }
+            if (r.month < 1 || r.month > 12 || r.week < 1 || r.week > 5 || r.weekday > 6) {
+                return false;
+            }
+        }
+        else if (*p == 'J') {
+            ++p;
+            r.kind = 'J';
+            if (!parse_int(p, r.day) || r.day < 1 || r.day > 365) {
+                return false;
+            }
+        }
+        else {
+            r.kind = 'N';
+            if (!parse_int(p, r.day) || r.day > 365) {
+                return false;
+            }
+        }
+        if (*p == '/') {
+            ++p;
+            return parse_hms(p, r.time);
+        }
+        return true;
+    }
+
+    std::string name_;
+    std::vector<int64_t> transitions_; // 升序的 UTC 切换时刻
+    std::vector<int32_t> offsets_;     // offsets_[i] 为第 i 次切换之前（i==0）/之后的偏移，长度 = transitions_ + 1
+    std::vector<uint8_t> is_dst_;
+    PosixRule rule_;
+    bool has_rule_ = false;
+    int64_t horizon_ = INT64_MIN;      // 最后一次（含展开的）切换时刻，之后按 POSIX 规则计算
+};
+
+#endif // __DMTIMEZONE_H__
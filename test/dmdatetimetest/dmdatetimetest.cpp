@@ -1,7 +1,20 @@
 ﻿#include "dmdatetime.h"
+#include "dmprecisetime.h"
+#include "dmbusinesscalendar.h"
+#include "dmtimerwheel.h"
+#include "dmcron.h"
+#include "dmrrule.h"
+#include "dminterval.h"
+#include "dmhistogram.h"
+#include "dmtimestampcolumn.h"
+#include "dmtimeseriesfile.h"
+#include "dmlogscanner.h"
+#include "dmdatetimeformat.h"
 #include <string>
 #include <vector>
 #include <numeric>
+#include <atomic>
+#include <thread>
 #include "gtest.h"
 #include "dmformat.h"
 #include "dmfix_win_utf8.h"
@@ -259,7 +272,8 @@ TEST_F(CDMDateTimeUsageTest, RangeChecking) {
 TEST_F(CDMDateTimeUsageTest, LunarSupport) {
     std::string lunar_str = dt_ref.ToLunarString();
     EXPECT_FALSE(lunar_str.empty());
-    EXPECT_EQ("农历支持未实现 (Lunar support not implemented)", lunar_str);
+    EXPECT_EQ("甲辰年冬月廿五", lunar_str);
+    EXPECT_EQ("2024-11-25", dt_ref.ToLunarNumericString());
 }
 
 TEST_F(CDMDateTimeUsageTest, FormatConstants) {
@@ -453,4 +467,1619 @@ TEST_F(CDMDateTimePracticalTest, NextMonthOn)
     fmt::print("{}\n", next.ToString());
     fmt::print("{}\n", next.ToUTCString());
     fmt::print("{}\n", next.ToISOString());
-}
\ No newline at end of file
+}
+
+TEST_F(CDMDateTimePracticalTest, CivilEngineMatchesLibc)
+{
+    static_assert(CDMCivil::DaysFromCivil(2024, 12, 25) == 20082, "constexpr days_from_civil");
+    static_assert(CDMCivil::CivilFromDays(20082).day == 25, "constexpr civil_from_days");
+
+    // 覆盖 1970-2100 年，步长不与整天对齐，能落到各个夏令时切换附近
+    for (time_t ts = 0; ts < 4102444800LL; ts += 86400 * 7 + 3601) {
+        std::tm expected{};
+#ifdef _WIN32
+        localtime_s(&expected, &ts);
+#else
+        localtime_r(&ts, &expected);
+#endif
+        CDMDateTime dt = CDMDateTime::FromTimestamp(ts);
+        ASSERT_EQ(expected.tm_year + 1900, dt.GetYear()) << ts;
+        ASSERT_EQ(expected.tm_mon + 1, dt.GetMonth()) << ts;
+        ASSERT_EQ(expected.tm_mday, dt.GetDay()) << ts;
+        ASSERT_EQ(expected.tm_hour, dt.GetHour()) << ts;
+        ASSERT_EQ(expected.tm_min, dt.GetMinute()) << ts;
+        ASSERT_EQ(expected.tm_sec, dt.GetSecond()) << ts;
+        ASSERT_EQ(expected.tm_wday, dt.GetDayOfWeek()) << ts;
+        ASSERT_EQ(expected.tm_yday + 1, dt.GetDayOfYear()) << ts;
+
+        // 夏令时回拨时本地时间有歧义，只要求本地字段能够往返
+        CDMDateTime roundtrip(dt.GetYear(), dt.GetMonth(), dt.GetDay(), dt.GetHour(), dt.GetMinute(), dt.GetSecond());
+        ASSERT_EQ(dt.ToString(), roundtrip.ToString()) << ts;
+    }
+}
+
+TEST_F(CDMDateTimePracticalTest, CivilEngineNormalization)
+{
+    CDMDateTime overflow_month(2024, 13, 1, 0, 0, 0);
+    EXPECT_EQ("2025-01-01 00:00:00", overflow_month.ToString());
+
+    CDMDateTime overflow_day(2024, 2, 30, 25, 0, 0);
+    EXPECT_EQ("2024-03-02 01:00:00", overflow_day.ToString());
+
+    CDMDateTime jan31(2024, 1, 31, 8, 0, 0);
+    EXPECT_EQ("2024-03-02 08:00:00", jan31.AddMonths(1).ToString());
+    EXPECT_EQ("2023-12-31 08:00:00", jan31.AddMonths(-1).ToString());
+    EXPECT_EQ("2025-01-31 08:00:00", jan31.AddMonths(12).ToString());
+
+    CDMDateTime leap_day(2024, 2, 29, 8, 0, 0);
+    EXPECT_EQ("2025-03-01 08:00:00", leap_day.AddYears(1).ToString());
+    EXPECT_EQ("2028-02-29 08:00:00", leap_day.AddYears(4).ToString());
+}
+
+TEST_F(CDMDateTimePracticalTest, ISOStringOffset)
+{
+    CDMDateTime dt(2024, 7, 1, 12, 0, 0);
+    std::string iso = dt.ToISOString();
+    ASSERT_EQ(25u, iso.size());
+    EXPECT_EQ("2024-07-01T12:00:00", iso.substr(0, 19));
+
+    std::tm local_tm{};
+    time_t ts = dt.GetTimestamp();
+#ifdef _WIN32
+    localtime_s(&local_tm, &ts);
+#else
+    localtime_r(&ts, &local_tm);
+#endif
+    int offset = static_cast<int>(timegm_custom(&local_tm) - ts);
+    char expected[8];
+    snprintf(expected, sizeof(expected), "%c%02d:%02d", offset < 0 ? '-' : '+',
+        std::abs(offset) / 3600, std::abs(offset) % 3600 / 60);
+    EXPECT_EQ(expected, iso.substr(19));
+}
+
+TEST_F(CDMDateTimePracticalTest, FieldCacheInvalidation)
+{
+    CDMDateTime dt(2024, 12, 25, 15, 30, 45);
+    EXPECT_EQ(2024, dt.GetYear()); // 填充缓存
+    EXPECT_EQ(360, dt.GetDayOfYear());
+
+    dt.SetDateTime(2023, 1, 2, 3, 4, 5);
+    EXPECT_EQ(2023, dt.GetYear());
+    EXPECT_EQ(1, dt.GetMonth());
+    EXPECT_EQ(2, dt.GetDay());
+    EXPECT_EQ(3, dt.GetHour());
+    EXPECT_EQ(4, dt.GetMinute());
+    EXPECT_EQ(5, dt.GetSecond());
+    EXPECT_EQ(1, dt.GetDayOfWeek());
+    EXPECT_EQ(2, dt.GetDayOfYear());
+
+    CDMDateTime copy = dt;
+    copy.SetTime(23, 59, 59);
+    EXPECT_EQ(3, dt.GetHour());
+    EXPECT_EQ(23, copy.GetHour());
+
+    dt = copy.AddSeconds(1);
+    EXPECT_EQ("2023-01-03 00:00:00", dt.ToString());
+    EXPECT_EQ(3, dt.GetDay());
+}
+
+#ifndef _WIN32
+TEST_F(CDMDateTimePracticalTest, TimeZoneMatchesLibc)
+{
+    const char* zones[] = { "Asia/Shanghai", "America/New_York", "Europe/London",
+        "Australia/Sydney", "Australia/Lord_Howe", "Asia/Kolkata", "America/Sao_Paulo" };
+
+    std::string saved_tz = getenv("TZ") ? getenv("TZ") : "";
+    bool had_tz = getenv("TZ") != nullptr;
+
+    for (const char* name : zones) {
+        const CDMTimeZone* zone = nullptr;
+        try {
+            zone = CDMTimeZone::Get(name);
+        }
+        catch (const std::exception&) {
+            continue; // 没有 zoneinfo 数据库的环境
+        }
+        ASSERT_EQ(zone, CDMTimeZone::Get(name));
+        EXPECT_GT(zone->GetTransitionCount(), 0u);
+
+        setenv("TZ", name, 1);
+        tzset();
+        // 1900-2200，覆盖显式切换表、预展开区间以及按 POSIX 规则现算的区间
+        for (long long ts = -2208988800LL; ts < 7258118400LL; ts += 86400 * 3 + 1799) {
+            time_t t = static_cast<time_t>(ts);
+            std::tm local_tm{};
+            localtime_r(&t, &local_tm);
+            ASSERT_EQ(static_cast<int>(local_tm.tm_gmtoff), zone->GetUTCOffset(t)) << name << " " << ts;
+            ASSERT_EQ(local_tm.tm_isdst > 0, zone->IsDaylightSavingTime(t)) << name << " " << ts;
+        }
+    }
+
+    if (had_tz) {
+        setenv("TZ", saved_tz.c_str(), 1);
+    }
+    else {
+        unsetenv("TZ");
+    }
+    tzset();
+    CDMDateTime::SetLocalTimeZone(nullptr);
+}
+
+TEST_F(CDMDateTimePracticalTest, DateTimeWithTimeZone)
+{
+    const CDMTimeZone* shanghai = nullptr;
+    const CDMTimeZone* new_york = nullptr;
+    try {
+        shanghai = CDMTimeZone::Get("Asia/Shanghai");
+        new_york = CDMTimeZone::Get("America/New_York");
+    }
+    catch (const std::exception&) {
+        return;
+    }
+
+    CDMDateTime dt = CDMDateTime::FromTimestamp(1703512245L); // 2023-12-25 13:50:45 UTC
+    CDMDateTime::SetLocalTimeZone(shanghai);
+    EXPECT_EQ(shanghai, CDMDateTime::GetLocalTimeZone());
+    EXPECT_EQ("2023-12-25 21:50:45", dt.ToString());
+    EXPECT_EQ("2023-12-25T21:50:45+08:00", dt.ToISOString());
+    EXPECT_EQ(1703512245L, CDMDateTime(2023, 12, 25, 21, 50, 45).GetTimestamp());
+
+    // 已填充的字段缓存在切换时区后失效
+    CDMDateTime::SetLocalTimeZone(new_york);
+    EXPECT_EQ(8, dt.GetHour());
+    EXPECT_EQ("2023-12-25T08:50:45-05:00", dt.ToISOString());
+    EXPECT_EQ("2024-07-04T12:00:00-04:00", CDMDateTime(2024, 7, 4, 12, 0, 0).ToISOString());
+    EXPECT_EQ("2024-03-10 03:30:00", CDMDateTime(2024, 3, 10, 2, 30, 0).ToString()); // 夏令时空洞顺延
+
+    CDMDateTime::SetLocalTimeZone(nullptr);
+    EXPECT_EQ(nullptr, CDMDateTime::GetLocalTimeZone());
+
+    EXPECT_THROW(CDMTimeZone::Get("../etc/passwd"), std::runtime_error);
+    EXPECT_THROW(CDMTimeZone::Get("No/Such_Zone"), std::runtime_error);
+}
+#endif
+
+TEST_F(CDMDateTimePracticalTest, FastParser)
+{
+    CDMDateTime dt;
+    ASSERT_TRUE(CDMDateTime::TryParse(std::string_view("2024-12-25 15:30:45"), dt));
+    EXPECT_EQ(CDMDateTime(2024, 12, 25, 15, 30, 45), dt);
+
+    ASSERT_TRUE(CDMDateTime::TryParse(std::string_view("2024-1-5 3:04:05"), dt));
+    EXPECT_EQ(CDMDateTime(2024, 1, 5, 3, 4, 5), dt);
+
+    ASSERT_TRUE(CDMDateTime::TryParse(std::string_view("2024-12-25"), dt));
+    EXPECT_EQ(CDMDateTime(2024, 12, 25), dt);
+
+    ASSERT_TRUE(CDMDateTime::TryParse(std::string_view("2024-12-25T15:30:45"), dt));
+    EXPECT_EQ(CDMDateTime(2024, 12, 25, 15, 30, 45), dt);
+
+    // 带时区后缀时与本地时区无关
+    const char* utc_forms[] = {
+        "2023-12-25T13:50:45Z", "2023-12-25T13:50:45.250Z", "2023-12-25T21:50:45+08:00",
+        "2023-12-25T21:50:45+0800", "2023-12-25T21:50:45+08", "2023-12-25T08:20:45-05:30",
+    };
+    for (const char* s : utc_forms) {
+        ASSERT_TRUE(CDMDateTime::TryParse(s, strlen(s), dt)) << s;
+        EXPECT_EQ(1703512245L, dt.GetTimestamp()) << s;
+    }
+    EXPECT_EQ(1703512245L, CDMDateTime::Parse("2023-12-25T13:50:45Z", 20).GetTimestamp());
+
+    const char* invalid[] = {
+        "", "2024", "2024-13-01", "2024-02-30", "2023-02-29", "2024-12-25 24:00:00",
+        "2024-12-25 12:60:00", "2024-12-25 12:00:60", "2024-12-25X12:00:00", "2024-12-25 12:00",
+        "2024-12-25T12:00:00+8", "2024-12-25T12:00:00+08:", "2024-12-25T12:00:00.", "2024-12-25 12:00:00 ",
+        "24-12-25",
+    };
+    for (const char* s : invalid) {
+        EXPECT_FALSE(CDMDateTime::TryParse(s, strlen(s), dt)) << s;
+    }
+    EXPECT_THROW(CDMDateTime::Parse("2024-13-01", 10), std::runtime_error);
+
+    // Parse 的默认格式走快速路径，严格校验失败时仍由 sscanf 归一化兜底
+    EXPECT_EQ(CDMDateTime(2024, 12, 25, 15, 30, 45), CDMDateTime::Parse("2024-12-25T15:30:45"));
+    EXPECT_EQ(CDMDateTime(2025, 1, 1), CDMDateTime::Parse("2024-13-01"));
+    EXPECT_EQ(CDMDateTime(2024, 12, 25), CDMDateTime::Parse("2024-12-25 15:30:45", CDMDateTime::FORMAT_SHORT_DATE));
+    EXPECT_THROW(CDMDateTime::Parse("garbage"), std::runtime_error);
+}
+
+TEST_F(CDMDateTimePracticalTest, BatchParser)
+{
+    std::vector<std::string> rows;
+    for (int i = 0; i < 37; ++i) {
+        CDMDateTime dt = CDMDateTime(2024, 1, 1, 0, 0, 0).AddSeconds(i * 86400LL * 11 + i * 3671);
+        rows.push_back(dt.ToString());
+    }
+    rows[5][10] = 'T';
+    rows[7][6] = 'x';   // 非数字
+    rows[11][5] = '1';  // 月份 13
+    rows[12][5] = '1';
+    rows[12][6] = '3';
+    rows[20][13] = '-'; // 分隔符错误
+    rows[21][17] = '6'; // 秒 6x
+
+    std::vector<const char*> ptrs;
+    for (const std::string& row : rows) {
+        ptrs.push_back(row.c_str());
+    }
+    std::vector<time_t> out(rows.size());
+    bool valid[64] = { false };
+    size_t parsed = CDMDateTime::ParseBatch(ptrs.data(), ptrs.size(), 19, out.data(), valid);
+
+    size_t expected_parsed = 0;
+    for (size_t i = 0; i < rows.size(); ++i) {
+        CDMDateTime expected;
+        bool ok = CDMDateTime::TryParse(std::string_view(rows[i]), expected);
+        ASSERT_EQ(ok, valid[i]) << rows[i];
+        if (ok) {
+            EXPECT_EQ(expected.GetTimestamp(), out[i]) << rows[i];
+            ++expected_parsed;
+        }
+        else {
+            EXPECT_EQ(0, out[i]);
+        }
+    }
+    EXPECT_EQ(expected_parsed, parsed);
+    EXPECT_EQ(rows.size() - 5, parsed);
+
+    // 每个内核单独校验，保证标量回退与向量版本行为一致
+    for (const std::string& row : rows) {
+        DMDateTimeFields scalar{};
+        bool scalar_ok = CDMDateTimeSimd::ParseFixedScalar(row.c_str(), scalar);
+#ifdef DMDATETIME_SIMD_X86
+        if (CDMDateTimeSimd::DetectLevel() >= CDMDateTimeSimd::SIMD_LEVEL_SSE41) {
+            DMDateTimeFields sse{};
+            ASSERT_EQ(scalar_ok, CDMDateTimeSimd::ParseFixedSSE41(row.c_str(), sse)) << row;
+            if (scalar_ok) {
+                EXPECT_EQ(0, memcmp(&scalar, &sse, sizeof(scalar))) << row;
+            }
+        }
+        if (CDMDateTimeSimd::DetectLevel() >= CDMDateTimeSimd::SIMD_LEVEL_AVX2) {
+            DMDateTimeFields a{}, b{};
+            bool ok_a = false, ok_b = false;
+            CDMDateTimeSimd::ParseFixedAVX2x2(row.c_str(), rows[0].c_str(), a, b, ok_a, ok_b);
+            ASSERT_EQ(scalar_ok, ok_a) << row;
+            EXPECT_TRUE(ok_b);
+            if (scalar_ok) {
+                EXPECT_EQ(0, memcmp(&scalar, &a, sizeof(scalar))) << row;
+            }
+        }
+#endif
+    }
+
+    // 连续定宽列，带 'Z' 后缀和换行分隔
+    std::string column = "2023-12-25T13:50:45Z\n2023-12-25 13:50:46Z\n2023-12-25T13:50:4xZ\n";
+    time_t col_out[3] = { 0 };
+    bool col_valid[3] = { false };
+    EXPECT_EQ(2u, CDMDateTime::ParseColumn(column.data(), 21, 3, 20, col_out, col_valid));
+    EXPECT_EQ(1703512245L, col_out[0]);
+    EXPECT_EQ(1703512246L, col_out[1]);
+    EXPECT_FALSE(col_valid[2]);
+
+    EXPECT_EQ(0u, CDMDateTime::ParseColumn(column.data(), 21, 3, 10, col_out));
+}
+
+TEST_F(CDMDateTimePracticalTest, FormatIntoBuffer)
+{
+    CDMDateTime dt(2024, 7, 5, 8, 9, 3);
+    char buf[64];
+    EXPECT_EQ(19u, dt.ToString(buf, sizeof(buf)));
+    EXPECT_STREQ("2024-07-05 08:09:03", buf);
+    EXPECT_EQ(dt.ToString(), std::string(buf));
+
+    EXPECT_EQ(10u, dt.ToString(buf, sizeof(buf), CDMDateTime::TO_STRING_SHORT_DATE));
+    EXPECT_STREQ("2024-07-05", buf);
+
+    size_t n = dt.ToString(buf, sizeof(buf), CDMDateTime::TO_STRING_STANDARD_CN);
+    EXPECT_EQ(dt.ToString(CDMDateTime::TO_STRING_STANDARD_CN), std::string(buf, n));
+
+    EXPECT_EQ(20u, dt.ToUTCString(buf, sizeof(buf)));
+    EXPECT_EQ(dt.ToUTCString(), std::string(buf));
+    EXPECT_EQ(25u, dt.ToISOString(buf, sizeof(buf)));
+    EXPECT_EQ(dt.ToISOString(), std::string(buf));
+
+    EXPECT_EQ("2023-12-25T13:50:45Z", CDMDateTime::FromTimestamp(1703512245L).ToUTCString());
+
+    // 容量不足：写空串并返回 0
+    EXPECT_EQ(0u, dt.ToString(buf, 19));
+    EXPECT_STREQ("", buf);
+    EXPECT_EQ(19u, dt.ToString(buf, 20));
+
+    std::string line = "[";
+    EXPECT_EQ(19u, dt.AppendString(line));
+    line += "] ";
+    EXPECT_EQ(25u, dt.AppendISOString(line));
+    EXPECT_EQ(20u, dt.AppendUTCString(line));
+    EXPECT_EQ("[" + dt.ToString() + "] " + dt.ToISOString() + dt.ToUTCString(), line);
+
+    // 与 snprintf 的结果逐秒对照
+    for (time_t ts = 0; ts < 4102444800LL; ts += 86400 * 29 + 3727) {
+        CDMDateTime x = CDMDateTime::FromTimestamp(ts);
+        char expected[64];
+        snprintf(expected, sizeof(expected), CDMDateTime::TO_STRING_STANDARD, x.GetYear(), x.GetMonth(), x.GetDay(),
+            x.GetHour(), x.GetMinute(), x.GetSecond());
+        ASSERT_EQ(std::string(expected), x.ToString());
+    }
+}
+
+TEST_F(CDMDateTimePracticalTest, FormattedSecondCache)
+{
+    // 逐秒递增跨越分钟、小时、日、年边界，与不经缓存的逐字段拼接结果对照
+    CDMDateTime start(2024, 12, 31, 23, 58, 30);
+    for (int i = 0; i < 200; ++i) {
+        CDMDateTime dt = start.AddSeconds(i);
+        char expected[64];
+        snprintf(expected, sizeof(expected), "%04d-%02d-%02d %02d:%02d:%02d", dt.GetYear(), dt.GetMonth(), dt.GetDay(),
+            dt.GetHour(), dt.GetMinute(), dt.GetSecond());
+        ASSERT_EQ(std::string(expected), dt.ToString()) << i;
+        ASSERT_EQ(std::string(expected), dt.ToString()) << i; // 同一秒命中缓存
+
+        std::string iso = dt.ToISOString();
+        expected[10] = 'T';
+        ASSERT_EQ(std::string(expected), iso.substr(0, 19)) << i;
+        ASSERT_EQ(dt.ToISOString(), iso) << i;
+
+        std::string utc = CDMDateTime::FromTimestamp(1703512245L + i).ToUTCString();
+        ASSERT_EQ(20u, utc.size());
+        ASSERT_EQ('0' + (45 + i) % 60 / 10, utc[17]) << i;
+        ASSERT_EQ('0' + (45 + i) % 10, utc[18]) << i;
+    }
+
+    // 不同格式互不干扰，时间倒退也能正确刷新
+    CDMDateTime later(2030, 1, 1, 0, 0, 1);
+    CDMDateTime earlier(2020, 1, 1, 0, 0, 2);
+    EXPECT_EQ("2030-01-01 00:00:01", later.ToString());
+    EXPECT_EQ("2030-01-01", later.ToString(CDMDateTime::TO_STRING_SHORT_DATE));
+    EXPECT_EQ("2020-01-01 00:00:02", earlier.ToString());
+    EXPECT_EQ("2030-01-01 00:00:01", later.ToString());
+}
+
+TEST_F(CDMDateTimePracticalTest, ExtractFieldsColumns)
+{
+    // 覆盖 1970 年前、闰年、跨年以及公元 0 年之前（走 64 位路径）的时间戳
+    std::vector<time_t> stamps;
+    for (long long t = -2208988800LL; t < 4102444800LL; t += 7777777) {
+        stamps.push_back(static_cast<time_t>(t));
+    }
+    stamps.push_back(CDMDateTime(2024, 2, 29, 23, 59, 59).GetTimestamp());
+    stamps.push_back(CDMDateTime(2024, 12, 31, 12, 0, 0).GetTimestamp());
+    stamps.push_back(CDMDateTime(2025, 1, 1, 0, 0, 0).GetTimestamp());
+    stamps.push_back(static_cast<time_t>(-63000000000LL));
+
+    auto check = [&](const std::vector<time_t>& input) {
+        const size_t n = input.size();
+        std::vector<int16_t> year(n);
+        std::vector<uint8_t> month(n), day(n), hour(n), minute(n), second(n), wday(n);
+        std::vector<uint16_t> yday(n);
+        DMDateTimeColumns out;
+        out.year = year.data();
+        out.month = month.data();
+        out.day = day.data();
+        out.hour = hour.data();
+        out.minute = minute.data();
+        out.second = second.data();
+        out.day_of_week = wday.data();
+        out.day_of_year = yday.data();
+        CDMDateTime::ExtractFields(input.data(), n, out);
+        for (size_t i = 0; i < n; ++i) {
+            CDMDateTime dt = CDMDateTime::FromTimestamp(input[i]);
+            ASSERT_EQ(dt.GetYear(), year[i]) << input[i];
+            ASSERT_EQ(dt.GetMonth(), month[i]) << input[i];
+            ASSERT_EQ(dt.GetDay(), day[i]) << input[i];
+            ASSERT_EQ(dt.GetHour(), hour[i]) << input[i];
+            ASSERT_EQ(dt.GetMinute(), minute[i]) << input[i];
+            ASSERT_EQ(dt.GetSecond(), second[i]) << input[i];
+            ASSERT_EQ(dt.GetDayOfWeek(), wday[i]) << input[i];
+            ASSERT_EQ(dt.GetDayOfYear(), yday[i]) << input[i];
+        }
+    };
+    check(stamps);
+
+    // 1600-2400 年逐日扫描，每天取不同的时分秒，覆盖向量化路径的全部分支
+    std::vector<time_t> daily;
+    for (long long day = CDMCivil::DaysFromCivil(1600, 1, 1); day < CDMCivil::DaysFromCivil(2400, 12, 31); ++day) {
+        daily.push_back(static_cast<time_t>(day * 86400 + (day * 7919) % 86400 + 43200));
+    }
+    check(daily);
+
+    // 只请求部分列
+    std::vector<int16_t> years(stamps.size(), 0);
+    DMDateTimeColumns only_year;
+    only_year.year = years.data();
+    CDMDateTime::ExtractFields(stamps.data(), stamps.size(), only_year);
+    EXPECT_EQ(CDMDateTime::FromTimestamp(stamps.back()).GetYear(), years.back());
+
+#ifndef _WIN32
+    // 时区表路径：按切换区间复用偏移，跨越夏令时切换仍与逐个换算一致
+    const CDMTimeZone* zone = nullptr;
+    try {
+        zone = CDMTimeZone::Get("America/New_York");
+    }
+    catch (const std::exception&) {
+        return;
+    }
+    const CDMTimeZone* previous = CDMDateTime::GetLocalTimeZone();
+    CDMDateTime::SetLocalTimeZone(zone);
+    std::vector<time_t> dst_stamps;
+    const time_t spring = 1710054000; // 2024-03-10 07:00:00 UTC，纽约切换到夏令时
+    for (long long t = spring - 7200; t < spring + 7200; t += 599) {
+        dst_stamps.push_back(static_cast<time_t>(t));
+    }
+    for (long long t = 4102444800LL; t < 4102444800LL + 400LL * 86400; t += 86399) {
+        dst_stamps.push_back(static_cast<time_t>(t)); // 2100 年之后走 POSIX 规则
+    }
+    check(dst_stamps);
+    check(stamps);
+    CDMDateTime::SetLocalTimeZone(previous);
+#endif
+}
+
+TEST_F(CDMDateTimePracticalTest, SubSecondPrecision)
+{
+    // 一个 64 位 tick 计数，整数运算
+    CDMDateTimeNs t = CDMDateTimeNs::FromTimestamp(1703512245, 123456789);
+    EXPECT_EQ(1703512245, t.GetTimestamp());
+    EXPECT_EQ(123, t.GetMillisecond());
+    EXPECT_EQ(123456, t.GetMicrosecond());
+    EXPECT_EQ(123456789, t.GetNanosecond());
+    EXPECT_EQ("2023-12-25T13:50:45.123456789Z", t.ToUTCString());
+
+    CDMDateTimeNs later = t.AddMilliseconds(900).AddMicroseconds(1).AddNanoseconds(1);
+    EXPECT_EQ("2023-12-25T13:50:46.023457790Z", later.ToUTCString());
+    EXPECT_EQ(900001001LL, (later - t).GetTicks());
+    EXPECT_EQ(900LL, (later - t).GetTotalMilliseconds());
+    EXPECT_EQ(0LL, (later - t).ToTimeSpan().GetTotalSeconds());
+    EXPECT_TRUE(t < later);
+    EXPECT_EQ(t, later - CDMTimeSpanNs::FromNanoseconds(900001001));
+
+    // 1970 年之前：秒向下取整，秒内部分仍为正
+    CDMDateTimeMs before_epoch = CDMDateTimeMs::FromTicks(-1);
+    EXPECT_EQ(-1, before_epoch.GetTimestamp());
+    EXPECT_EQ(999, before_epoch.GetMillisecond());
+    EXPECT_EQ("1969-12-31T23:59:59.999Z", before_epoch.ToUTCString());
+
+    // 本地时间与 ISO 输出带小数位，位数随分辨率变化
+    CDMDateTimeUs local(2024, 2, 29, 8, 5, 9, 42);
+    EXPECT_EQ("2024-02-29 08:05:09.000042", local.ToString());
+    EXPECT_EQ(local.ToDateTime().ToISOString().substr(0, 19) + ".000042" + local.ToDateTime().ToISOString().substr(19),
+        local.ToISOString());
+    char buffer[16];
+    EXPECT_EQ(0u, local.ToString(buffer, sizeof(buffer)));
+
+    // 解析小数秒：不足位补零，多余位截断
+    CDMDateTimeNs parsed;
+    ASSERT_TRUE(CDMDateTimeNs::TryParse("2023-12-25T13:50:45.5Z", parsed));
+    EXPECT_EQ(CDMDateTimeNs::FromTimestamp(1703512245, 500000000), parsed);
+    ASSERT_TRUE(CDMDateTimeNs::TryParse("2023-12-25T13:50:45.1234567891234+08:00", parsed));
+    EXPECT_EQ(CDMDateTimeNs::FromTimestamp(1703512245 - 8 * 3600, 123456789), parsed);
+    CDMDateTimeMs parsed_ms = CDMDateTimeMs::Parse("2023-12-25T13:50:45.987654Z");
+    EXPECT_EQ(1703512245987LL, parsed_ms.GetTicks());
+    EXPECT_EQ(parsed_ms, CDMDateTimeMs::Parse(parsed_ms.ToISOString()));
+    EXPECT_FALSE(CDMDateTimeNs::TryParse("2023-12-25T13:50:45.Z", parsed));
+    EXPECT_FALSE(CDMDateTimeNs::TryParse("2300-01-01T00:00:00Z", parsed)); // 超出纳秒精度的表示范围
+    EXPECT_THROW(CDMDateTimeUs::Parse("not a date"), std::runtime_error);
+
+    // 整秒的 CDMDateTime 仍然接受并忽略小数部分
+    EXPECT_EQ(1703512245, CDMDateTime::Parse("2023-12-25T13:50:45.999Z").GetTimestamp());
+
+    CDMDateTimeNs now = CDMDateTimeNs::Now();
+    EXPECT_LE(std::llabs(static_cast<long long>(now.GetTimestamp() - std::time(nullptr))), 1LL);
+}
+
+TEST_F(CDMDateTimePracticalTest, ClockSources)
+{
+    // 各时钟源都应与 CLOCK_REALTIME 相差不超过 COARSE 的节拍与整秒截断
+    for (int i = 0; i < CDMClock::CLOCK_SOURCE_COUNT; ++i) {
+        const CDMClock::ClockSource source = static_cast<CDMClock::ClockSource>(i);
+        const int64_t reference = CDMClock::NowNanoseconds(CDMClock::CLOCK_SOURCE_REALTIME);
+        const int64_t value = CDMClock::NowNanoseconds(source);
+        const int64_t tolerance = (source == CDMClock::CLOCK_SOURCE_SYSTEM) ? 1100000000LL : 50000000LL;
+        EXPECT_LE(std::llabs(static_cast<long long>(value - reference)), tolerance) << CDMClock::GetSourceName(source);
+        EXPECT_LE(std::llabs(static_cast<long long>(CDMDateTime::Now(source).GetTimestamp() - std::time(nullptr))), 1LL);
+    }
+
+    // TSC 时钟单调前进，且跨过对齐间隔后仍与 realtime 一致
+    int64_t previous = CDMClock::NowNanoseconds(CDMClock::CLOCK_SOURCE_TSC);
+    for (int i = 0; i < 100000; ++i) {
+        const int64_t now = CDMClock::NowNanoseconds(CDMClock::CLOCK_SOURCE_TSC);
+        EXPECT_GE(now + 1000000, previous); // 允许对齐时的微小回退
+        previous = now;
+    }
+    const int64_t tsc = CDMClock::NowNanoseconds(CDMClock::CLOCK_SOURCE_TSC);
+    EXPECT_LE(std::llabs(static_cast<long long>(tsc - CDMClock::NowNanoseconds(CDMClock::CLOCK_SOURCE_REALTIME))), 1000000LL);
+
+    // 默认时钟可切换，影响 Now() 与默认构造
+    CDMClock::SetDefaultSource(CDMClock::CLOCK_SOURCE_REALTIME_COARSE);
+    EXPECT_EQ(CDMClock::CLOCK_SOURCE_REALTIME_COARSE, CDMClock::GetDefaultSource());
+    EXPECT_LE(std::llabs(static_cast<long long>(CDMDateTime().GetTimestamp() - std::time(nullptr))), 1LL);
+    CDMClock::SetDefaultSource(CDMClock::CLOCK_SOURCE_SYSTEM);
+
+    CDMDateTimeUs precise = CDMDateTimeUs::Now(CDMClock::CLOCK_SOURCE_TSC);
+    EXPECT_LE(std::llabs(static_cast<long long>(precise.GetTimestamp() - std::time(nullptr))), 1LL);
+}
+
+TEST_F(CDMDateTimePracticalTest, LockFreeConversion)
+{
+    // 在相距数年的日期之间来回换算，先记录 libc 路径的结果
+    CDMDateTime::DisableLockFreeConversion();
+    std::vector<time_t> stamps;
+    std::vector<int> hours;
+    std::vector<time_t> day_starts;
+    for (int i = 0; i < 2000; ++i) {
+        const time_t t = 1600000000 + static_cast<time_t>((i * 7919) % 2000) * 86400 * 3 + i * 3607;
+        stamps.push_back(t);
+        hours.push_back(CDMDateTime::FromTimestamp(t).GetHour());
+        day_starts.push_back(CDMDateTime::FromTimestamp(t).GetStartOfDay().GetTimestamp());
+    }
+    EXPECT_FALSE(CDMDateTime::IsLockFreeConversion());
+
+#ifndef _WIN32
+    if (!CDMDateTime::EnableLockFreeConversion()) {
+        return; // 没有时区数据库的环境
+    }
+    EXPECT_TRUE(CDMDateTime::IsLockFreeConversion());
+
+    // 多个线程同时换算，结果与 libc 路径一致
+    std::atomic<int> mismatches{ 0 };
+    std::vector<std::thread> workers;
+    for (int w = 0; w < 4; ++w) {
+        workers.emplace_back([&, w]() {
+            for (size_t i = w; i < stamps.size(); i += 2) {
+                const CDMDateTime dt = CDMDateTime::FromTimestamp(stamps[i]);
+                if (dt.GetHour() != hours[i] || dt.GetStartOfDay().GetTimestamp() != day_starts[i]) {
+                    mismatches.fetch_add(1);
+                }
+            }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    EXPECT_EQ(0, mismatches.load());
+    CDMDateTime::DisableLockFreeConversion();
+    EXPECT_FALSE(CDMDateTime::IsLockFreeConversion());
+#endif
+}
+
+TEST_F(CDMDateTimePracticalTest, LunarCalendar)
+{
+    // 各年正月初一
+    const int new_years[][3] = {
+        { 1900, 1, 31 }, { 1949, 1, 29 }, { 1970, 2, 6 }, { 2000, 2, 5 }, { 2008, 2, 7 }, { 2020, 1, 25 },
+        { 2023, 1, 22 }, { 2024, 2, 10 }, { 2025, 1, 29 }, { 2026, 2, 17 }, { 2050, 1, 23 }, { 2100, 2, 9 },
+    };
+    for (const auto& ny : new_years) {
+        DMLunarDate lunar{};
+        ASSERT_TRUE(CDMLunarCalendar::FromSolar(ny[0], ny[1], ny[2], lunar)) << ny[0];
+        EXPECT_EQ(ny[0], lunar.year);
+        EXPECT_EQ(1, lunar.month);
+        EXPECT_EQ(1, lunar.day);
+        EXPECT_FALSE(lunar.is_leap_month);
+        DMLunarDate eve{};
+        ASSERT_TRUE(CDMLunarCalendar::FromDays(CDMCivil::DaysFromCivil(ny[0], ny[1], ny[2]) - 1, eve) || ny[0] == 1900);
+    }
+
+    // 闰月：2023 闰二月、2025 闰六月
+    DMLunarDate lunar{};
+    ASSERT_TRUE(CDMLunarCalendar::FromSolar(2023, 3, 22, lunar));
+    EXPECT_EQ(2, lunar.month);
+    EXPECT_EQ(1, lunar.day);
+    EXPECT_TRUE(lunar.is_leap_month);
+    ASSERT_TRUE(CDMLunarCalendar::FromSolar(2025, 7, 25, lunar));
+    EXPECT_EQ("乙巳年闰六月初一", CDMLunarCalendar::ToChineseString(lunar));
+    EXPECT_EQ("2025-L06-01", CDMLunarCalendar::ToNumericString(lunar));
+    EXPECT_EQ("2025-06-01", CDMLunarCalendar::ToNumericString(DMLunarDate{ 2025, 6, 1, false }));
+    EXPECT_EQ("甲辰", CDMLunarCalendar::GanZhiYear(2024));
+    EXPECT_EQ("龙", CDMLunarCalendar::Zodiac(2024));
+    EXPECT_EQ("癸卯年腊月三十", CDMLunarCalendar::ToChineseString(DMLunarDate{ 2023, 12, 30, false }));
+    EXPECT_EQ("甲辰年正月初十", CDMLunarCalendar::ToChineseString(DMLunarDate{ 2024, 1, 10, false }));
+    EXPECT_EQ("甲辰年八月十五", CDMLunarCalendar::ToChineseString(DMLunarDate{ 2024, 8, 15, false }));
+    EXPECT_EQ("甲辰年五月二十", CDMLunarCalendar::ToChineseString(DMLunarDate{ 2024, 5, 20, false }));
+
+    // 整个范围逐日往返，且农历日期严格递增
+    DMLunarDate previous{};
+    const long long first = CDMCivil::DaysFromCivil(1900, 1, 31);
+    const long long last = CDMCivil::DaysFromCivil(2101, 1, 28);
+    for (long long days = first; days <= last; ++days) {
+        DMLunarDate current{};
+        ASSERT_TRUE(CDMLunarCalendar::FromDays(days, current)) << days;
+        long long back = 0;
+        ASSERT_TRUE(CDMLunarCalendar::ToDays(current, back));
+        ASSERT_EQ(days, back);
+        if (days > first) {
+            const bool next_day = current.year == previous.year && current.month == previous.month
+                && current.is_leap_month == previous.is_leap_month && current.day == previous.day + 1;
+            ASSERT_TRUE(next_day || current.day == 1) << days;
+        }
+        previous = current;
+    }
+    EXPECT_FALSE(CDMLunarCalendar::FromDays(first - 1, lunar));
+    EXPECT_FALSE(CDMLunarCalendar::FromDays(last + 1, lunar));
+
+    // 不存在的日期
+    long long days = 0;
+    EXPECT_FALSE(CDMLunarCalendar::ToDays(DMLunarDate{ 2024, 6, 1, true }, days)); // 2024 无闰月
+    EXPECT_FALSE(CDMLunarCalendar::ToDays(DMLunarDate{ 2101, 1, 1, false }, days));
+
+    // CDMDateTime 接口
+    CDMDateTime mid_autumn = CDMDateTime::FromLunar(2024, 8, 15, false, 20, 0, 0);
+    EXPECT_EQ("2024-09-17 20:00:00", mid_autumn.ToString());
+    EXPECT_EQ("甲辰年八月十五", mid_autumn.ToLunarString());
+    EXPECT_THROW(CDMDateTime::FromLunar(2024, 1, 30), std::runtime_error); // 2024 正月为小月
+    EXPECT_EQ("", CDMDateTime(1899, 12, 31, 0, 0, 0).ToLunarString());
+}
+
+TEST_F(CDMDateTimeUsageTest, SolarTerms) {
+    int month = 0;
+    int day = 0;
+    ASSERT_TRUE(CDMSolarTerm::GetDate(2025, CDMSolarTerm::START_OF_SPRING, month, day));
+    EXPECT_EQ(2, month);
+    EXPECT_EQ(3, day);
+    ASSERT_TRUE(CDMSolarTerm::GetDate(2023, CDMSolarTerm::PURE_BRIGHTNESS, month, day));
+    EXPECT_EQ(4, month);
+    EXPECT_EQ(5, day);
+    ASSERT_TRUE(CDMSolarTerm::GetDate(1900, CDMSolarTerm::MINOR_COLD, month, day));
+    EXPECT_EQ(1, month);
+    EXPECT_EQ(6, day);
+    EXPECT_FALSE(CDMSolarTerm::GetDate(2101, CDMSolarTerm::MINOR_COLD, month, day));
+    EXPECT_STREQ("冬至", CDMSolarTerm::GetName(CDMSolarTerm::WINTER_SOLSTICE));
+
+    // 2024 冬至 2024-12-21 17:20（北京时间），在各测试时区都是 12 月 21 日
+    EXPECT_EQ(CDMSolarTerm::WINTER_SOLSTICE, CDMDateTime(2024, 12, 21, 12, 0, 0).GetSolarTerm());
+    EXPECT_EQ("冬至", CDMDateTime(2024, 12, 21, 12, 0, 0).GetSolarTermName());
+    EXPECT_EQ(-1, CDMDateTime(2024, 12, 10, 12, 0, 0).GetSolarTerm());
+    EXPECT_EQ("", CDMDateTime(2024, 12, 10, 12, 0, 0).GetSolarTermName());
+
+    const long long solstice = CDMSolarTerm::Timestamp(2024, CDMSolarTerm::WINTER_SOLSTICE);
+    EXPECT_EQ(1734772800LL, solstice); // 2024-12-21 09:20 UTC
+    int term = -1;
+    CDMDateTime when;
+    ASSERT_TRUE(CDMDateTime::FromTimestamp(static_cast<time_t>(solstice - 1)).GetNextSolarTerm(term, when));
+    EXPECT_EQ(CDMSolarTerm::WINTER_SOLSTICE, term);
+    EXPECT_EQ(solstice, static_cast<long long>(when.GetTimestamp()));
+    ASSERT_TRUE(CDMDateTime::FromTimestamp(static_cast<time_t>(solstice)).GetNextSolarTerm(term, when));
+    EXPECT_EQ(CDMSolarTerm::MINOR_COLD, term);
+    EXPECT_EQ(CDMSolarTerm::Timestamp(2025, CDMSolarTerm::MINOR_COLD), static_cast<long long>(when.GetTimestamp()));
+
+    int year = 0;
+    long long timestamp = 0;
+    ASSERT_TRUE(CDMSolarTerm::Current(static_cast<time_t>(solstice + 86400), year, term, timestamp));
+    EXPECT_EQ(2024, year);
+    EXPECT_EQ(CDMSolarTerm::WINTER_SOLSTICE, term);
+    ASSERT_TRUE(CDMSolarTerm::Current(static_cast<time_t>(solstice - 60), year, term, timestamp));
+    EXPECT_EQ(CDMSolarTerm::MAJOR_SNOW, term);
+
+    // 表的两端：1900 年小寒之前未知；2100 年冬至之后到 2101 年小寒基准日（1 月 4 日）之前仍是冬至，再往后未知
+    const long long first = CDMSolarTerm::Timestamp(CDMSolarTerm::MIN_YEAR, CDMSolarTerm::MINOR_COLD);
+    EXPECT_FALSE(CDMSolarTerm::Current(static_cast<time_t>(first - 1), year, term, timestamp));
+    ASSERT_TRUE(CDMSolarTerm::Current(static_cast<time_t>(first), year, term, timestamp));
+    EXPECT_EQ(1900, year);
+    EXPECT_EQ(CDMSolarTerm::MINOR_COLD, term);
+    const long long last = CDMSolarTerm::Timestamp(CDMSolarTerm::MAX_YEAR, CDMSolarTerm::WINTER_SOLSTICE);
+    ASSERT_TRUE(CDMSolarTerm::Current(static_cast<time_t>(last - 60), year, term, timestamp));
+    EXPECT_EQ(2100, year);
+    EXPECT_EQ(CDMSolarTerm::MAJOR_SNOW, term);
+    ASSERT_TRUE(CDMSolarTerm::Current(static_cast<time_t>(last), year, term, timestamp));
+    EXPECT_EQ(2100, year);
+    EXPECT_EQ(CDMSolarTerm::WINTER_SOLSTICE, term);
+    EXPECT_EQ(last, timestamp);
+    const time_t before_minor_cold = static_cast<time_t>(CDMCivil::DaysFromCivil(2101, 1, 3) * 86400 + 15 * 3600); // 北京时间 1 月 3 日 23:00
+    ASSERT_TRUE(CDMSolarTerm::Current(before_minor_cold, year, term, timestamp));
+    EXPECT_EQ(CDMSolarTerm::WINTER_SOLSTICE, term);
+    EXPECT_FALSE(CDMSolarTerm::Current(static_cast<time_t>(before_minor_cold + 3600), year, term, timestamp));
+    EXPECT_FALSE(CDMSolarTerm::Current(CDMDateTime(2101, 3, 1, 12, 0, 0).GetTimestamp(), year, term, timestamp));
+    EXPECT_FALSE(CDMSolarTerm::Current(CDMDateTime(3000, 6, 1, 12, 0, 0).GetTimestamp(), year, term, timestamp));
+
+    // 任意时刻的下一个节气都在 16 天以内，且各年 24 个节气严格递增
+    for (int y = CDMSolarTerm::MIN_YEAR; y <= CDMSolarTerm::MAX_YEAR; ++y) {
+        for (int k = 1; k < CDMSolarTerm::TERM_COUNT; ++k) {
+            const long long gap = CDMSolarTerm::Timestamp(y, k) - CDMSolarTerm::Timestamp(y, k - 1);
+            ASSERT_GT(gap, 14 * 86400LL) << y << " " << k;
+            ASSERT_LT(gap, 16 * 86400LL) << y << " " << k;
+        }
+    }
+}
+
+TEST_F(CDMDateTimePracticalTest, BusinessCalendar) {
+    CDMBusinessCalendar calendar(2020, 2030);
+    EXPECT_EQ(262, calendar.CountBusinessDays(CDMDateTime(2024, 1, 1), CDMDateTime(2025, 1, 1)));
+
+    // 2024 国庆：10 月 1-7 日放假，9 月 29 日（周日）、10 月 12 日（周六）上班
+    calendar.SetHolidays(2024, 10, 1, 7);
+    calendar.SetWorkday(2024, 9, 29);
+    calendar.SetWorkday(2024, 10, 12);
+    EXPECT_TRUE(calendar.IsBusinessDay(CDMDateTime(2024, 9, 29, 10, 0, 0)));
+    EXPECT_FALSE(calendar.IsBusinessDay(CDMDateTime(2024, 10, 4, 10, 0, 0)));
+    EXPECT_TRUE(calendar.IsBusinessDay(2024, 10, 12));
+    EXPECT_FALSE(calendar.IsBusinessDay(2024, 10, 13));
+    EXPECT_EQ(19, calendar.CountBusinessDays(CDMDateTime(2024, 10, 1), CDMDateTime(2024, 11, 1)));
+    EXPECT_EQ(259, calendar.CountBusinessDays(CDMDateTime(2024, 1, 1), CDMDateTime(2025, 1, 1)));
+
+    EXPECT_EQ("2024-10-08 09:30:00", calendar.AddBusinessDays(CDMDateTime(2024, 9, 30, 9, 30, 0), 1).ToString());
+    EXPECT_EQ("2024-09-30 09:30:00", calendar.AddBusinessDays(CDMDateTime(2024, 10, 8, 9, 30, 0), -1).ToString());
+    EXPECT_EQ("2024-09-29 00:00:00", calendar.AddBusinessDays(CDMDateTime(2024, 9, 28), 1).ToString());
+    EXPECT_EQ("2024-10-12 00:00:00", calendar.AddBusinessDays(CDMDateTime(2024, 10, 7), 5).ToString());
+
+    calendar.ResetDay(2024, 10, 12);
+    EXPECT_FALSE(calendar.IsBusinessDay(2024, 10, 12));
+    EXPECT_THROW(calendar.SetHoliday(2031, 1, 1), std::runtime_error);
+    EXPECT_THROW(calendar.AddBusinessDays(CDMDateTime(2030, 12, 31), 1), std::runtime_error);
+    EXPECT_THROW(calendar.AddBusinessDays(CDMDateTime(2020, 1, 1), -1), std::runtime_error);
+    EXPECT_TRUE(calendar.IsBusinessDay(2035, 1, 1)); // 范围外按周末规则
+
+    // 与逐日判断对照
+    const long long first = CDMCivil::DaysFromCivil(2020, 1, 1);
+    const long long last = CDMCivil::DaysFromCivil(2031, 1, 1);
+    for (long long start = first; start < last; start += 97) {
+        for (long long length = 0; length < 400 && start + length <= last; length += 37) {
+            long long expected = 0;
+            for (long long d = start; d < start + length; ++d) {
+                expected += calendar.IsBusinessDay(d) ? 1 : 0;
+            }
+            ASSERT_EQ(expected, calendar.CountBusinessDays(start, start + length)) << start << " " << length;
+        }
+        if (start + 200 < last && start - 200 >= first) {
+            for (long long n = -60; n <= 60; n += 7) {
+                long long expected = start;
+                for (long long left = n; left != 0;) {
+                    expected += n > 0 ? 1 : -1;
+                    if (calendar.IsBusinessDay(expected)) {
+                        left += n > 0 ? -1 : 1;
+                    }
+                }
+                ASSERT_EQ(expected, calendar.AddBusinessDays(start, n)) << start << " " << n;
+            }
+        }
+    }
+}
+
+TEST_F(CDMDateTimePracticalTest, TimerWheel) {
+    const CDMDateTime start = CDMDateTime::FromTimestamp(1704067200); // 2024-01-01 00:00:00 UTC
+    CDMTimerWheel wheel(start);
+    std::vector<std::pair<long long, long long> > fired; // (计划时间, 触发时的轮时间)
+    auto record = [&](CDMTimerWheel::TimerId, const CDMDateTime& scheduled) {
+        fired.push_back(std::make_pair(static_cast<long long>(scheduled.GetTimestamp()),
+            static_cast<long long>(wheel.GetCurrentTime().GetTimestamp())));
+    };
+
+    // 跨越各层边界的延迟
+    const long long delays[] = { 1, 255, 256, 257, 16383, 16384, 16385, 1048575, 1048576, 67108864 + 5, 5000000000LL };
+    for (long long delay : delays) {
+        wheel.AddTimer(CDMTimeSpan(delay), record);
+    }
+    const CDMTimerWheel::TimerId cancelled = wheel.AddTimer(CDMTimeSpan(300), record);
+    EXPECT_TRUE(wheel.Cancel(cancelled));
+    EXPECT_FALSE(wheel.Cancel(cancelled));
+    EXPECT_EQ(sizeof(delays) / sizeof(delays[0]), wheel.Size());
+
+    for (long long delay : delays) {
+        wheel.Advance(start + CDMTimeSpan(delay - 1));
+        wheel.Advance(start + CDMTimeSpan(delay));
+    }
+    ASSERT_EQ(sizeof(delays) / sizeof(delays[0]), fired.size());
+    for (size_t i = 0; i < fired.size(); ++i) {
+        EXPECT_EQ(start.GetTimestamp() + delays[i], fired[i].first);
+        EXPECT_EQ(fired[i].first, fired[i].second);
+    }
+    EXPECT_TRUE(wheel.Empty());
+
+    // 随机定时器与随机步长推进，每个都恰好在到期那一秒触发
+    fired.clear();
+    unsigned seed = 12345;
+    auto next_random = [&seed]() {
+        seed = seed * 1103515245u + 12345u;
+        return static_cast<long long>((seed >> 8) & 0xFFFFF);
+    };
+    CDMTimerWheel::TimerId ids[2000];
+    for (int i = 0; i < 2000; ++i) {
+        ids[i] = wheel.AddTimer(wheel.GetCurrentTime() + CDMTimeSpan(1 + next_random() % 200000), record);
+    }
+    for (int i = 0; i < 2000; i += 10) {
+        EXPECT_TRUE(wheel.Cancel(ids[i]));
+    }
+    while (!wheel.Empty()) {
+        wheel.Advance(wheel.GetCurrentTime() + CDMTimeSpan(1 + next_random() % 5000));
+    }
+    ASSERT_EQ(1800u, fired.size());
+    for (size_t i = 0; i < fired.size(); ++i) {
+        EXPECT_EQ(fired[i].first, fired[i].second);
+        if (i > 0) {
+            EXPECT_LE(fired[i - 1].first, fired[i].first);
+        }
+    }
+
+    // 回调中取消同批与自身
+    fired.clear();
+    CDMTimerWheel::TimerId victim = CDMTimerWheel::INVALID_TIMER;
+    CDMTimerWheel::TimerId self = CDMTimerWheel::INVALID_TIMER;
+    wheel.AddTimer(CDMTimeSpan(9), [&](CDMTimerWheel::TimerId, const CDMDateTime&) { EXPECT_TRUE(wheel.Cancel(victim)); });
+    victim = wheel.AddTimer(CDMTimeSpan(10), record);
+    self = wheel.AddInterval(CDMTimeSpan(5), [&](CDMTimerWheel::TimerId id, const CDMDateTime& scheduled) {
+        record(id, scheduled);
+        if (fired.size() == 3) {
+            EXPECT_TRUE(wheel.Cancel(self));
+        }
+    });
+    wheel.Advance(wheel.GetCurrentTime() + CDMTimeSpan(100));
+    EXPECT_EQ(3u, fired.size());
+    EXPECT_TRUE(wheel.Empty());
+}
+
+TEST_F(CDMDateTimePracticalTest, TimerWheelCalendarRecurrence) {
+    CDMTimerWheel wheel(CDMDateTime(2024, 1, 30, 10, 0, 0));
+    std::vector<std::string> daily, weekly, monthly;
+    wheel.AddDaily(9, 0, 0, [&](CDMTimerWheel::TimerId, const CDMDateTime& when) { daily.push_back(when.ToString()); });
+    wheel.AddWeekly(1, 8, 30, 0, [&](CDMTimerWheel::TimerId, const CDMDateTime& when) { weekly.push_back(when.ToString()); });
+    const CDMTimerWheel::TimerId month_id = wheel.AddMonthly(31, 0, 0, 0,
+        [&](CDMTimerWheel::TimerId, const CDMDateTime& when) { monthly.push_back(when.ToString()); });
+
+    CDMDateTime next_fire;
+    ASSERT_TRUE(wheel.GetFireTime(month_id, next_fire));
+    EXPECT_EQ("2024-01-31 00:00:00", next_fire.ToString());
+
+    // 逐日推进，跨过美国夏令时切换（3 月 10 日）
+    for (int i = 0; i < 90; ++i) {
+        wheel.Advance(wheel.GetCurrentTime() + CDMTimeSpan(86400));
+    }
+    ASSERT_GE(daily.size(), 89u);
+    EXPECT_EQ("2024-01-31 09:00:00", daily[0]);
+    EXPECT_EQ("2024-03-11 09:00:00", daily[40]);
+    ASSERT_GE(weekly.size(), 12u);
+    EXPECT_EQ("2024-02-05 08:30:00", weekly[0]);
+    EXPECT_EQ("2024-03-11 08:30:00", weekly[5]);
+    ASSERT_EQ(3u, monthly.size());
+    EXPECT_EQ("2024-01-31 00:00:00", monthly[0]);
+    EXPECT_EQ("2024-02-29 00:00:00", monthly[1]);
+    EXPECT_EQ("2024-03-31 00:00:00", monthly[2]);
+    EXPECT_EQ(3u, wheel.Size());
+
+    // 一次推进十天，期间每一次都按计划时间依次触发
+    daily.clear();
+    wheel.Advance(wheel.GetCurrentTime() + CDMTimeSpan(10 * 86400));
+    ASSERT_EQ(10u, daily.size());
+    EXPECT_EQ("2024-05-09 09:00:00", daily[9]);
+}
+
+TEST_F(CDMDateTimePracticalTest, CronExpression) {
+    CDMCronExpression cron = CDMCronExpression::Parse("*/15 9-18 * * MON-FRI");
+    EXPECT_EQ(1ULL, cron.GetSecondMask());
+    EXPECT_EQ((1ULL << 0) | (1ULL << 15) | (1ULL << 30) | (1ULL << 45), cron.GetMinuteMask());
+    EXPECT_EQ(((1u << 19) - 1) & ~((1u << 9) - 1), cron.GetHourMask());
+    EXPECT_EQ(0x3E, cron.GetWeekdayMask());
+    EXPECT_EQ(0x41, CDMCronExpression::Parse("0 0 * * 7,sat").GetWeekdayMask());
+
+    const char* invalid[] = { "60 * * * *", "* * * *", "* * * * * * *", "a * * * *", "5-1 * * * *",
+        "*/0 * * * *", "1,,2 * * * *", "1, * * * *", "* * 0 * *", "* * * 13 *", "@never", "" };
+    for (const char* text : invalid) {
+        EXPECT_FALSE(CDMCronExpression::TryParse(text, cron)) << text;
+    }
+    EXPECT_THROW(CDMCronExpression::Parse("* * * *"), std::runtime_error);
+
+    struct Case {
+        const char* expression;
+        CDMDateTime after;
+        const char* expected;
+    } cases[] = {
+        { "*/15 * * * *", CDMDateTime(2024, 1, 1, 0, 0, 0), "2024-01-01 00:15:00" },
+        { "0 9 * * MON-FRI", CDMDateTime(2024, 1, 6, 10, 0, 0), "2024-01-08 09:00:00" },
+        { "0 0 29 2 *", CDMDateTime(2024, 3, 1, 0, 0, 0), "2028-02-29 00:00:00" },
+        { "0 0 13 * 5", CDMDateTime(2024, 1, 1, 0, 0, 0), "2024-01-05 00:00:00" },
+        { "0 0 13 * 5", CDMDateTime(2024, 1, 12, 0, 0, 0), "2024-01-13 00:00:00" },
+        { "0 0 * * 5", CDMDateTime(2024, 1, 6, 0, 0, 0), "2024-01-12 00:00:00" },
+        { "30 0 0 1 1 *", CDMDateTime(2024, 6, 1, 0, 0, 0), "2025-01-01 00:00:30" },
+        { "0 0 1 1 *", CDMDateTime(2024, 12, 31, 23, 59, 59), "2025-01-01 00:00:00" },
+        { "@hourly", CDMDateTime(2024, 5, 5, 10, 59, 59), "2024-05-05 11:00:00" },
+        { "@weekly", CDMDateTime(2024, 5, 5, 0, 0, 0), "2024-05-12 00:00:00" },
+        { "0 30 23 31 * ?", CDMDateTime(2024, 4, 1, 0, 0, 0), "2024-05-31 23:30:00" },
+        { "*/20 * * * * *", CDMDateTime(2024, 12, 31, 23, 59, 59), "2025-01-01 00:00:00" },
+    };
+    for (const Case& item : cases) {
+        EXPECT_EQ(item.expected, CDMCronExpression::Parse(item.expression).NextFireTime(item.after).ToString()) << item.expression;
+    }
+
+    CDMDateTime next;
+    EXPECT_FALSE(CDMCronExpression::Parse("0 0 30 2 *").GetNextFireTime(CDMDateTime(2024, 1, 1), next));
+    EXPECT_THROW(CDMCronExpression::Parse("0 0 31 4 *").NextFireTime(CDMDateTime(2024, 1, 1)), std::runtime_error);
+    EXPECT_TRUE(CDMCronExpression::Parse("0 9 * * MON-FRI").Matches(CDMDateTime(2024, 1, 8, 9, 0, 0)));
+    EXPECT_FALSE(CDMCronExpression::Parse("0 9 * * MON-FRI").Matches(CDMDateTime(2024, 1, 7, 9, 0, 0)));
+
+    // 与逐分钟匹配对照（一月份，各测试时区都不切换夏令时）
+    const char* expressions[] = { "*/7 */5 * * *", "13 2,14 * * 1,3", "0 0 10-20/3 * 2", "45 23 * * *", "5 4 * * 6" };
+    for (const char* expression : expressions) {
+        const CDMCronExpression parsed = CDMCronExpression::Parse(expression);
+        CDMDateTime after(2024, 1, 3, 0, 0, 0);
+        for (int i = 0; i < 20; ++i) {
+            CDMDateTime expected = after.AddSeconds(60 - after.GetSecond());
+            while (!parsed.Matches(expected)) {
+                expected = expected.AddMinutes(1);
+            }
+            const CDMDateTime actual = parsed.NextFireTime(after);
+            ASSERT_EQ(expected.ToString(), actual.ToString()) << expression;
+            after = actual.AddSeconds(i % 3 == 0 ? 0 : 17);
+        }
+    }
+}
+
+TEST_F(CDMDateTimePracticalTest, RecurrenceRule) {
+    // RFC 5545 3.8.5.3 中的示例
+    struct Case {
+        const char* rule;
+        CDMDateTime start;
+        std::vector<std::string> expected;
+    } cases[] = {
+        { "RRULE:FREQ=DAILY;COUNT=3", CDMDateTime(1997, 9, 2, 9, 0, 0),
+            { "1997-09-02 09:00:00", "1997-09-03 09:00:00", "1997-09-04 09:00:00" } },
+        { "FREQ=DAILY;UNTIL=19970905", CDMDateTime(1997, 9, 2, 9, 0, 0),
+            { "1997-09-02 09:00:00", "1997-09-03 09:00:00", "1997-09-04 09:00:00", "1997-09-05 09:00:00" } },
+        { "FREQ=WEEKLY;INTERVAL=2;WKST=SU;BYDAY=TU,TH;COUNT=8", CDMDateTime(1997, 9, 2, 9, 0, 0),
+            { "1997-09-02 09:00:00", "1997-09-04 09:00:00", "1997-09-16 09:00:00", "1997-09-18 09:00:00",
+              "1997-09-30 09:00:00", "1997-10-02 09:00:00", "1997-10-14 09:00:00", "1997-10-16 09:00:00" } },
+        { "FREQ=MONTHLY;BYDAY=-2MO;COUNT=6", CDMDateTime(1997, 9, 22, 9, 0, 0),
+            { "1997-09-22 09:00:00", "1997-10-20 09:00:00", "1997-11-17 09:00:00", "1997-12-22 09:00:00",
+              "1998-01-19 09:00:00", "1998-02-16 09:00:00" } },
+        { "FREQ=MONTHLY;BYDAY=MO,TU,WE,TH,FR;BYSETPOS=-2;COUNT=4", CDMDateTime(1997, 9, 29, 9, 0, 0),
+            { "1997-09-29 09:00:00", "1997-10-30 09:00:00", "1997-11-27 09:00:00", "1997-12-30 09:00:00" } },
+        { "FREQ=MONTHLY;BYDAY=FR;BYMONTHDAY=13;COUNT=5", CDMDateTime(1997, 9, 2, 9, 0, 0),
+            { "1998-02-13 09:00:00", "1998-03-13 09:00:00", "1998-11-13 09:00:00", "1999-08-13 09:00:00",
+              "2000-10-13 09:00:00" } },
+        { "FREQ=MONTHLY;BYMONTHDAY=-1;COUNT=3", CDMDateTime(2024, 1, 31, 18, 0, 0),
+            { "2024-01-31 18:00:00", "2024-02-29 18:00:00", "2024-03-31 18:00:00" } },
+        { "FREQ=YEARLY;BYMONTH=11;BYDAY=4TH;COUNT=2", CDMDateTime(2024, 1, 1, 12, 0, 0),
+            { "2024-11-28 12:00:00", "2025-11-27 12:00:00" } },
+        { "FREQ=YEARLY;BYDAY=20MO;COUNT=2", CDMDateTime(1997, 5, 19, 9, 0, 0),
+            { "1997-05-19 09:00:00", "1998-05-18 09:00:00" } },
+        { "FREQ=YEARLY;INTERVAL=4;COUNT=2", CDMDateTime(2024, 2, 29, 0, 0, 0),
+            { "2024-02-29 00:00:00", "2028-02-29 00:00:00" } },
+    };
+    for (const Case& item : cases) {
+        CDMRecurrenceRule rule = CDMRecurrenceRule::Parse(item.rule, item.start);
+        CDMRecurrenceRule::Iterator it = rule.Begin();
+        std::vector<std::string> actual;
+        CDMDateTime occurrence;
+        while (actual.size() < 20 && it.Next(occurrence)) {
+            actual.push_back(occurrence.ToString());
+        }
+        EXPECT_EQ(item.expected, actual) << item.rule;
+    }
+
+    const char* invalid[] = { "FREQ=HOURLY", "COUNT=3", "FREQ=DAILY;COUNT=2;UNTIL=20240101", "FREQ=DAILY;BYDAY=XX",
+        "FREQ=DAILY;BYMONTHDAY=0", "FREQ=DAILY;BYHOUR=3", "FREQ=DAILY;INTERVAL=0", "FREQ=DAILY;UNTIL=20240230", "" };
+    CDMRecurrenceRule rule;
+    for (const char* text : invalid) {
+        EXPECT_FALSE(CDMRecurrenceRule::TryParse(text, CDMDateTime(2024, 1, 1), rule)) << text;
+    }
+    EXPECT_THROW(CDMRecurrenceRule::Parse("FREQ=SOMETIMES", CDMDateTime(2024, 1, 1)), std::runtime_error);
+
+    CDMDateTime next;
+    EXPECT_FALSE(CDMRecurrenceRule::Parse("FREQ=YEARLY;BYMONTH=2;BYMONTHDAY=30", CDMDateTime(2024, 1, 1)).GetNextOccurrence(CDMDateTime(2024, 1, 1), next));
+
+    // 定位与逐个展开的结果一致
+    const char* rules[] = { "FREQ=WEEKLY;BYDAY=MO,WE,FR", "FREQ=MONTHLY;INTERVAL=3;BYDAY=-1FR",
+        "FREQ=DAILY;INTERVAL=10;COUNT=500", "FREQ=MONTHLY;BYDAY=MO,TU,WE,TH,FR;BYSETPOS=1,-1;COUNT=100" };
+    for (const char* text : rules) {
+        CDMRecurrenceRule seek = CDMRecurrenceRule::Parse(text, CDMDateTime(2000, 1, 3, 9, 0, 0));
+        CDMRecurrenceRule::Iterator linear = seek.Begin();
+        CDMDateTime previous = CDMDateTime(2000, 1, 1);
+        CDMDateTime occurrence;
+        for (int i = 0; i < 400 && linear.Next(occurrence); ++i) {
+            const CDMDateTime probe = previous.AddSeconds((occurrence - previous).GetTotalSeconds() / 2);
+            ASSERT_TRUE(seek.GetNextOccurrence(probe, next)) << text;
+            EXPECT_EQ(occurrence.ToString(), next.ToString()) << text;
+            previous = occurrence;
+        }
+        EXPECT_EQ(linear.Next(occurrence), seek.GetNextOccurrence(previous, next)) << text;
+    }
+    EXPECT_TRUE(CDMRecurrenceRule::Parse("FREQ=WEEKLY;BYDAY=MO,WE,FR", CDMDateTime(2000, 1, 3, 9, 0, 0))
+        .GetNextOccurrence(CDMDateTime(2024, 6, 5, 9, 0, 0), next));
+    EXPECT_EQ("2024-06-07 09:00:00", next.ToString());
+
+    // 大 COUNT 规则向远处定位（跨越 400 年循环、第一个周期内有早于 DTSTART 的候选），与从头逐个展开一致
+    const std::pair<const char*, CDMDateTime> counted[] = {
+        { "FREQ=DAILY;COUNT=100000", CDMDateTime(2000, 1, 1, 9, 0, 0) },
+        { "FREQ=WEEKLY;BYDAY=MO,WE,FR;COUNT=20000", CDMDateTime(2000, 1, 1, 9, 0, 0) },
+        { "FREQ=MONTHLY;BYDAY=-1FR;COUNT=5000", CDMDateTime(2000, 1, 1, 9, 0, 0) },
+        { "FREQ=MONTHLY;BYMONTHDAY=1,15,28;COUNT=6000", CDMDateTime(2000, 1, 20, 9, 0, 0) },
+        { "FREQ=YEARLY;BYMONTH=1,7;BYMONTHDAY=1;COUNT=1000", CDMDateTime(2000, 3, 1, 9, 0, 0) },
+        { "FREQ=YEARLY;INTERVAL=3;BYMONTH=2;BYMONTHDAY=29;COUNT=60", CDMDateTime(2000, 1, 1, 9, 0, 0) },
+        { "FREQ=DAILY;INTERVAL=7;COUNT=30000", CDMDateTime(2000, 1, 1, 9, 0, 0) },
+    };
+    for (const auto& item : counted) {
+        const CDMRecurrenceRule rule = CDMRecurrenceRule::Parse(item.first, item.second);
+        std::vector<CDMDateTime> all;
+        CDMRecurrenceRule::Iterator it = rule.Begin();
+        CDMDateTime occurrence;
+        while (it.Next(occurrence)) {
+            all.push_back(occurrence);
+        }
+        ASSERT_FALSE(all.empty()) << item.first;
+        const size_t step = all.size() / 37 + 1;
+        for (size_t i = 0; i < all.size(); i += step) {
+            ASSERT_TRUE(rule.GetNextOccurrence(all[i].AddSeconds(-1), next)) << item.first;
+            EXPECT_EQ(all[i], next) << item.first << " #" << i;
+            EXPECT_EQ(i + 1 < all.size(), rule.GetNextOccurrence(all[i], next)) << item.first << " #" << i;
+            if (i + 1 < all.size()) {
+                EXPECT_EQ(all[i + 1], next) << item.first << " #" << i;
+            }
+        }
+        EXPECT_FALSE(rule.GetNextOccurrence(all.back(), next)) << item.first;
+        std::vector<CDMDateTime> tail;
+        EXPECT_EQ(std::min<size_t>(all.size() - all.size() / 2, 5), rule.Expand(all[all.size() / 2], CDMDateTime(9000, 1, 1), tail, 5));
+        EXPECT_EQ(all[all.size() / 2], tail.front()) << item.first;
+    }
+
+    std::vector<CDMDateTime> window;
+    CDMRecurrenceRule daily = CDMRecurrenceRule::Parse("FREQ=DAILY;COUNT=10", CDMDateTime(1997, 9, 2, 9, 0, 0));
+    EXPECT_EQ(3u, daily.Expand(CDMDateTime(1997, 9, 5, 9, 0, 0), CDMDateTime(1997, 9, 8, 9, 0, 0), window, 100));
+    EXPECT_EQ("1997-09-05 09:00:00", window.front().ToString());
+    EXPECT_FALSE(daily.GetNextOccurrence(CDMDateTime(1997, 9, 11, 9, 0, 0), next));
+}
+
+TEST_F(CDMDateTimePracticalTest, IntervalIndex) {
+    // 与逐个比较的结果对照，覆盖各种长度（包括不是 2^k-1 的数组长度）
+    uint64_t seed = 12345;
+    auto next_random = [&seed](uint64_t bound) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        return (seed >> 33) % bound;
+    };
+    const time_t base = CDMDateTime(2024, 1, 1).GetTimestamp();
+    for (size_t count : { 0u, 1u, 2u, 7u, 16u, 100u, 1000u }) {
+        struct Window {
+            time_t begin;
+            time_t end;
+        };
+        std::vector<Window> windows;
+        CDMIntervalIndex index;
+        for (size_t i = 0; i < count; ++i) {
+            const time_t begin = base + static_cast<time_t>(next_random(86400 * 30));
+            const time_t end = begin + static_cast<time_t>(next_random(i % 10 == 0 ? 86400 * 20 : 86400));
+            windows.push_back(Window{ begin, end });
+            index.Add(begin, end, static_cast<uint32_t>(i));
+        }
+        index.Build();
+        for (int query = 0; query < 200; ++query) {
+            const time_t begin = base - 86400 + static_cast<time_t>(next_random(86400 * 32));
+            const time_t end = begin + (query % 2 == 0 ? 1 : static_cast<time_t>(next_random(86400 * 3)));
+            std::vector<uint32_t> expected;
+            for (size_t i = 0; i < windows.size(); ++i) {
+                if (begin < end && begin < windows[i].end && windows[i].begin < end) {
+                    expected.push_back(static_cast<uint32_t>(i));
+                }
+            }
+            std::vector<uint32_t> actual;
+            index.FindOverlaps(CDMDateTime::FromTimestamp(begin), CDMDateTime::FromTimestamp(end), actual);
+            std::sort(actual.begin(), actual.end());
+            ASSERT_EQ(expected, actual) << count << " " << begin << " " << end;
+            if (query % 2 == 0) {
+                EXPECT_EQ(expected.size(), index.CountContaining(CDMDateTime::FromTimestamp(begin)));
+            }
+        }
+    }
+
+    CDMIntervalIndex promotions;
+    promotions.Add(CDMDateTime(2024, 11, 1), CDMDateTime(2024, 11, 12), 1);
+    promotions.Add(CDMDateTime(2024, 11, 11), CDMDateTime(2024, 11, 12), 2);
+    promotions.Add(CDMDateTime(2024, 12, 1), CDMDateTime(2024, 12, 13), 3);
+    EXPECT_THROW(promotions.CountContaining(CDMDateTime(2024, 11, 11)), std::runtime_error);
+    EXPECT_THROW(promotions.Add(CDMDateTime(2024, 2, 1), CDMDateTime(2024, 1, 1), 4), std::runtime_error);
+    promotions.Build();
+    std::vector<uint32_t> hits;
+    EXPECT_EQ(2u, promotions.FindContaining(CDMDateTime(2024, 11, 11, 20, 0, 0), hits));
+    EXPECT_EQ(std::vector<uint32_t>({ 1, 2 }), hits);
+    EXPECT_EQ(0u, promotions.CountContaining(CDMDateTime(2024, 11, 12)));
+
+    CDMIntervalSet open_hours;
+    open_hours.Add(CDMDateTime(2024, 5, 6, 9, 0, 0), CDMDateTime(2024, 5, 6, 12, 0, 0));
+    open_hours.Add(CDMDateTime(2024, 5, 6, 13, 0, 0), CDMDateTime(2024, 5, 6, 18, 0, 0));
+    open_hours.Add(CDMDateTime(2024, 5, 6, 12, 0, 0), CDMDateTime(2024, 5, 6, 12, 30, 0));
+    ASSERT_EQ(2u, open_hours.Size());
+    EXPECT_EQ(CDMDateTime(2024, 5, 6, 12, 30, 0).GetTimestamp(), open_hours.GetRanges()[0].end);
+    EXPECT_TRUE(open_hours.Contains(CDMDateTime(2024, 5, 6, 12, 15, 0)));
+    EXPECT_FALSE(open_hours.Contains(CDMDateTime(2024, 5, 6, 12, 30, 0)));
+    EXPECT_EQ(8 * 3600 + 1800, open_hours.GetTotalDuration().GetTotalSeconds());
+
+    CDMIntervalSet meetings;
+    meetings.Add(CDMDateTime(2024, 5, 6, 10, 0, 0), CDMDateTime(2024, 5, 6, 11, 0, 0));
+    meetings.Add(CDMDateTime(2024, 5, 6, 12, 0, 0), CDMDateTime(2024, 5, 6, 14, 0, 0));
+    const CDMIntervalSet free_time = open_hours - meetings;
+    ASSERT_EQ(3u, free_time.Size());
+    EXPECT_EQ(6 * 3600, free_time.GetTotalDuration().GetTotalSeconds());
+    EXPECT_EQ(CDMDateTime(2024, 5, 6, 14, 0, 0).GetTimestamp(), free_time.GetRanges()[2].begin);
+    EXPECT_EQ(2 * 3600 + 1800, (open_hours & meetings).GetTotalDuration().GetTotalSeconds());
+    EXPECT_EQ(open_hours, (open_hours | meetings) - (meetings - open_hours));
+    EXPECT_EQ(free_time | (open_hours & meetings), open_hours);
+
+    CDMIntervalSet removed = open_hours;
+    removed.Remove(CDMDateTime(2024, 5, 6, 10, 0, 0), CDMDateTime(2024, 5, 6, 11, 0, 0));
+    removed.Remove(CDMDateTime(2024, 5, 6, 12, 0, 0), CDMDateTime(2024, 5, 6, 14, 0, 0));
+    EXPECT_EQ(free_time, removed);
+    EXPECT_TRUE(removed.Overlaps(CDMDateTime(2024, 5, 6, 11, 30, 0).GetTimestamp(), CDMDateTime(2024, 5, 6, 13, 0, 0).GetTimestamp()));
+    EXPECT_FALSE(removed.Overlaps(CDMDateTime(2024, 5, 6, 12, 0, 0).GetTimestamp(), CDMDateTime(2024, 5, 6, 14, 0, 0).GetTimestamp()));
+}
+
+TEST_F(CDMDateTimePracticalTest, TimeBucketing) {
+    const CDMDateTime when(2024, 5, 8, 10, 37, 12);
+    EXPECT_EQ("2024-05-08 10:30:00", when.FloorTo(CDMTimeSpan(15 * 60)).ToString());
+    EXPECT_EQ("2024-05-08 10:45:00", when.CeilTo(CDMTimeSpan(15 * 60)).ToString());
+    EXPECT_EQ("2024-05-08 11:00:00", when.CeilTo(CDMTimeSpan(3600)).ToString());
+    EXPECT_EQ(when.GetStartOfDay(), when.FloorTo(CDMTimeSpan(86400)));
+    EXPECT_EQ(when.FloorTo(CDMTimeSpan(60)), when.FloorTo(CDMTimeSpan(60)).CeilTo(CDMTimeSpan(60)));
+    EXPECT_THROW(when.FloorTo(CDMTimeSpan(0)), std::runtime_error);
+    EXPECT_EQ("2024-05-06 00:00:00", when.GetStartOfWeek().ToString());
+    EXPECT_EQ("2024-05-05 00:00:00", when.GetStartOfWeek(0).ToString());
+    EXPECT_EQ("2024-04-01 00:00:00", when.GetStartOfQuarter().ToString());
+
+    // 约每小时一个样本，覆盖 2023-12 到 2025-01（含各地夏令时切换）
+    std::vector<time_t> stamps;
+    std::vector<double> values;
+    const time_t first = CDMDateTime(2023, 12, 20).GetTimestamp();
+    for (int i = 0; i < 9800; ++i) {
+        stamps.push_back(first + static_cast<time_t>(i) * 3607);
+        values.push_back(static_cast<double>((i * 37) % 101));
+    }
+    for (time_t stamp : stamps) {
+        const CDMDateTime t = CDMDateTime::FromTimestamp(stamp);
+        ASSERT_LE(t.FloorTo(CDMTimeSpan(1800)), t);
+        ASSERT_GE(t.CeilTo(CDMTimeSpan(1800)), t);
+        ASSERT_EQ(t.GetStartOfDay(), t.FloorTo(CDMTimeSpan(86400))) << stamp;
+    }
+    const CDMDateTime from(2024, 1, 1);
+    const CDMDateTime to(2024, 12, 31, 23, 59, 59);
+
+    CDMTimeHistogram monthly = CDMTimeHistogram::Calendar(from, to, CDMTimeHistogram::UNIT_MONTH);
+    ASSERT_EQ(12u, monthly.GetBucketCount());
+    EXPECT_EQ("2024-03-01 00:00:00", monthly.GetBucketBegin(2).ToString());
+    EXPECT_EQ("2025-01-01 00:00:00", monthly.GetBucketEnd(11).ToString());
+    // 逆序输入走二分查找路径
+    std::vector<time_t> reversed_stamps(stamps.rbegin(), stamps.rend());
+    std::vector<double> reversed_values(values.rbegin(), values.rend());
+    const size_t accepted = monthly.Accumulate(reversed_stamps, reversed_values);
+
+    CDMTimeHistogram weekly = CDMTimeHistogram::Calendar(from, to, CDMTimeHistogram::UNIT_WEEK);
+    EXPECT_EQ("2024-01-01 00:00:00", weekly.GetBucketBegin(0).ToString());
+    weekly.Accumulate(stamps.data(), values.data(), stamps.size());
+    CDMTimeHistogram quarterly = CDMTimeHistogram::Calendar(from, to, CDMTimeHistogram::UNIT_QUARTER);
+    ASSERT_EQ(4u, quarterly.GetBucketCount());
+    quarterly.Accumulate(stamps.data(), nullptr, stamps.size());
+
+    std::vector<uint64_t> month_counts(12, 0), week_counts(weekly.GetBucketCount(), 0), quarter_counts(4, 0);
+    std::vector<double> month_sums(12, 0.0), month_max(12, -1.0);
+    size_t expected_accepted = 0;
+    for (size_t i = 0; i < stamps.size(); ++i) {
+        const CDMDateTime t = CDMDateTime::FromTimestamp(stamps[i]);
+        if (t.GetYear() != 2024) {
+            continue;
+        }
+        ++expected_accepted;
+        const int month = t.GetMonth() - 1;
+        ++month_counts[month];
+        month_sums[month] += values[i];
+        month_max[month] = std::max(month_max[month], values[i]);
+        ++quarter_counts[month / 3];
+    }
+    // 最后一周延伸到 2025-01-05；夏令时只差一小时，四舍五入到整周
+    for (time_t stamp : stamps) {
+        const CDMDateTime t = CDMDateTime::FromTimestamp(stamp);
+        const long long week = ((t.GetStartOfWeek() - weekly.GetBucketBegin(0)).GetTotalSeconds() + 3 * 86400) / (7 * 86400);
+        if (t >= weekly.GetBucketBegin(0) && week < static_cast<long long>(week_counts.size())) {
+            ++week_counts[static_cast<size_t>(week)];
+        }
+    }
+    EXPECT_EQ(expected_accepted, accepted);
+    for (size_t m = 0; m < 12; ++m) {
+        EXPECT_EQ(month_counts[m], monthly.GetCount(m)) << m;
+        EXPECT_DOUBLE_EQ(month_sums[m], monthly.GetSum(m)) << m;
+        EXPECT_DOUBLE_EQ(month_max[m], monthly.GetMax(m)) << m;
+    }
+    for (size_t q = 0; q < 4; ++q) {
+        EXPECT_EQ(quarter_counts[q], quarterly.GetCount(q)) << q;
+    }
+    for (size_t w = 0; w < week_counts.size(); ++w) {
+        EXPECT_EQ(week_counts[w], weekly.GetCount(w)) << w;
+    }
+
+    CDMTimeHistogram fixed = CDMTimeHistogram::Fixed(CDMDateTime::FromTimestamp(first), CDMTimeSpan(6 * 3600), 10);
+    EXPECT_EQ(60u, fixed.Accumulate(stamps, values));
+    EXPECT_EQ(6u, fixed.GetCount(0));
+    EXPECT_EQ(0.0, fixed.GetMin(0));
+    EXPECT_EQ(CDMDateTime::FromTimestamp(first + 6 * 3600), fixed.GetBucketEnd(0));
+    fixed.Reset();
+    EXPECT_EQ(0u, fixed.GetCount(0));
+    EXPECT_THROW(CDMTimeHistogram::Fixed(from, CDMTimeSpan(0), 10), std::runtime_error);
+}
+
+TEST_F(CDMDateTimePracticalTest, TimestampColumn) {
+    uint64_t seed = 987654321;
+    auto next_random = [&seed]() {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        return seed >> 16;
+    };
+    const time_t base = CDMDateTime(2024, 3, 1).GetTimestamp();
+    std::vector<time_t> regular, jittered, mixed;
+    for (int i = 0; i < 5000; ++i) {
+        regular.push_back(base + i * 60);
+        jittered.push_back(base + i * 60 + static_cast<time_t>(next_random() % 5));
+    }
+    // 覆盖所有编码分支：0、7/9/12 位、32 位、64 位以及回退
+    const long long steps[] = { 0, 1, -40, 200, -1500, 90000, -3000000000LL, 1LL << 40, -(1LL << 41), 17 };
+    time_t value = base;
+    for (int i = 0; i < 3000; ++i) {
+        value += static_cast<time_t>(steps[next_random() % 10]);
+        mixed.push_back(value);
+    }
+    mixed.push_back(static_cast<time_t>(INT64_MIN / 2));
+    mixed.push_back(static_cast<time_t>(INT64_MAX / 2));
+
+    for (const std::vector<time_t>* input : { &regular, &jittered, &mixed }) {
+        for (size_t block_size : { 1u, 7u, 1024u }) {
+            CDMTimestampColumn column(block_size);
+            column.Append(input->data(), input->size());
+            ASSERT_EQ(input->size(), column.Size());
+            ASSERT_EQ((input->size() + block_size - 1) / block_size, column.GetBlockCount());
+            ASSERT_EQ(*input, column.ToVector()) << block_size;
+
+            const size_t first = input->size() / 3 + 5;
+            std::vector<time_t> part(1500);
+            column.Decode(first, part.size(), part.data());
+            EXPECT_TRUE(std::equal(part.begin(), part.end(), input->begin() + static_cast<std::ptrdiff_t>(first)));
+            EXPECT_EQ((*input)[input->size() - 1], column.At(input->size() - 1));
+
+            const CDMTimestampColumn::Block& header = column.GetBlock(column.GetBlockCount() / 2);
+            const size_t offset = column.GetBlockCount() / 2 * block_size;
+            const auto range = std::minmax_element(input->begin() + static_cast<std::ptrdiff_t>(offset),
+                input->begin() + static_cast<std::ptrdiff_t>(offset + header.count));
+            EXPECT_EQ(*range.first, header.min);
+            EXPECT_EQ(*range.second, header.max);
+        }
+    }
+
+    CDMTimestampColumn column;
+    for (time_t stamp : regular) {
+        column.Append(stamp);
+    }
+    // 间隔固定时每个时间戳约 1 位
+    EXPECT_LT(column.GetCompressedBytes(), regular.size() / 8 + 200);
+
+    std::vector<time_t> found;
+    EXPECT_EQ(120u, column.FindRange(base + 3600, base + 3 * 3600, found));
+    EXPECT_EQ(base + 3600, found.front());
+    EXPECT_EQ(base + 3 * 3600 - 60, found.back());
+
+    CDMTimestampColumn jitter_column(256);
+    jitter_column.Append(jittered.data(), jittered.size());
+    found.clear();
+    jitter_column.FindRange(base + 100000, base + 200000, found);
+    std::vector<time_t> expected;
+    std::copy_if(jittered.begin(), jittered.end(), std::back_inserter(expected),
+        [base](time_t t) { return t >= base + 100000 && t < base + 200000; });
+    EXPECT_EQ(expected, found);
+
+    std::vector<CDMDateTime> dates(column.GetBlock(0).count);
+    EXPECT_EQ(dates.size(), column.DecodeBlock(0, dates.data()));
+    EXPECT_EQ("2024-03-01 00:01:00", dates[1].ToString());
+    EXPECT_THROW(column.At(regular.size()), std::runtime_error);
+    EXPECT_THROW(CDMTimestampColumn(0), std::runtime_error);
+}
+
+TEST_F(CDMDateTimePracticalTest, TimeSeriesFile) {
+    const std::string path = "dmdatetimetest_series.dmts";
+    // 一年的数据，约 150 秒一个，带 0~9 秒抖动，并有重复值
+    std::vector<time_t> stamps;
+    const time_t base = CDMDateTime(2024, 1, 1).GetTimestamp();
+    uint64_t seed = 2024;
+    for (int i = 0; i < 210000; ++i) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        stamps.push_back(base + static_cast<time_t>(i) * 150 + static_cast<time_t>((seed >> 33) % 10));
+        if (i % 1000 == 0) {
+            stamps.push_back(stamps.back());
+        }
+    }
+    {
+        CDMTimeSeriesWriter writer(path, 512);
+        writer.Append(stamps.data(), stamps.size());
+        EXPECT_THROW(writer.Append(base), std::runtime_error);
+        writer.Close();
+        EXPECT_THROW(writer.Append(stamps.back() + 1), std::runtime_error);
+    }
+
+    {
+        CDMTimeSeriesReader reader(path);
+        ASSERT_EQ(stamps.size(), reader.Size());
+        EXPECT_EQ((stamps.size() + 511) / 512, reader.GetBlockCount());
+        EXPECT_EQ(CDMDateTime::FromTimestamp(stamps.front()), reader.GetFirst());
+        EXPECT_EQ(CDMDateTime::FromTimestamp(stamps.back()), reader.GetLast());
+
+        const CDMDateTime starts[] = { CDMDateTime(2023, 6, 1), CDMDateTime(2024, 3, 10, 8, 0, 0),
+            CDMDateTime::FromTimestamp(stamps[1000]), CDMDateTime::FromTimestamp(stamps[512 * 7]), CDMDateTime(2024, 12, 31) };
+        const long long spans[] = { 0, 1, 3600, 86400 * 3, 86400 * 800 };
+        for (const CDMDateTime& start : starts) {
+            for (long long span : spans) {
+                const CDMDateTime end = start.AddSeconds(span);
+                const auto lo = std::lower_bound(stamps.begin(), stamps.end(), start.GetTimestamp());
+                const auto hi = std::lower_bound(stamps.begin(), stamps.end(), end.GetTimestamp());
+                const std::vector<time_t> expected(lo, lo < hi ? hi : lo);
+                std::vector<time_t> actual;
+                EXPECT_EQ(expected.size(), reader.Query(start, end, actual));
+                EXPECT_EQ(expected, actual) << start.ToString() << " +" << span;
+                EXPECT_EQ(expected.size(), reader.Count(start, end));
+            }
+        }
+        std::vector<time_t> all;
+        reader.Query(CDMDateTime::FromTimestamp(0), CDMDateTime(2100, 1, 1), all);
+        EXPECT_EQ(stamps, all);
+    }
+
+    {
+        CDMTimeSeriesWriter empty(path);
+    }
+    {
+        CDMTimeSeriesReader reader(path);
+        EXPECT_EQ(0u, reader.Size());
+        std::vector<time_t> none;
+        EXPECT_EQ(0u, reader.Query(CDMDateTime(2024, 1, 1), CDMDateTime(2025, 1, 1), none));
+        EXPECT_THROW(reader.GetFirst(), std::runtime_error);
+    }
+
+    FILE* fp = std::fopen(path.c_str(), "wb");
+    ASSERT_TRUE(fp != nullptr);
+    std::fputs("this is not a time series file, just some text padding it out", fp);
+    std::fclose(fp);
+    EXPECT_THROW(CDMTimeSeriesReader reader(path), std::runtime_error);
+
+    // 文件尾的索引偏移接近 2^64，与索引字节数相加回绕后恰好等于文件尾位置
+    const CDMTimeSeriesFile::Header header = { { 'D', 'M', 'T', 'S' }, CDMTimeSeriesFile::VERSION, 1024, 0 };
+    const CDMTimeSeriesFile::Footer footer = { ~0ULL - 15, 1, 1, CDMTimeSeriesFile::BYTE_ORDER_MARK, "DMTSEND" };
+    fp = std::fopen(path.c_str(), "wb");
+    ASSERT_TRUE(fp != nullptr);
+    std::fwrite(&header, sizeof(header), 1, fp);
+    std::fwrite(&footer, sizeof(footer), 1, fp);
+    std::fclose(fp);
+    EXPECT_THROW(CDMTimeSeriesReader reader(path), std::runtime_error);
+    std::remove(path.c_str());
+    EXPECT_THROW(CDMTimeSeriesReader reader(path), std::runtime_error);
+}
+
+TEST_F(CDMDateTimePracticalTest, LogScanner) {
+    time_t ts = 0;
+    const std::string bracketed = "[2024-03-10 08:00:05] INFO start\n";
+    ASSERT_TRUE(CDMLogScanner::ParseLineTimestamp(bracketed.data(), bracketed.data() + bracketed.size(), ts));
+    EXPECT_EQ(CDMDateTime(2024, 3, 10, 8, 0, 5).GetTimestamp(), ts);
+    const std::string millis = "2024-03-10 08:00:05,123 WARN slow\n";
+    ASSERT_TRUE(CDMLogScanner::ParseLineTimestamp(millis.data(), millis.data() + millis.size(), ts));
+    EXPECT_EQ(CDMDateTime(2024, 3, 10, 8, 0, 5).GetTimestamp(), ts);
+    const std::string zulu = "2024-03-10T08:00:05.250Z GET /\n";
+    ASSERT_TRUE(CDMLogScanner::ParseLineTimestamp(zulu.data(), zulu.data() + zulu.size(), ts));
+    EXPECT_EQ(static_cast<time_t>(CDMCivil::SecondsFromCivil(2024, 3, 10, 8, 0, 5)), ts);
+    const std::string trace = "    at Foo.bar(Foo.java:42)\n";
+    EXPECT_FALSE(CDMLogScanner::ParseLineTimestamp(trace.data(), trace.data() + trace.size(), ts));
+    EXPECT_FALSE(CDMLogScanner::ParseLineTimestamp(trace.data(), trace.data() + 10, ts));
+
+    // 有序日志（带续行）与乱序日志，分别与逐行暴力筛选比对
+    std::string sorted_log = "startup banner without timestamp\n";
+    std::string unsorted_log;
+    std::vector<std::pair<time_t, std::string>> sorted_lines = { { 0, sorted_log } };
+    std::vector<std::pair<time_t, std::string>> unsorted_lines;
+    unsigned state = 12345;
+    time_t t = CDMDateTime(2024, 3, 9).GetTimestamp();
+    for (int i = 0; i < 3000; ++i) {
+        state = state * 1103515245u + 12345u;
+        t += (state >> 16) % 90;
+        const std::string line = CDMDateTime::FromTimestamp(t).ToString() + " INFO request " + std::to_string(i) + "\n";
+        sorted_lines.emplace_back(t, line);
+        if (i % 17 == 0) {
+            sorted_lines.emplace_back(t, "    at Foo.bar(Foo.java:42)\n");
+        }
+        const time_t shuffled = t - static_cast<time_t>((state >> 8) % 20000);
+        unsorted_lines.emplace_back(shuffled, "[" + CDMDateTime::FromTimestamp(shuffled).ToString() + "] line " + std::to_string(i) + "\n");
+        if (i % 23 == 0) {
+            unsorted_lines.emplace_back(shuffled, "continued\n");
+        }
+    }
+    sorted_log.clear();
+    for (const auto& line : sorted_lines) {
+        sorted_log += line.second;
+    }
+    for (const auto& line : unsorted_lines) {
+        unsorted_log += line.second;
+    }
+    sorted_lines.front().first = -1; // 开头无时间戳的行不属于任何时间
+
+    auto brute_force = [](const std::vector<std::pair<time_t, std::string>>& lines, const CDMDateTime& start, const CDMDateTime& end) {
+        std::string out;
+        for (const auto& line : lines) {
+            if (line.first >= start.GetTimestamp() && line.first < end.GetTimestamp()) {
+                out += line.second;
+            }
+        }
+        return out;
+    };
+
+    const CDMLogScanner sorted_scanner(sorted_log.data(), sorted_log.size());
+    const CDMLogScanner unsorted_scanner(unsorted_log.data(), unsorted_log.size());
+    EXPECT_TRUE(sorted_scanner.LooksSorted());
+    EXPECT_FALSE(unsorted_scanner.LooksSorted());
+
+    const CDMDateTime starts[] = { CDMDateTime(2024, 3, 1), CDMDateTime(2024, 3, 9, 6, 0, 0),
+        CDMDateTime::FromTimestamp(sorted_lines[777].first), CDMDateTime(2024, 3, 10, 12, 0, 0) };
+    const long long spans[] = { 0, 1, 600, 86400, 86400 * 30 };
+    for (const CDMDateTime& start : starts) {
+        for (long long span : spans) {
+            const CDMDateTime end = start.AddSeconds(span);
+            const std::string expected_sorted = brute_force(sorted_lines, start, end);
+            size_t begin_offset = 0;
+            size_t end_offset = 0;
+            sorted_scanner.FindSorted(start, end, begin_offset, end_offset);
+            EXPECT_EQ(expected_sorted, sorted_log.substr(begin_offset, end_offset - begin_offset)) << start.ToString() << " +" << span;
+
+            for (int threads : { 1, 3 }) {
+                std::string actual;
+                size_t calls = 0;
+                const char* last_end = nullptr;
+                auto collect = [&](const char* data, size_t length) {
+                    EXPECT_TRUE(last_end == nullptr || data > last_end); // 按文件顺序，相邻范围已合并
+                    last_end = data + length;
+                    actual.append(data, length);
+                    ++calls;
+                };
+                const std::string expected_unsorted = brute_force(unsorted_lines, start, end);
+                EXPECT_EQ(expected_unsorted.size(), unsorted_scanner.ScanParallel(start, end, threads, collect, 997));
+                EXPECT_EQ(expected_unsorted, actual) << start.ToString() << " +" << span;
+
+                actual.clear();
+                calls = 0;
+                last_end = nullptr;
+                EXPECT_EQ(expected_sorted.size(), sorted_scanner.ScanParallel(start, end, threads, collect, 1499));
+                EXPECT_EQ(expected_sorted, actual);
+                EXPECT_LE(calls, expected_sorted.empty() ? 0u : 1u) << "相邻范围应合并为一段";
+            }
+
+            std::string automatic;
+            sorted_scanner.Scan(start, end, 2, [&](const char* data, size_t length) { automatic.append(data, length); });
+            EXPECT_EQ(expected_sorted, automatic);
+        }
+    }
+
+    const std::string path = "dmdatetimetest_scan.log";
+    FILE* fp = std::fopen(path.c_str(), "wb");
+    ASSERT_TRUE(fp != nullptr);
+    std::fwrite(sorted_log.data(), 1, sorted_log.size(), fp);
+    std::fclose(fp);
+    {
+        const CDMLogScanner file_scanner(path);
+        EXPECT_EQ(sorted_log.size(), file_scanner.Size());
+        std::string from_file;
+        file_scanner.Scan(starts[2], starts[2].AddSeconds(86400), 0, [&](const char* data, size_t length) { from_file.append(data, length); });
+        EXPECT_EQ(brute_force(sorted_lines, starts[2], starts[2].AddSeconds(86400)), from_file);
+    }
+    std::remove(path.c_str());
+    EXPECT_THROW(CDMLogScanner scanner(path), std::runtime_error);
+}
+
+static constexpr char TEST_ISO_FORMAT[] = "%Y-%m-%dT%H:%M:%S.%f%z";
+static constexpr char TEST_HTTP_LIKE_FORMAT[] = "%a, %d %b %Y %H:%M:%S (%j) 100%%";
+static constexpr char TEST_ORDINAL_FORMAT[] = "%Y.%j %H%M";
+
+TEST_F(CDMDateTimePracticalTest, FixedFormat) {
+    static_assert(CDMFormatPattern::Compile("%Y-%m-%d").error == CDMFormatPattern::PATTERN_OK, "");
+    static_assert(CDMFormatPattern::Compile("%Y-%q").error == CDMFormatPattern::PATTERN_UNKNOWN_SPECIFIER, "");
+    static_assert(CDMFormatPattern::Compile("%Y-%q").error_offset == 3, "");
+    static_assert(CDMFormatPattern::Compile("%H:%M%").error == CDMFormatPattern::PATTERN_TRAILING_PERCENT, "");
+    static_assert(CDMFixedFormat<CDMFormatPattern::STANDARD>::LENGTH == 19, "");
+    static_assert(CDMFixedFormat<TEST_ISO_FORMAT>::LENGTH == 31, "");
+
+    typedef CDMFixedFormat<CDMFormatPattern::STANDARD> Standard;
+    typedef CDMFixedFormat<TEST_ISO_FORMAT> Iso;
+    typedef CDMFixedFormat<TEST_HTTP_LIKE_FORMAT> HttpLike;
+
+    const CDMDateTime fixed(2024, 3, 10, 8, 5, 9);
+    EXPECT_EQ("2024-03-10 08:05:09", Standard::ToString(fixed));
+    EXPECT_EQ("Sun, 10 Mar 2024 08:05:09 (070) 100%", HttpLike::ToString(fixed));
+    EXPECT_EQ("2024-03-10", CDMFixedFormat<CDMFormatPattern::SHORT_DATE>::ToString(fixed));
+    EXPECT_EQ(fixed, HttpLike::Parse("Sun, 10 Mar 2024 08:05:09 (070) 100%"));
+
+    // 与运行时格式化、内置解析器逐个比对；带 %z 的格式往返精确（夏令时重叠的一小时也不会歧义）
+    for (time_t t = CDMDateTime(1999, 12, 31).GetTimestamp(); t < CDMDateTime(2031, 1, 1).GetTimestamp(); t += 86400 * 3 + 3607) {
+        const CDMDateTime dt = CDMDateTime::FromTimestamp(t);
+        const std::string text = Standard::ToString(dt);
+        ASSERT_EQ(dt.ToString(), text);
+        EXPECT_EQ(CDMDateTime::Parse(text), Standard::Parse(text));
+        EXPECT_EQ(dt, Iso::Parse(Iso::ToString(dt)));
+        EXPECT_EQ(dt, HttpLike::Parse(HttpLike::ToString(dt)));
+        char buffer[Iso::LENGTH + 1];
+        ASSERT_EQ(Iso::LENGTH, Iso::ToString(dt, buffer, sizeof(buffer)));
+        EXPECT_EQ('\0', buffer[Iso::LENGTH]);
+        EXPECT_EQ(0u, Iso::ToString(dt, buffer, Iso::LENGTH));
+        EXPECT_EQ('\0', buffer[0]);
+    }
+
+    // %f：格式化为微秒，解析读取 1-9 位并按分辨率截断；%z 接受 Z、+hh、+hh:mm
+    const CDMDateTimeUs precise = CDMDateTimeUs::FromTimestamp(fixed.GetTimestamp(), 123456);
+    EXPECT_EQ("2024-03-10 08:05:09.123456", CDMFixedFormat<TEST_ISO_FORMAT>::ToString(precise).substr(0, 26).replace(10, 1, " "));
+    CDMDateTimeUs micros;
+    ASSERT_TRUE(Iso::TryParse(Iso::ToString(precise), micros));
+    EXPECT_EQ(precise, micros);
+    CDMDateTimeNs nanos;
+    ASSERT_TRUE(Iso::TryParse(std::string_view("2024-03-10T00:05:09.123456789Z"), nanos));
+    EXPECT_EQ(CDMDateTimeNs::FromTimestamp(static_cast<time_t>(CDMCivil::SecondsFromCivil(2024, 3, 10, 0, 5, 9)), 123456789), nanos);
+    CDMDateTimeMs millis;
+    ASSERT_TRUE(Iso::TryParse(std::string_view("2024-03-10T08:05:09.9876+08"), millis));
+    EXPECT_EQ(987, millis.GetMillisecond());
+    CDMDateTime dt = CDMDateTime::FromTimestamp(0);
+    ASSERT_TRUE(Iso::TryParse(std::string_view("2024-03-10T05:35:09.5+05:30"), dt));
+    EXPECT_EQ(static_cast<time_t>(CDMCivil::SecondsFromCivil(2024, 3, 10, 0, 5, 9)), dt.GetTimestamp());
+
+    // %j 推出月日，与 %m/%d 同时出现时必须一致
+    typedef CDMFixedFormat<TEST_ORDINAL_FORMAT> Ordinal;
+    EXPECT_EQ(CDMDateTime(2024, 12, 31, 23, 59, 0), Ordinal::Parse("2024.366 2359"));
+    EXPECT_EQ("2024.366 2359", Ordinal::ToString(CDMDateTime(2024, 12, 31, 23, 59, 0)));
+
+    const char* const invalid[] = {
+        "2024-03-10T08:05:09.123+0800x",  // 多余字符
+        "2024-03-10 08:05:09.123+0800",   // 分隔符不符
+        "2024-02-30T08:05:09.1Z",         // 不存在的日期
+        "2024-13-10T08:05:09.1Z",
+        "2024-03-10T24:05:09.1Z",
+        "2024-3-10T08:05:09.1Z",          // 数字字段必须写满位数
+        "2024-03-10T08:05:09.Z",
+        "2024-03-10T08:05:09.1+8",
+    };
+    for (const char* text : invalid) {
+        EXPECT_FALSE(Iso::TryParse(std::string_view(text), dt)) << text;
+    }
+    EXPECT_FALSE(HttpLike::TryParse(std::string_view("Mon, 10 Mar 2024 08:05:09 (070) 100%"), dt)); // 星期不符
+    EXPECT_FALSE(HttpLike::TryParse(std::string_view("Sun, 10 Mar 2024 08:05:09 (071) 100%"), dt)); // 年内天数不符
+    EXPECT_FALSE(Ordinal::TryParse(std::string_view("2023.366 0000"), dt));
+    EXPECT_THROW(Standard::Parse("2024-03-10"), std::runtime_error);
+}
+
+TEST_F(CDMDateTimePracticalTest, DateTimeFormat) {
+    // 运行时预编译的格式与编译期特化的结果逐一一致
+    const CDMDateTimeFormat iso(TEST_ISO_FORMAT);
+    const CDMDateTimeFormat http_like(TEST_HTTP_LIKE_FORMAT);
+    const CDMDateTimeFormat ordinal = CDMDateTimeFormat::Compile(TEST_ORDINAL_FORMAT);
+    EXPECT_EQ(CDMFixedFormat<TEST_ISO_FORMAT>::LENGTH, iso.GetLength());
+    EXPECT_EQ(std::string(TEST_HTTP_LIKE_FORMAT), http_like.GetPattern());
+    EXPECT_EQ(4u, ordinal.GetOps().size()); // "%Y." "%j " "%H" "%M"
+
+    std::string appended = "at ";
+    for (time_t t = CDMDateTime(1999, 12, 31).GetTimestamp(); t < CDMDateTime(2031, 1, 1).GetTimestamp(); t += 86400 * 5 + 3607) {
+        const CDMDateTime dt = CDMDateTime::FromTimestamp(t);
+        const CDMDateTimeMs precise = CDMDateTimeMs::FromTimestamp(t, t % 1000);
+        ASSERT_EQ(CDMFixedFormat<TEST_ISO_FORMAT>::ToString(precise), iso.ToString(precise));
+        ASSERT_EQ(CDMFixedFormat<TEST_HTTP_LIKE_FORMAT>::ToString(dt), http_like.ToString(dt));
+        ASSERT_EQ(CDMFixedFormat<TEST_ORDINAL_FORMAT>::ToString(dt), ordinal.ToString(dt));
+        CDMDateTimeMs parsed;
+        ASSERT_TRUE(iso.TryParse(iso.ToString(precise), parsed));
+        EXPECT_EQ(precise, parsed);
+        EXPECT_EQ(dt, http_like.Parse(http_like.ToString(dt)));
+        EXPECT_EQ(CDMFixedFormat<TEST_ORDINAL_FORMAT>::Parse(ordinal.ToString(dt)), ordinal.Parse(ordinal.ToString(dt)));
+    }
+    EXPECT_EQ(iso.GetLength(), iso.AppendString(appended, CDMDateTime(2024, 3, 10)));
+    EXPECT_EQ("at " + iso.ToString(CDMDateTime(2024, 3, 10)), appended);
+
+    char buffer[8];
+    EXPECT_EQ(0u, iso.ToString(CDMDateTime(2024, 3, 10), buffer, sizeof(buffer)));
+    EXPECT_EQ('\0', buffer[0]);
+    const CDMDateTimeFormat compact("%Y%m%d");
+    char date[9];
+    EXPECT_EQ(8u, compact.ToString(CDMDateTime(2024, 3, 10), date, sizeof(date)));
+    EXPECT_STREQ("20240310", date);
+
+    CDMDateTime dt = CDMDateTime::FromTimestamp(0);
+    EXPECT_FALSE(iso.TryParse(std::string_view("2024-02-30T08:05:09.1Z"), dt));
+    EXPECT_FALSE(http_like.TryParse(std::string_view("Mon, 10 Mar 2024 08:05:09 (070) 100%"), dt));
+    EXPECT_THROW(compact.Parse("2024031"), std::runtime_error);
+
+    // 非法模式
+    CDMDateTimeFormat untouched("%H:%M");
+    size_t error_offset = 0;
+    EXPECT_FALSE(CDMDateTimeFormat::TryCompile("%Y-%m-%d %q", untouched, &error_offset));
+    EXPECT_EQ(9u, error_offset);
+    EXPECT_EQ("%H:%M", untouched.GetPattern());
+    EXPECT_FALSE(CDMDateTimeFormat::TryCompile("100%", untouched));
+    EXPECT_FALSE(CDMDateTimeFormat::TryCompile(std::string_view("%Y\0%m", 5), untouched));
+    EXPECT_THROW(CDMDateTimeFormat("%d/%m/%y"), std::runtime_error);
+
+    const CDMDateTimeFormat empty;
+    EXPECT_EQ("", empty.ToString(CDMDateTime(2024, 3, 10)));
+    EXPECT_EQ(CDMDateTime(1970, 1, 1), empty.Parse(""));
+}
@@ -0,0 +1,118 @@
+#include "dmlogscanner.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <string>
+
+// 按时间范围筛选日志行，匹配的行原样写到 stdout，统计信息打印到 stderr。
+//
+//   dmlogscan [--threads N] [--sorted | --unsorted] [--ranges] <file> <start> <end>
+//
+// start/end 为本地时间（CDMDateTime::TryParse 支持的格式），筛选 [start, end)。
+// 默认抽样判断文件是否按时间有序：有序时二分定位，否则多线程扫描；--sorted/--unsorted 强制指定。
+// --ranges 只输出匹配范围的 "偏移 长度"，不输出内容。
+
+namespace {
+
+enum ScanMode {
+    SCAN_AUTO,
+    SCAN_SORTED,
+    SCAN_UNSORTED
+};
+
+struct ScanOptions {
+    int threads = 0;
+    ScanMode mode = SCAN_AUTO;
+    bool ranges = false;
+    std::string path;
+    std::string start;
+    std::string end;
+};
+
+bool ParseOptions(int argc, char** argv, ScanOptions& options) {
+    int positional = 0;
+    for (int i = 1; i < argc; ++i) {
+        const bool has_value = i + 1 < argc;
+        if (std::strcmp(argv[i], "--threads") == 0 && has_value) {
+            options.threads = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--sorted") == 0) {
+            options.mode = SCAN_SORTED;
+        }
+        else if (std::strcmp(argv[i], "--unsorted") == 0) {
+            options.mode = SCAN_UNSORTED;
+        }
+        else if (std::strcmp(argv[i], "--ranges") == 0) {
+            options.ranges = true;
+        }
+        else if (argv[i][0] != '-' && positional < 3) {
+            std::string* targets[3] = { &options.path, &options.start, &options.end };
+            *targets[positional++] = argv[i];
+        }
+        else {
+            positional = -1;
+            break;
+        }
+    }
+    if (positional != 3) {
+        std::fprintf(stderr, "usage: %s [--threads N] [--sorted | --unsorted] [--ranges] <file> <start> <end>\n", argv[0]);
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    ScanOptions options;
+    if (!ParseOptions(argc, argv, options)) {
+        return 1;
+    }
+    CDMDateTime start = CDMDateTime::FromTimestamp(0);
+    CDMDateTime end = CDMDateTime::FromTimestamp(0);
+    if (!CDMDateTime::TryParse(options.start, start) || !CDMDateTime::TryParse(options.end, end)) {
+        std::fprintf(stderr, "invalid time range: %s %s\n", options.start.c_str(), options.end.c_str());
+        return 1;
+    }
+
+    try {
+        const CDMLogScanner scanner(options.path);
+        const auto begin_time = std::chrono::steady_clock::now();
+        unsigned long long range_count = 0;
+        auto sink = [&](const char* data, size_t length) {
+            ++range_count;
+            if (options.ranges) {
+                std::printf("%llu %llu\n", static_cast<unsigned long long>(data - scanner.Data()), static_cast<unsigned long long>(length));
+            }
+            else {
+                std::fwrite(data, 1, length, stdout);
+            }
+        };
+        bool sorted = options.mode == SCAN_SORTED || (options.mode == SCAN_AUTO && scanner.LooksSorted());
+        uint64_t matched = 0;
+        if (sorted) {
+            size_t begin_offset = 0;
+            size_t end_offset = 0;
+            scanner.FindSorted(start, end, begin_offset, end_offset);
+            if (end_offset > begin_offset) {
+                sink(scanner.Data() + begin_offset, end_offset - begin_offset);
+            }
+            matched = end_offset - begin_offset;
+        }
+        else {
+            matched = scanner.ScanParallel(start, end, options.threads, sink);
+        }
+        std::fflush(stdout);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin_time).count();
+        std::fprintf(stderr, "%s: %llu bytes matched in %llu ranges (%s, %.3f ms, %llu bytes in file)\n",
+            options.path.c_str(), static_cast<unsigned long long>(matched), range_count,
+            sorted ? "sorted" : "parallel", seconds * 1000.0, static_cast<unsigned long long>(scanner.Size()));
+    }
+    catch (const std::exception& e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+    return 0;
+}